@@ -425,6 +425,8 @@ bool ActorEditor::ReloadActorData()
         reader.ReadPropName();
         g_PresetMan.GetEntityPreset(reader);
     }
+    // The new definitions may use different effect bitmaps, so drop the rotated ones made of the old ones
+    g_PostProcessMan.ClearRotatedEffectCache();
 
     // Now reload the actor from the new definition
     const Entity *pEntity = g_PresetMan.GetEntityPreset(m_pEditedActor->GetClassName(), m_pEditedActor->GetPresetName(), m_pEditedActor->GetModuleID());
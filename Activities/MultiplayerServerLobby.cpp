@@ -919,6 +919,7 @@ namespace RTE {
 	bool MultiplayerServerLobby::StartGame()
 	{
 		g_NetworkServer.SetInterlacingMode(g_SettingsMan.GetServerUseInterlacing());
+		g_NetworkServer.SetDeltaCompressionMode(g_SettingsMan.GetServerUseDeltaCompression());
 
 		// Get the currently selected Activity
 		const Activity *pActivityPreset = m_pActivitySelect->GetSelectedItem() ? dynamic_cast<const Activity *>(m_pActivitySelect->GetSelectedItem()->m_pEntity) : 0;
@@ -1220,11 +1220,12 @@ void ACrab::UpdateAI()
         // Calculate the path to the target brain if need for refresh (note updating each pathfindingupdated causes small chug, maybe space em out with a timer?)
         // Also if we're way off form the path, or haven't made progress toward the current waypoint in a while, update the path to see if we can improve
         // Also if we seem to have completed the path to the current waypoint, we should update to get the path to the next waypoint
-        if (m_UpdateMovePath || (m_ProgressTimer.IsPastSimMS(10000) && m_DeviceState != DIGGING) || (m_MovePath.empty() && m_MoveVector.GetLargest() < m_CharHeight * 0.25f))// || (m_MoveVector.GetLargest() > m_CharHeight * 2))// || g_SceneMan.GetScene()->PathFindingUpdated())
+        // The path is queued up and calculated together with those of all other Actors, so keep at it until the new path has been taken into use
+        if (IsWaitingOnMovePath() || m_UpdateMovePath || (m_ProgressTimer.IsPastSimMS(10000) && m_DeviceState != DIGGING) || (m_MovePath.empty() && m_MoveVector.GetLargest() < m_CharHeight * 0.25f))// || (m_MoveVector.GetLargest() > m_CharHeight * 2))// || g_SceneMan.GetScene()->PathFindingUpdated())
         {
             // Also never update while jumping
             if (m_DeviceState != JUMPING)
-                UpdateMovePath();
+                QueueMovePathUpdate();
         }
 
         // If we used to be pointing at something (probably alarmed), just scan ahead instead
@@ -859,6 +859,23 @@ void ADoor::DrawHUD(BITMAP *pTargetBitmap, const Vector &targetPos, int whichScr
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDoorMaterialFootprint
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the area and material of the door material representation this
+//                  has currently drawn into the terrain, if any.
+
+bool ADoor::GetDoorMaterialFootprint(Box &footprintArea, unsigned char &materialID) const
+{
+    if (!m_pDoor || !m_DoorMaterialDrawn || m_MaterialDrawOverride)
+        return false;
+
+    footprintArea = m_pDoor->GetBoundingBox();
+    materialID = m_DoorMaterialID;
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  DrawDoorMaterial
 //////////////////////////////////////////////////////////////////////////////////////////
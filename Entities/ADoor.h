@@ -477,6 +477,18 @@ EntityAllocation(ADoor)
     virtual void MaterialDrawOverride(bool enable);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDoorMaterialFootprint
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the area and material of the door material representation this
+//                  has currently drawn into the terrain, if any.
+// Arguments:       A Box to be filled with the area the door material is drawn within.
+//                  A reference to be filled with the material ID the door is drawn with.
+// Return value:    Whether there's any door material drawn into the terrain right now.
+
+    bool GetDoorMaterialFootprint(Box &footprintArea, unsigned char &materialID) const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Update
 //////////////////////////////////////////////////////////////////////////////////////////
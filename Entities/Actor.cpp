@@ -15,6 +15,7 @@
 #include "ActivityMan.h"
 #include "GameActivity.h"
 #include "Actor.h"
+#include "PathFinder.h"
 #include "ACrab.h"
 #include "ACraft.h"
 #include "AtomGroup.h"
@@ -125,6 +126,7 @@ void Actor::Clear()
     m_MoveVector.Reset();
     m_MovePath.clear();
     m_UpdateMovePath = true;
+    m_pMovePathRequest.reset();
     m_MoveProximityLimit = 100;
     m_LateralMoveState = LAT_STILL;
     m_MoveOvershootTimer.Reset();
@@ -1211,48 +1213,23 @@ MOID Actor::GetAIMOWaypointID()
 
 bool Actor::UpdateMovePath()
 {
-    // TODO: Do throttling of calls for this function over time??
-
-
-    // Remove the material representation of all doors of this guy's team so he can navigate through them (they'll open for him)
-    g_MovableMan.OverrideMaterialDoors(true, m_Team);
-    // Update the pathfinding with any changes to doors' material representations
-    g_SceneMan.GetScene()->UpdatePathFinding();
+    if (!g_SceneMan.GetScene())
+        return false;
 
-    // If we're following someone/thing, then never advance waypoints until that thing disappears
-    if (g_MovableMan.ValidMO(m_pMOMoveTarget))
-        g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_pMOMoveTarget->GetPos(), m_MovePath, m_DigStrength);
+    // If a queued path has been calculated, take it into use. Otherwise calculate a new one right away and drop any queued one, since it's outdated now
+    if (m_pMovePathRequest && m_pMovePathRequest->Complete)
+        m_MovePath.swap(m_pMovePathRequest->PathResult);
     else
     {
-        // Do we currently have a path to a static target we would like to still pursue?
-        if (m_MovePath.empty())
-        {
-            // Ok no path going, so get a new path to the next waypoint, if there is a next waypoint
-            if (!m_Waypoints.empty())
-            {
-                // Make sure the path starts from the ground and not somewhere up in the air if/when dropped out of ship
-                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_Waypoints.front().first, m_MovePath, m_DigStrength);
-                // If the waypoint was tied to an MO to pursue, then load it into the current MO target
-                if (g_MovableMan.ValidMO(m_Waypoints.front().second))
-                    m_pMOMoveTarget = m_Waypoints.front().second;
-                else
-                    m_pMOMoveTarget = 0;
-                // We loaded the waypoint, no need to keep it
-                m_Waypoints.pop_front();
-            }
-            // Just try to get to the last Move Target
-            else
-                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_MoveTarget, m_MovePath, m_DigStrength);
-        }
-        // We had a path before trying to update, so use its last point as the final destination
-        else
-            g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), Vector(m_MovePath.back()), m_MovePath, m_DigStrength);
+        // Make sure the path starts from the ground and not somewhere up in the air if/when dropped out of ship
+        Vector pathStart = g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10);
+        // Queueing the path already advanced to its waypoint, so head to the same place it was going instead of advancing past another one. MOs are still followed to where they are now
+        Vector pathEnd = (m_pMovePathRequest && !g_MovableMan.ValidMO(m_pMOMoveTarget)) ? m_pMovePathRequest->TargetPos : GetMovePathEnd();
+        // Update the pathfinding with any changes to the terrain, then find the path. Our own team's doors are seen through since they'll open for us
+        g_SceneMan.GetScene()->UpdatePathFinding();
+        g_SceneMan.GetScene()->CalculatePath(pathStart, pathEnd, m_MovePath, m_DigStrength, m_Team);
     }
-
-    // Place back the material representation of all doors of this guy's team so they are as we found them
-    g_MovableMan.OverrideMaterialDoors(false, m_Team);
-    // Update the pathfinding with any changes to doors' material representations
-    g_SceneMan.GetScene()->UpdatePathFinding();
+    m_pMovePathRequest.reset();
 
     // Process the new path we now have, if any
     if (!m_MovePath.empty())
@@ -1287,6 +1264,61 @@ bool Actor::UpdateMovePath()
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          QueueMovePathUpdate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Queues up an update of this' move path, to be calculated together with
+//                  the path requests of all other Actors at the end of the sim update.
+
+bool Actor::QueueMovePathUpdate()
+{
+    if (!g_SceneMan.GetScene())
+        return false;
+
+    if (m_pMovePathRequest)
+        return m_pMovePathRequest->Complete ? UpdateMovePath() : false;
+
+    // Make sure the path starts from the ground and not somewhere up in the air if/when dropped out of ship
+    Vector pathStart = g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10);
+    m_pMovePathRequest = g_SceneMan.GetScene()->RequestPath(pathStart, GetMovePathEnd(), m_DigStrength, m_Team);
+    return false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMovePathEnd
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Figures out where a new move path should lead to, and advances to the
+//                  next waypoint if the path is to be made to it.
+
+Vector Actor::GetMovePathEnd()
+{
+    // If we're following someone/thing, then never advance waypoints until that thing disappears
+    if (g_MovableMan.ValidMO(m_pMOMoveTarget))
+        return m_pMOMoveTarget->GetPos();
+
+    // We had a path before trying to update, so use its last point as the final destination
+    if (!m_MovePath.empty())
+        return m_MovePath.back();
+
+    // Ok no path going, so get a new path to the next waypoint, if there is a next waypoint
+    if (!m_Waypoints.empty())
+    {
+        Vector pathEnd = m_Waypoints.front().first;
+        // If the waypoint was tied to an MO to pursue, then load it into the current MO target
+        if (g_MovableMan.ValidMO(m_Waypoints.front().second))
+            m_pMOMoveTarget = m_Waypoints.front().second;
+        else
+            m_pMOMoveTarget = 0;
+        // We loaded the waypoint, no need to keep it
+        m_Waypoints.pop_front();
+        return pathEnd;
+    }
+
+    // Just try to get to the last Move Target
+    return m_MoveTarget;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool Actor::UpdateAIScripted() {
@@ -1294,7 +1326,7 @@ bool Actor::UpdateAIScripted() {
         return false;
     }
 
-    int status = !g_LuaMan.ExpressionIsTrue(m_ScriptPresetName, false) ? ReloadScripts() : 0;
+    int status = ReloadScriptsIfPresetWasCleared();
     status = (status >= 0 && !ObjectScriptsInitialized()) ? InitializeObjectScripts() : status;
     g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
     status = (status >= 0) ? RunScriptedFunctionInAppropriateScripts("UpdateAI", false, true) : status;
@@ -23,6 +23,7 @@ namespace RTE
 class AtomGroup;
 class HeldDevice;
 class PieMenuGUI;
+struct PathRequest;
 
 #define AILINEDOTSPACING 16
 
@@ -785,7 +786,7 @@ AddScriptFunctionNames(MOSRotating, "UpdateAI")
 // Arguments:       None.
 // Return value:    None.
 
-    virtual void ClearAIWaypoints() { m_pMOMoveTarget = 0; m_Waypoints.clear(); m_MovePath.clear(); m_MoveTarget = m_Pos; m_MoveVector.Reset(); }
+    virtual void ClearAIWaypoints() { m_pMOMoveTarget = 0; m_Waypoints.clear(); m_MovePath.clear(); m_pMovePathRequest.reset(); m_MoveTarget = m_Pos; m_MoveVector.Reset(); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1167,6 +1168,31 @@ AddScriptFunctionNames(MOSRotating, "UpdateAI")
     virtual bool UpdateMovePath();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          QueueMovePathUpdate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Queues up an update of this' move path, to be calculated together with
+//                  the path requests of all other Actors at the end of the sim update.
+//                  Keep calling this until it returns true; once the queued path has been
+//                  calculated it is taken into use through UpdateMovePath.
+// Arguments:       None.
+// Return value:    Whether the queued path was taken into use, or if this should be tried
+//                  again next frame.
+
+    bool QueueMovePathUpdate();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsWaitingOnMovePath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this has queued up a move path update that hasn't been
+//                  taken into use yet.
+// Arguments:       None.
+// Return value:    Whether there's a queued move path update pending.
+
+    bool IsWaitingOnMovePath() const { return m_pMovePathRequest != 0; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  UpdateAIScripted
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1533,6 +1559,8 @@ protected:
     std::list<Vector> m_MovePath;
     // Whether it's time to update the path
     bool m_UpdateMovePath;
+    // The queued up request for a new move path, if any. Shared with the pathfinding queue
+    std::shared_ptr<PathRequest> m_pMovePathRequest;
     // The minimum range to consider having reached a move target is considered
     float m_MoveProximityLimit;
     // Whether the AI is trying to progress to the right, left, or stand still
@@ -1570,6 +1598,17 @@ private:
 
     void Clear();
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMovePathEnd
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Figures out where a new move path should lead to, and advances to the
+//                  next waypoint if the path is to be made to it.
+// Arguments:       None.
+// Return value:    The position in the scene the new move path should end at.
+
+    Vector GetMovePathEnd();
+
     // Disallow the use of some implicit methods.
     Actor(const Actor &reference);
     Actor & operator=(const Actor &rhs);
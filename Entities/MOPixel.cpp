@@ -343,7 +343,8 @@ void MOPixel::Travel()
         return;
 
     // Set the atom to ignore a certain MO, if set and applicable.
-    if (m_HitsMOs && m_pMOToNotHit && g_MovableMan.ValidMO(m_pMOToNotHit) && !m_MOIgnoreTimer.IsPastSimTimeLimit())
+    // The cheap timer check goes before ValidMO, which searches all MOs and caches the result in MovableMan.
+    if (m_HitsMOs && m_pMOToNotHit && !m_MOIgnoreTimer.IsPastSimTimeLimit() && g_MovableMan.ValidMO(m_pMOToNotHit))
     {
         MOID root = m_pMOToNotHit->GetID();
         int footprint = m_pMOToNotHit->GetMOIDFootprint();
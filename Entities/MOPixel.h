@@ -374,6 +374,18 @@ EntityAllocation(MOPixel)
     virtual void Travel();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanTravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MovableObject is simple enough that its
+//                  ApplyForces, PreTravel, TravelSpeculatively and PostTravel can be run
+//                  on a worker thread during a multithreaded particle travel pass.
+// Arguments:       None.
+// Return value:    Whether this can be traveled on a worker thread.
+
+    virtual bool CanTravelSpeculatively() const { return !m_PinStrength && !m_GetsHitByMOs && !HasAnyScripts() && !(m_HitsMOs && m_pMOToNotHit && !m_MOIgnoreTimer.IsPastSimTimeLimit()); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -295,7 +295,8 @@ void MOSParticle::Travel()
     // Atom update and handling
 
     // Set the atom to ignore a certain MO, if set and applicable.
-    if (m_HitsMOs && m_pMOToNotHit && g_MovableMan.ValidMO(m_pMOToNotHit) && !m_MOIgnoreTimer.IsPastSimTimeLimit())
+    // The cheap timer check goes before ValidMO, which searches all MOs and caches the result in MovableMan.
+    if (m_HitsMOs && m_pMOToNotHit && !m_MOIgnoreTimer.IsPastSimTimeLimit() && g_MovableMan.ValidMO(m_pMOToNotHit))
     {
         MOID root = m_pMOToNotHit->GetID();
         int footprint = m_pMOToNotHit->GetMOIDFootprint();
@@ -337,7 +338,8 @@ void MOSParticle::Travel()
     // Change angular velocity after collision.
     if (hitCount >= 1) {
 // TODO: Tweak this!")
-        m_AngularVel *= 0.5 * velMag * NormalRand();
+        SpeculativeTravelContext *speculativeContext = Atom::GetSpeculativeTravelContext();
+        m_AngularVel *= 0.5 * velMag * (speculativeContext ? speculativeContext->NormalRand() : NormalRand());
         m_AngularVel = -m_AngularVel;
     }
 
@@ -365,6 +367,29 @@ void MOSParticle::Travel()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  TravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Travels this MOSParticle while only reading the Scene. If the travel
+//                  needs to write to shared state it is aborted and all state it changed
+//                  is rolled back, so Travel() can be called again serially.
+
+bool MOSParticle::TravelSpeculatively(SpeculativeTravelContext &context)
+{
+    float prevAngularVel = m_AngularVel;
+    Matrix prevRotation = m_Rotation;
+    unsigned int prevFrame = m_Frame;
+
+    if (MOSprite::TravelSpeculatively(context))
+        return true;
+
+    m_AngularVel = prevAngularVel;
+    m_Rotation = prevRotation;
+    m_Frame = prevFrame;
+    return false;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Update
 //////////////////////////////////////////////////////////////////////////////////////////
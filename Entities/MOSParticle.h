@@ -336,6 +336,30 @@ EntityAllocation(MOSParticle)
     virtual void Travel();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanTravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MovableObject is simple enough that its
+//                  ApplyForces, PreTravel, TravelSpeculatively and PostTravel can be run
+//                  on a worker thread during a multithreaded particle travel pass.
+// Arguments:       None.
+// Return value:    Whether this can be traveled on a worker thread.
+
+    virtual bool CanTravelSpeculatively() const { return !m_PinStrength && !m_GetsHitByMOs && !HasAnyScripts() && !(m_HitsMOs && m_pMOToNotHit && !m_MOIgnoreTimer.IsPastSimTimeLimit()); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  TravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Travels this MOSParticle while only reading the Scene. If the travel
+//                  needs to write to shared state it is aborted and all state it changed
+//                  is rolled back, so Travel() can be called again serially.
+// Arguments:       The SpeculativeTravelContext of the task this is traveled in.
+// Return value:    Whether the travel was completed. If false, nothing was changed.
+
+    virtual bool TravelSpeculatively(SpeculativeTravelContext &context);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -206,9 +206,9 @@ void MOSRotating::Clear()
     m_LoudnessOnGib = 1;
 	m_DamageMultiplier = 1;
 	m_DamageMultiplierRedefined = false;
-    m_StringValueMap.clear();
-    m_NumberValueMap.clear();
-    m_ObjectValueMap.clear();
+    m_StringValues.Clear();
+    m_NumberValues.Clear();
+    m_ObjectValues.Clear();
 }
 
 
@@ -393,9 +393,9 @@ int MOSRotating::Create(const MOSRotating &reference)
         m_Gibs.push_back(*gItr);
     }
 
-    m_StringValueMap = reference.m_StringValueMap;
-    m_NumberValueMap = reference.m_NumberValueMap;
-    m_ObjectValueMap = reference.m_ObjectValueMap;
+    m_StringValues = reference.m_StringValues;
+    m_NumberValues = reference.m_NumberValues;
+    m_ObjectValues = reference.m_ObjectValues;
 
     m_GibImpulseLimit = reference.m_GibImpulseLimit;
     m_GibWoundLimit = reference.m_GibWoundLimit;
@@ -2225,10 +2225,7 @@ bool MOSRotating::ApplyAttachableForces(Attachable *pAttachable, bool isCritical
 
 std::string MOSRotating::GetStringValue(std::string key)
 {
-	if (StringValueExists(key))
-		return m_StringValueMap[key];
-	else
-		return "";
+	return GetStringValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2240,10 +2237,7 @@ std::string MOSRotating::GetStringValue(std::string key)
 
 double MOSRotating::GetNumberValue(std::string key)
 {
-	if (NumberValueExists(key))
-		return m_NumberValueMap[key];
-	else
-		return 0;
+	return GetNumberValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2255,10 +2249,7 @@ double MOSRotating::GetNumberValue(std::string key)
 
 Entity * MOSRotating::GetObjectValue(std::string key)
 {
-	if (ObjectValueExists(key))
-		return m_ObjectValueMap[key];
-	else
-		return 0;
+	return GetObjectValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2268,7 +2259,7 @@ Entity * MOSRotating::GetObjectValue(std::string key)
 
 void MOSRotating::SetStringValue(std::string key, std::string value)
 {
-	m_StringValueMap[key] = value;
+	SetStringValueByKeyID(CustomValueKeys::GetKeyID(key), value);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2278,7 +2269,7 @@ void MOSRotating::SetStringValue(std::string key, std::string value)
 
 void MOSRotating::SetNumberValue(std::string key, double value)
 {
-	m_NumberValueMap[key] = value;
+	SetNumberValueByKeyID(CustomValueKeys::GetKeyID(key), value);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2288,7 +2279,7 @@ void MOSRotating::SetNumberValue(std::string key, double value)
 
 void MOSRotating::SetObjectValue(std::string key, Entity * value)
 {
-	m_ObjectValueMap[key] = value;
+	SetObjectValueByKeyID(CustomValueKeys::GetKeyID(key), value);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2298,7 +2289,7 @@ void MOSRotating::SetObjectValue(std::string key, Entity * value)
 
 void MOSRotating::RemoveStringValue(std::string key)
 {
-	m_StringValueMap.erase(key);
+	RemoveStringValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2308,7 +2299,7 @@ void MOSRotating::RemoveStringValue(std::string key)
 
 void MOSRotating::RemoveNumberValue(std::string key)
 {
-	m_NumberValueMap.erase(key);
+	RemoveNumberValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2318,7 +2309,7 @@ void MOSRotating::RemoveNumberValue(std::string key)
 
 void MOSRotating::RemoveObjectValue(std::string key)
 {
-	m_ObjectValueMap.erase(key);
+	RemoveObjectValueByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2328,9 +2319,7 @@ void MOSRotating::RemoveObjectValue(std::string key)
 
 bool MOSRotating::StringValueExists(std::string key)
 {
-	if (m_StringValueMap.find(key) != m_StringValueMap.end())
-		return true;
-	return false;
+	return StringValueExistsByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2340,9 +2329,7 @@ bool MOSRotating::StringValueExists(std::string key)
 
 bool MOSRotating::NumberValueExists(std::string key)
 {
-	if (m_NumberValueMap.find(key) != m_NumberValueMap.end())
-		return true;
-	return false;
+	return NumberValueExistsByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2352,9 +2339,7 @@ bool MOSRotating::NumberValueExists(std::string key)
 
 bool MOSRotating::ObjectValueExists(std::string key)
 {
-	if (m_ObjectValueMap.find(key) != m_ObjectValueMap.end())
-		return true;
-	return false;
+	return ObjectValueExistsByKeyID(CustomValueKeys::FindKeyID(key));
 }
 
 } // namespace RTE
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include "MOSprite.h"
 #include "PostProcessMan.h"
+#include "CustomValueTable.h"
 
 namespace RTE
 {
@@ -1027,6 +1028,117 @@ EntityAllocation(MOSRotating)
 
 	virtual bool ObjectValueExists(std::string key);
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStringValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns the string value associated with the specified key ID or "" if it does not exist.
+//                  Faster than GetStringValue since the key name doesn't have to be looked up.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID to retrieve value.
+// Return value:    String value.
+
+	std::string GetStringValueByKeyID(unsigned int keyID) const { const std::string *value = m_StringValues.Find(keyID); return value ? *value : ""; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetNumberValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns the number value associated with the specified key ID or 0 if it does not exist.
+//                  Faster than GetNumberValue since the key name doesn't have to be looked up.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID to retrieve value.
+// Return value:    Number (double) value.
+
+	double GetNumberValueByKeyID(unsigned int keyID) const { const double *value = m_NumberValues.Find(keyID); return value ? *value : 0; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetObjectValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns the object value associated with the specified key ID or 0 if it does not exist.
+//                  Faster than GetObjectValue since the key name doesn't have to be looked up.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID to retrieve value.
+// Return value:    Object (Entity *) value.
+
+	Entity * GetObjectValueByKeyID(unsigned int keyID) const { Entity * const *value = m_ObjectValues.Find(keyID); return value ? *value : 0; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetStringValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the string value associated with the specified key ID.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID and value to set.
+// Return value:    None.
+
+	void SetStringValueByKeyID(unsigned int keyID, const std::string &value) { m_StringValues.Set(keyID, value); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetNumberValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the number value associated with the specified key ID.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID and value to set.
+// Return value:    None.
+
+	void SetNumberValueByKeyID(unsigned int keyID, double value) { m_NumberValues.Set(keyID, value); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetObjectValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the object value associated with the specified key ID.
+// Arguments:       Key ID from CustomValueKeys::GetKeyID and value to set.
+// Return value:    None.
+
+	void SetObjectValueByKeyID(unsigned int keyID, Entity *value) { m_ObjectValues.Set(keyID, value); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RemoveStringValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Remove the string value associated with the specified key ID.
+// Arguments:       Key ID to remove.
+// Return value:    None.
+
+	void RemoveStringValueByKeyID(unsigned int keyID) { m_StringValues.Remove(keyID); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RemoveNumberValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Remove the number value associated with the specified key ID.
+// Arguments:       Key ID to remove.
+// Return value:    None.
+
+	void RemoveNumberValueByKeyID(unsigned int keyID) { m_NumberValues.Remove(keyID); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RemoveObjectValueByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Remove the object value associated with the specified key ID.
+// Arguments:       Key ID to remove.
+// Return value:    None.
+
+	void RemoveObjectValueByKeyID(unsigned int keyID) { m_ObjectValues.Remove(keyID); }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StringValueExistsByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Checks whether the string value associated with the specified key ID exists.
+// Arguments:       Key ID to check.
+// Return value:    True if value exists.
+
+	bool StringValueExistsByKeyID(unsigned int keyID) const { return m_StringValues.Find(keyID) != 0; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NumberValueExistsByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Checks whether the number value associated with the specified key ID exists.
+// Arguments:       Key ID to check.
+// Return value:    True if value exists.
+
+	bool NumberValueExistsByKeyID(unsigned int keyID) const { return m_NumberValues.Find(keyID) != 0; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ObjectValueExistsByKeyID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Checks whether the object value associated with the specified key ID exists.
+// Arguments:       Key ID to check.
+// Return value:    True if value exists.
+
+	bool ObjectValueExistsByKeyID(unsigned int keyID) const { return m_ObjectValues.Find(keyID) != 0; }
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  GetMOIDs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1169,12 +1281,12 @@ protected:
     bool m_EffectOnGib;
     // How far this is audiable (in screens) when gibbing
     float m_LoudnessOnGib;
-	// Map to store any generic strings
-	std::map<std::string, std::string> m_StringValueMap;
-	// Map to store any generic numbers
-	std::map<std::string, double> m_NumberValueMap;
-	// Map to store any object pointers
-	std::map<std::string, Entity *> m_ObjectValueMap;
+	// Table to store any generic strings, keyed by CustomValueKeys key IDs
+	CustomValueTable<std::string> m_StringValues;
+	// Table to store any generic numbers, keyed by CustomValueKeys key IDs
+	CustomValueTable<double> m_NumberValues;
+	// Table to store any object pointers, keyed by CustomValueKeys key IDs
+	CustomValueTable<Entity *> m_ObjectValues;
 
 	// Damage mutliplier for this attachable
 	float m_DamageMultiplier;
@@ -604,4 +604,20 @@ void MOSprite::Draw(BITMAP *pTargetBitmap,
     }
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  HashMOIDDrawState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes a hash of the state of this MO alone that decides how it looks
+//                  when drawn onto the MOID layer, not counting its MOID.
+
+size_t MOSprite::HashMOIDDrawState() const
+{
+    size_t drawState = MovableObject::HashMOIDDrawState();
+    drawState = drawState * 31 + std::hash<unsigned int>()(m_Frame);
+    drawState = drawState * 31 + std::hash<float>()(m_Rotation.GetRadAngle());
+    drawState = drawState * 31 + std::hash<bool>()(m_HFlipped);
+    return drawState;
+}
+
 } // namespace RTE
\ No newline at end of file
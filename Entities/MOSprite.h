@@ -629,6 +629,17 @@ EntityAllocation(MOSprite)
 
 protected:
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  HashMOIDDrawState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes a hash of the state of this MO alone that decides how it looks
+//                  when drawn onto the MOID layer, not counting its MOID.
+// Arguments:       None.
+// Return value:    The hash of this MO's own MOID draw state.
+
+    virtual size_t HashMOIDDrawState() const;
+
+
     // Member variables
     static Entity::ClassInfo m_sClass;
 
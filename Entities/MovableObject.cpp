@@ -68,6 +68,7 @@ void MovableObject::Clear()
     m_RootMOID = g_NoMOID;
     m_HasEverBeenAddedToMovableMan = false;
     m_MOIDFootprint = 0;
+    m_MOIDDrawState = 0;
     m_AlreadyHitBy.clear();
     m_VelOscillations = 0;
     m_ToSettle = false;
@@ -77,6 +78,7 @@ void MovableObject::Clear()
     m_FunctionsAndScripts.clear();
     m_ScriptPresetName.clear();
     m_ScriptObjectName.clear();
+    m_ScriptPresetGeneration = 0;
     m_ScreenEffectFile.Reset();
     m_pScreenEffect = 0;
 	m_EffectRotAngle = 0;
@@ -899,6 +901,43 @@ void MovableObject::Travel()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  TravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Travels this MovableObject while only reading the Scene. If the travel
+//                  needs to write to shared state it is aborted and all state it changed
+//                  is rolled back, so Travel() can be called again serially.
+
+bool MovableObject::TravelSpeculatively(SpeculativeTravelContext &context)
+{
+    Vector prevPos = m_Pos;
+    Vector prevVel = m_Vel;
+    bool prevDidWrap = m_DidWrap;
+    MOID prevMOIDHit = m_MOIDHit;
+    unsigned char prevTerrainMatHit = m_TerrainMatHit;
+    long int prevParticleUniqueIDHit = m_ParticleUniqueIDHit;
+    unsigned int prevLastCollisionSimFrameNumber = m_LastCollisionSimFrameNumber;
+
+    context.BeginTravel(m_UniqueID, g_MovableMan.GetSimUpdateFrameNumber());
+    Atom::SetSpeculativeTravelContext(&context);
+    Travel();
+    Atom::SetSpeculativeTravelContext(nullptr);
+
+    if (context.Aborted)
+    {
+        m_Pos = prevPos;
+        m_Vel = prevVel;
+        m_DidWrap = prevDidWrap;
+        m_MOIDHit = prevMOIDHit;
+        m_TerrainMatHit = prevTerrainMatHit;
+        m_ParticleUniqueIDHit = prevParticleUniqueIDHit;
+        m_LastCollisionSimFrameNumber = prevLastCollisionSimFrameNumber;
+        return false;
+    }
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  PostTravel
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -962,7 +1001,7 @@ int MovableObject::UpdateScripts() {
         return -1;
     }
 
-    int status = !g_LuaMan.ExpressionIsTrue(m_ScriptPresetName, false) ? ReloadScripts() : 0;
+    int status = ReloadScriptsIfPresetWasCleared();
     status = (status >= 0 && !ObjectScriptsInitialized()) ? InitializeObjectScripts() : status;
     status = (status >= 0) ? RunScriptedFunctionInAppropriateScripts("Update", false, true) : status;
 
@@ -971,6 +1010,18 @@ int MovableObject::UpdateScripts() {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+int MovableObject::ReloadScriptsIfPresetWasCleared() {
+    if (m_ScriptPresetGeneration == g_LuaMan.GetScriptPresetGeneration()) {
+        return 0;
+    }
+    int status = !g_LuaMan.ExpressionIsTrue(m_ScriptPresetName, false) ? ReloadScripts() : 0;
+    if (status >= 0) { m_ScriptPresetGeneration = g_LuaMan.GetScriptPresetGeneration(); }
+
+    return status;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int MovableObject::OnPieMenu(Actor *pieMenuActor) {
     if (!pieMenuActor || m_AllLoadedScripts.empty() || m_ScriptPresetName.empty() || !ObjectScriptsInitialized()) {
         return -1;
@@ -1040,14 +1091,38 @@ void MovableObject::RegMOID(vector<MovableObject *> &MOIDIndex,
 
 		m_MOID = MOIDIndex.size();
 		MOIDIndex.push_back(this);
+        m_MOIDDrawState = HashMOIDDrawState();
     }
     // Use the parent's MOID instead (the two are considered the same MO)
     else
+    {
         m_MOID = MOIDIndex.size() - 1;
+        // Since this is drawn with the parent's MOID, fold how this looks into the parent's draw state
+        MovableObject *pMOIDOwner = MOIDIndex.back();
+        if (pMOIDOwner)
+        {
+            pMOIDOwner->m_MOIDDrawState = pMOIDOwner->m_MOIDDrawState * 31 + (HashMOIDDrawState() ^ std::hash<const MovableObject *>()(this));
+        }
+    }
 
     // Assign the root MOID
     m_RootMOID = (rootMOID == g_NoMOID ? m_MOID : rootMOID);
 
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  HashMOIDDrawState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes a hash of the state of this MO alone that decides how it looks
+//                  when drawn onto the MOID layer, not counting its MOID.
+
+size_t MovableObject::HashMOIDDrawState() const
+{
+    size_t drawState = std::hash<int>()(m_Pos.GetFloorIntX());
+    drawState = drawState * 31 + std::hash<int>()(m_Pos.GetFloorIntY());
+    drawState = drawState * 31 + std::hash<float>()(m_Scale);
+    return drawState;
+}
+
 } // namespace RTE
\ No newline at end of file
@@ -40,6 +40,7 @@ namespace RTE
 #pragma endregion
 
 struct HitData;
+struct SpeculativeTravelContext;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -515,6 +516,18 @@ EntityAllocation(MovableObject)
 
     int GetMOIDFootprint() const { return m_MOIDFootprint; }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMOIDDrawState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a hash of everything that decides how this MO, and any children
+//                  sharing its MOID, look when drawn onto the MOID layer. Two equal
+//                  states mean the same pixels get drawn. Only valid for this frame!
+// Arguments:       None.
+// Return value:    The MOID draw state hash as of the last UpdateMOID.
+
+    size_t GetMOIDDrawState() const { return m_MOIDDrawState; }
+
     /// <summary>
     /// Returns whether or not this object has ever been added to MovableMan. Does not account for removal from MovableMan.
     /// </summary>
@@ -1546,6 +1559,30 @@ EntityAllocation(MovableObject)
     virtual void Travel();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanTravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MovableObject is simple enough that its
+//                  ApplyForces, PreTravel, TravelSpeculatively and PostTravel can be run
+//                  on a worker thread during a multithreaded particle travel pass.
+// Arguments:       None.
+// Return value:    Whether this can be traveled on a worker thread.
+
+    virtual bool CanTravelSpeculatively() const { return false; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  TravelSpeculatively
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Travels this MovableObject while only reading the Scene. If the travel
+//                  needs to write to shared state it is aborted and all state it changed
+//                  is rolled back, so Travel() can be called again serially.
+// Arguments:       The SpeculativeTravelContext of the task this is traveled in.
+// Return value:    Whether the travel was completed. If false, nothing was changed.
+
+    virtual bool TravelSpeculatively(SpeculativeTravelContext &context);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  PostTravel
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1818,6 +1855,12 @@ protected:
     /// <returns>0 on success, -2 if it fails to setup the script object in Lua, and -3 if it fails to run any Create function.</returns>
     int InitializeObjectScripts();
 
+    /// <summary>
+    /// Checks whether this' preset table still exists in Lua and reloads the scripts if it doesn't. The check is only done when scripts have been reloaded since the last one, so the Lua state isn't touched every frame.
+    /// </summary>
+    /// <returns>An error return value signaling sucess or any particular failure. Anything below 0 is an error signal.</returns>
+    int ReloadScriptsIfPresetWasCleared();
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  UpdateChildMOIDs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1851,6 +1894,17 @@ protected:
                          MOID rootMOID = g_NoMOID,
                          bool makeNewMOID = true);
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  HashMOIDDrawState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes a hash of the state of this MO alone that decides how it looks
+//                  when drawn onto the MOID layer, not counting its MOID.
+// Arguments:       None.
+// Return value:    The hash of this MO's own MOID draw state.
+
+    virtual size_t HashMOIDDrawState() const;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Constructor:     MovableObject
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1932,6 +1986,9 @@ protected:
     // How many total (subsequent) MOID's this MO and all its children are taking up this frame.
     // ie if this MO has no children, this will likely be 1.
     int m_MOIDFootprint;
+    // Hash of how this and the children sharing its MOID look on the MOID layer, see GetMOIDDrawState.
+    // Only valid the same frame it was assigned!
+    size_t m_MOIDDrawState;
     // Whether or not this object has been added to MovableMan. Does not take into account the object being removed from MovableMan, though in practice it usually will.
     bool m_HasEverBeenAddedToMovableMan;
     // A set of ID:s of MO:s that already have collided with this MO during this frame.
@@ -1955,6 +2012,8 @@ protected:
     std::string m_ScriptPresetName;
     // The ID name unique to this' object instance representation in the Lua state.
     std::string m_ScriptObjectName;
+    // The LuaMan script preset generation this' preset table was last checked against. 0 means it was never checked.
+    unsigned long m_ScriptPresetGeneration;
 
     // Special post processing flash effect file and Bitmap. Shuold be loaded from a 32bpp bitmap
     ContentFile m_ScreenEffectFile;
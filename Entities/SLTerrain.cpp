@@ -20,6 +20,7 @@
 #include "MOPixel.h"
 #include "MOSprite.h"
 #include "Atom.h"
+#include "ThreadMan.h"
 
 namespace RTE {
 
@@ -150,6 +151,7 @@ void SLTerrain::Clear()
     m_TerrainDebris.clear();
     m_TerrainObjects.clear();
     m_UpdatedMateralAreas.clear();
+    m_MaterialOccupancy.Reset();
     m_DrawMaterial = false;
 	m_NeedToClearFrostings = false;
 	m_NeedToClearDebris = false;
@@ -319,15 +321,11 @@ int SLTerrain::LoadData()
 
     int xPos, yPos, matIndex, pixelColor;
 
-    // Temporary references for all the materials' textures and colors, since we'll access them a lot
-    BITMAP *apTexBitmaps[256];
-    int aColors[256];
-    // Null em out so we can tell which ones we've already got once so far
-    for (matIndex = 0; matIndex < 256; ++matIndex)
-    {
-        apTexBitmaps[matIndex] = 0;
-        aColors[matIndex] = 0;
-    }
+    // Temporary references for all the materials' textures and colors, since we'll access them a lot.
+    // These are indexed by the material index as read from the material bitmap, with the DataModule's material mappings already applied
+    unsigned char aMappedIndices[c_PaletteEntriesNumber];
+    BITMAP *apTexBitmaps[c_PaletteEntriesNumber];
+    int aColors[c_PaletteEntriesNumber];
 
     // Get the background texture
     BITMAP *m_pBGTexture = m_BGTextureFile.GetAsBitmap();
@@ -337,72 +335,59 @@ int SLTerrain::LoadData()
     const unsigned char *materialMappings = g_PresetMan.GetDataModule(m_BitmapFile.GetDataModuleID())->GetAllMaterialMappings();
     Material *pMaterial = 0;
 
+    // Resolve the mapping, texture and color of every possible material index up front, so the texturization below is nothing but table lookups and can be done by several threads at once
+    for (matIndex = 0; matIndex < c_PaletteEntriesNumber; ++matIndex)
+    {
+        // Map any materials defined in this data module but initially collided with other material ID's and thus were displaced to other ID's
+        aMappedIndices[matIndex] = materialMappings[matIndex] != 0 ? materialMappings[matIndex] : matIndex;
+
+        // Validate the material, or default to default material
+        pMaterial = apMaterials[aMappedIndices[matIndex]] ? apMaterials[aMappedIndices[matIndex]] : apMaterials[g_MaterialDefault];
+
+        // Get, and acquire the texture bitmap if material has any. If it doesn't, then use the material's solid color instead
+        if (apTexBitmaps[matIndex] = pMaterial->GetTexture())
+            acquire_bitmap(apTexBitmaps[matIndex]);
+        aColors[matIndex] = pMaterial->color.GetIndex();
+    }
+
     // Lock all involved bitmaps
     acquire_bitmap(m_pMainBitmap);
     acquire_bitmap(pFGBitmap);
     acquire_bitmap(pBGBitmap);
     acquire_bitmap(m_pBGTexture);
 
-    // Go through each pixel on the main bitmap, which contains all the material pixels loaded from the bitmap
-    // Place texture pixels on the FG layer corresponding to the materials on the main material bitmap
-    for (xPos = 0; xPos < m_pMainBitmap->w; ++xPos)
-    {
-        for (yPos = 0; yPos < m_pMainBitmap->h; ++yPos)
+    // Go through each pixel on the main bitmap, which contains all the material pixels loaded from the bitmap, and place texture pixels on the FG layer corresponding to the materials on it.
+    // This is done row by row, so all the bitmaps are read and written along their memory layout, and the rows are split into strips that are texturized in parallel since no pixel depends on any other
+    const int stripHeight = 64;
+    const int bitmapWidth = m_pMainBitmap->w;
+    const int bitmapHeight = m_pMainBitmap->h;
+    g_ThreadMan.ParallelFor((bitmapHeight + stripHeight - 1) / stripHeight, [&](size_t stripIndex) {
+        int stripEnd = std::min(static_cast<int>(stripIndex + 1) * stripHeight, bitmapHeight);
+        for (int rowPos = static_cast<int>(stripIndex) * stripHeight; rowPos < stripEnd; ++rowPos)
         {
-            // Read which material the current pixel represents
-            matIndex = _getpixel(m_pMainBitmap, xPos, yPos);
-            // Map any materials defined in this data module but initially collided with other material ID's and thus were displaced to other ID's
-            if (materialMappings[matIndex] != 0)
-            {
-                // Assign the mapping and put it onto the material bitmap too
-                matIndex = materialMappings[matIndex];
-                _putpixel(m_pMainBitmap, xPos, yPos, matIndex);
-            }
-
-            // Validate the material, or default to default material
-            if (matIndex >= 0 && matIndex < c_PaletteEntriesNumber && apMaterials[matIndex])
-                pMaterial = apMaterials[matIndex];
-            else
-                pMaterial = apMaterials[g_MaterialDefault];
+            unsigned char *pMaterialRow = m_pMainBitmap->line[rowPos];
+            unsigned char *pFGRow = pFGBitmap->line[rowPos];
+            unsigned char *pBGRow = pBGBitmap->line[rowPos];
+            const unsigned char *pBGTextureRow = m_pBGTexture ? m_pBGTexture->line[rowPos % m_pBGTexture->h] : 0;
 
-            // If haven't read a pixel of this material before, then get its texture so we can quickly access it
-            if (!apTexBitmaps[matIndex])
+            for (int columnPos = 0; columnPos < bitmapWidth; ++columnPos)
             {
-                // Get, and acquire the texture bitmap if material has any
-                if (apTexBitmaps[matIndex] = pMaterial->GetTexture())
-                    acquire_bitmap(apTexBitmaps[matIndex]);
-            }
+                // Read which material the current pixel represents, and put any mapping of it onto the material bitmap too
+                int rowMatIndex = pMaterialRow[columnPos];
+                pMaterialRow[columnPos] = aMappedIndices[rowMatIndex];
 
-            // If actually no texture for the material, then use the material's solid color instead
-            if (!apTexBitmaps[matIndex])
-            {
-                // If the color hasn't been retrieved yet, then do so
-                if (!aColors[matIndex])
-                    aColors[matIndex] = pMaterial->color.GetIndex();
-                // Use the color
-                pixelColor = aColors[matIndex];
-            }
-            // Use the texture's color
-            else
-            {
-//                acquire_bitmap(apTexBitmaps[matIndex]);
-                pixelColor = _getpixel(apTexBitmaps[matIndex], xPos % apTexBitmaps[matIndex]->w, yPos % apTexBitmaps[matIndex]->h);
-            }
+                // Use the texture's color, or the material's solid color if it doesn't have any texture
+                BITMAP *pTexture = apTexBitmaps[rowMatIndex];
+                int rowPixelColor = pTexture ? pTexture->line[rowPos % pTexture->h][columnPos % pTexture->w] : aColors[rowMatIndex];
 
-            // Draw the correct color pixel on the foreground
-            _putpixel(pFGBitmap, xPos, yPos, pixelColor);
+                // Draw the correct color pixel on the foreground
+                pFGRow[columnPos] = rowPixelColor;
 
-            // Draw background texture on the background where this is stuff on the foreground
-            if (m_pBGTexture && pixelColor != g_MaskColor)
-            {
-                pixelColor = _getpixel(m_pBGTexture, xPos % m_pBGTexture->w, yPos % m_pBGTexture->h);
-                _putpixel(pBGBitmap, xPos, yPos, pixelColor);
+                // Draw background texture on the background where this is stuff on the foreground, and put a keycolor pixel in the bg otherwise
+                pBGRow[columnPos] = (pBGTextureRow && rowPixelColor != g_MaskColor) ? pBGTextureRow[columnPos % m_pBGTexture->w] : g_MaskColor;
             }
-            // Put a keycolor pixel in the bg otherwise
-            else
-                _putpixel(pBGBitmap, xPos, yPos, g_MaskColor);
         }
-    }
+    });
 
     ///////////////////////////////////////
     // Material frostings application!
@@ -907,6 +892,7 @@ void SLTerrain::SetMaterialPixel(const int pixelX, const int pixelY, const unsig
        return;
 //    RTEAssert(m_pMainBitmap->m_LockCount > 0, "Trying to access unlocked terrain bitmap");
     _putpixel(m_pMainBitmap, posX, posY, material);
+    m_MaterialOccupancy.UpdatePixel(posX, posY, material);
 }
 
 
@@ -1048,7 +1034,7 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
 
     // Add a box to the updated areas list to show there's been change to the materials layer
 // TODO: improve fit/tightness of box here
-    m_UpdatedMateralAreas.push_back(Box(pos - pivot, maxWidth, maxHeight));
+    AddUpdatedMaterialArea(Box(pos - pivot, maxWidth, maxHeight));
 
     return MOPDeque;
 }
@@ -1163,8 +1149,6 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
         SceneLayer::Draw(pTempBitmap, notUsed, bitmapScroll);
         // Finally draw temporary bitmap to the Scene
         masked_blit(pTempBitmap, GetMaterialBitmap(), 0, 0, bitmapScroll.m_X, bitmapScroll.m_Y, pTempBitmap->w, pTempBitmap->h);
-        // Add a box to the updated areas list to show there's been change to the materials layer
-        m_UpdatedMateralAreas.push_back(Box(bitmapScroll, pTempBitmap->w, pTempBitmap->h));
 // TODO: centralize seam drawing!
         // Draw over seams
         if (g_SceneMan.SceneWrapsX())
@@ -1181,6 +1165,8 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
             else if (bitmapScroll.m_Y + pTempBitmap->h > g_SceneMan.GetSceneHeight())
                 masked_blit(pTempBitmap, GetMaterialBitmap(), 0, 0, bitmapScroll.m_X, bitmapScroll.m_Y - g_SceneMan.GetSceneHeight(), pTempBitmap->w, pTempBitmap->h);
         }
+        // Add a box to the updated areas list to show there's been change to the materials layer. Only done now that the seams are drawn over, since this also updates the material occupancy grid, wrapping the box over the seams.
+        AddUpdatedMaterialArea(Box(bitmapScroll, pTempBitmap->w, pTempBitmap->h));
     }
     // Not a big sprite, so just draw the representations
     else
@@ -1190,6 +1176,8 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
 		g_SceneMan.RegisterTerrainChange(pMObject->GetPos().m_X, pMObject->GetPos().m_Y, 1, 1, g_DrawColor, false);
 
         pMObject->Draw(GetMaterialBitmap(), Vector(), g_DrawMaterial, true);
+        // Only the few pixels around the MO were drawn to, so the occupancy grid is updated without notifying of an updated area like before
+        UpdateMaterialOccupancy(Box(pMObject->GetPos().GetFloored() - Vector(1, 1), 3, 3));
     }
 }
 
@@ -1254,7 +1242,7 @@ void SLTerrain::ApplyTerrainObject(TerrainObject *pTObject)
 	g_SceneMan.RegisterTerrainChange(loc.m_X, loc.m_Y, pTObject->GetBitmapWidth(), pTObject->GetBitmapHeight(), g_MaskColor, false);
 
     // Add a box to the updated areas list to show there's been change to the materials layer
-    m_UpdatedMateralAreas.push_back(Box(loc, pTObject->GetMaterialBitmap()->w, pTObject->GetMaterialBitmap()->h));
+    AddUpdatedMaterialArea(Box(loc, pTObject->GetMaterialBitmap()->w, pTObject->GetMaterialBitmap()->h));
 
     // Apply all the child objects of the TO, and first reapply the team so all its children are guaranteed to be on the same team!
     pTObject->SetTeam(pTObject->GetTeam());
@@ -1269,6 +1257,40 @@ void SLTerrain::ApplyTerrainObject(TerrainObject *pTObject)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddUpdatedMaterialArea
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds a notification that an area of the material terrain has been
+//                  updated, and updates the material occupancy grid over it.
+
+void SLTerrain::AddUpdatedMaterialArea(const Box &newArea)
+{
+    m_UpdatedMateralAreas.push_back(newArea);
+    UpdateMaterialOccupancy(newArea);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateMaterialOccupancy
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the material occupancy grid over an area of the material layer
+//                  that has been drawn to, without notifying of it as an updated area.
+
+void SLTerrain::UpdateMaterialOccupancy(const Box &area)
+{
+    Box pixelArea = area;
+    pixelArea.Unflip();
+
+    // Include every pixel the box touches, even partly
+    int left = floorf(pixelArea.GetCorner().m_X);
+    int top = floorf(pixelArea.GetCorner().m_Y);
+    int right = floorf(pixelArea.GetCorner().m_X + pixelArea.GetWidth());
+    int bottom = floorf(pixelArea.GetCorner().m_Y + pixelArea.GetHeight());
+
+    m_MaterialOccupancy.UpdateArea(m_pMainBitmap, left, top, right - left + 1, bottom - top + 1);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsBoxBuried
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1346,6 +1368,9 @@ void SLTerrain::CleanAirBox(Box box, bool wrapsX, bool wrapsY)
 
     release_bitmap(m_pMainBitmap);
     release_bitmap(m_pFGColor->GetBitmap());
+
+    // Cavities in the box were turned into air
+    UpdateMaterialOccupancy(box);
 }
 
 
@@ -1378,6 +1403,9 @@ void SLTerrain::CleanAir()
 
     release_bitmap(m_pMainBitmap);
     release_bitmap(m_pFGColor->GetBitmap());
+
+    // This is the last thing done to the whole material layer when loading, so summarize it all anew
+    m_MaterialOccupancy.Create(m_pMainBitmap, m_WrapX, m_WrapY);
 }
 
 
@@ -1391,6 +1419,7 @@ void SLTerrain::ClearAllMaterial()
 {
     clear_to_color(m_pMainBitmap, g_MaskColor);
     clear_to_color(m_pFGColor->GetBitmap(), g_MaterialAir);
+    m_MaterialOccupancy.Create(m_pMainBitmap, m_WrapX, m_WrapY);
 }
 
 
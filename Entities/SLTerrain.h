@@ -18,6 +18,7 @@
 #include "Matrix.h"
 #include "Box.h"
 #include "Material.h"
+#include "MaterialOccupancyGrid.h"
 
 namespace RTE
 {
@@ -667,12 +668,12 @@ EntityAllocation(SLTerrain)
 // Method:          AddUpdatedMaterialArea
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Adds a notification that an area of the material terrain has been
-//                  updated.
+//                  updated, and updates the material occupancy grid over it.
 // Arguments:       The Box defining the newly updated material area that can be unwrapped
 //                  and may be out of bounds of the scene.
 // Return value:    None.
 
-    void AddUpdatedMaterialArea(const Box &newArea) { m_UpdatedMateralAreas.push_back(newArea); }
+    void AddUpdatedMaterialArea(const Box &newArea);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -687,6 +688,18 @@ EntityAllocation(SLTerrain)
     std::list<Box> & GetUpdatedMaterialAreas() { return m_UpdatedMateralAreas; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMaterialOccupancyGrid
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the grid telling which tiles of the material layer are all air,
+//                  all material or mixed, kept up to date as the material layer changes.
+// Arguments:       None.
+// Return value:    Reference to the material occupancy grid. It only covers the material
+//                  layer if its Covers() says so, which it doesn't before loading is done.
+
+    const MaterialOccupancyGrid & GetMaterialOccupancyGrid() const { return m_MaterialOccupancy; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsBoxBuried
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -798,6 +811,8 @@ protected:
     // List of areas of the material layer which have been affected by the updating of new objects copied to it
     // These boxes are NOT wrapped, and can be out of bounds!
     std::list<Box> m_UpdatedMateralAreas;
+    // Which tiles of the material layer are all air, all material or mixed, for skipping through open air
+    MaterialOccupancyGrid m_MaterialOccupancy;
 
     // Draw the material layer instead of the color layer.
     bool m_DrawMaterial;
@@ -818,6 +833,18 @@ protected:
 	bool m_NeedToClearDebris;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateMaterialOccupancy
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the material occupancy grid over an area of the material layer
+//                  that has been drawn to, without notifying of it as an updated area.
+// Arguments:       The Box defining the changed material area that can be unwrapped and
+//                  may be out of bounds of the scene.
+// Return value:    None.
+
+    void UpdateMaterialOccupancy(const Box &area);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
 
@@ -3002,12 +3002,12 @@ void Scene::UpdatePathFinding()
 // Description:     Calculates and returns the least difficult path between two points on
 //                  the current scene. Takes both distance and materials into account.
 
-float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght)
+float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght, int team)
 {
     float totalCostResult = -1;
     if (m_pPathFinder)
     {
-        int result = m_pPathFinder->CalculatePath(start, end, pathResult, totalCostResult, digStrenght);
+        int result = m_pPathFinder->CalculatePath(start, end, pathResult, totalCostResult, digStrenght, team);
 
         // It's ok if start and end nodes happen to be the same, the exact pixel locations are added at the front and end of the result regardless
         return (result == micropather::MicroPather::SOLVED || result == micropather::MicroPather::START_END_SAME) ? totalCostResult : -1;
@@ -3017,6 +3017,69 @@ float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vec
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RequestPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Queues up a path to be calculated between two points on the current
+//                  scene, together with all other requests made during this sim update.
+
+std::shared_ptr<PathRequest> Scene::RequestPath(const Vector &start, const Vector &end, float digStrength, int team)
+{
+    std::shared_ptr<PathRequest> pathRequest = std::make_shared<PathRequest>(start, end, digStrength, team);
+    if (m_pPathFinder)
+        m_pPathFinder->QueuePathRequest(pathRequest);
+    // No pathfinding on this scene, so the request can't ever be fulfilled. Give it the same straight path a failed search would
+    else
+    {
+        pathRequest->PathResult.push_back(start);
+        pathRequest->PathResult.push_back(end);
+        pathRequest->Complete = true;
+    }
+    return pathRequest;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ProcessPathRequests
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the outdated areas of the pathfinding data and hands all paths
+//                  requested through RequestPath since the last call to the worker threads.
+
+void Scene::ProcessPathRequests()
+{
+    if (!m_pPathFinder || !m_pPathFinder->HasQueuedPathRequests())
+        return;
+
+    UpdatePathFinding();
+    m_pPathFinder->ProcessPathRequests();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BenchmarkPathFinding
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Requests a number of paths between random points on the scene at once
+//                  and prints how long they took to be solved to the console.
+
+void Scene::BenchmarkPathFinding(int requestCount)
+{
+    if (!m_pPathFinder)
+    {
+        g_ConsoleMan.PrintString("ERROR: There is no pathfinding on this scene to benchmark!");
+        return;
+    }
+    UpdatePathFinding();
+
+    float medianLatency = 0;
+    float highLatency = 0;
+    m_pPathFinder->BenchmarkPathRequests(requestCount, medianLatency, highLatency);
+
+    char resultString[256];
+    sprintf_s(resultString, sizeof(resultString), "Solved %i path requests: p50 %.3f ms, p99 %.3f ms", std::max(requestCount, 0), medianLatency, highLatency);
+    g_ConsoleMan.PrintString(resultString);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CalculateScenePath
 //////////////////////////////////////////////////////////////////////////////////////////
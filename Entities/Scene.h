@@ -29,6 +29,7 @@ namespace RTE
 class ContentFile;
 class MovableObject;
 class PathFinder;
+struct PathRequest;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1288,10 +1289,52 @@ const SceneObject * PickPlacedActorInRange(int whichSet, Vector &scenePoint, int
 //                  the current scene. Takes both distance and materials into account.
 // Arguments:       Start and end positions on the scene to find the path between.
 //                  A list which will be filled out with waypoints between the start and end.
+//                  The maximum material strength the path can dig through.
+//                  The team the path is for, whose own doors are treated as passable.
 // Return value:    The total minimum difficulty cost calculated between the two points on
 //                  the scene.
 
-    float CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght = 1);
+    float CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght = 1, int team = Activity::NOTEAM);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RequestPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Queues up a path to be calculated between two points on the current
+//                  scene. All requests made during a sim update are calculated together
+//                  by ProcessPathRequests, so the pathfinding data only has to be brought
+//                  up to date once for all of them.
+// Arguments:       Start and end positions on the scene to find the path between.
+//                  The maximum material strength the path can dig through.
+//                  The team the path is for, whose own doors are treated as passable.
+// Return value:    The request, which will be marked complete with the path filled out once
+//                  it has been processed. Dropping it before then cancels the request.
+
+    std::shared_ptr<PathRequest> RequestPath(const Vector &start, const Vector &end, float digStrength, int team);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ProcessPathRequests
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the outdated areas of the pathfinding data and hands all paths
+//                  requested through RequestPath since the last call to the worker threads,
+//                  if there are any. Supposed to be done once every sim update.
+// Arguments:       None.
+// Return value:    None.
+
+    void ProcessPathRequests();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BenchmarkPathFinding
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Requests a number of paths between random points on the scene at once,
+//                  waits for all of them to be solved and prints the median and 99th
+//                  percentile time from request to result to the console.
+// Arguments:       How many paths to request.
+// Return value:    None.
+
+    void BenchmarkPathFinding(int requestCount);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -590,14 +590,6 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
 {
     RTEAssert(m_pMainBitmap, "Data of this SceneLayer has not been loaded before trying to draw!");
 
-    int sourceX = 0;
-    int sourceY = 0;
-    int sourceW = 0;
-    int sourceH = 0;
-    int destX = 0;
-    int destY = 0;
-    list<SLDrawBox> drawList;
-
     int offsetX;
     int offsetY;
     bool scrollOverridden = !(scrollOverride.m_X == -1 && scrollOverride.m_Y == -1);
@@ -618,6 +610,43 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
         WrapPosition(offsetX, offsetY);
     }
 
+    DrawAtOffset(pTargetBitmap, targetBox, offsetX, offsetY, scrollOverridden);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawWithOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws this SceneLayer scrolled to a specific offset instead of its
+//                  current one, wrapping and scroll ratios applied as usual.
+
+void SceneLayer::DrawWithOffset(BITMAP *pTargetBitmap, Box &targetBox, const Vector &offset) const
+{
+    RTEAssert(m_pMainBitmap, "Data of this SceneLayer has not been loaded before trying to draw!");
+
+    int offsetX = floorf(offset.m_X * m_ScrollRatio.m_X);
+    int offsetY = floorf(offset.m_Y * m_ScrollRatio.m_Y);
+    WrapPosition(offsetX, offsetY);
+
+    DrawAtOffset(pTargetBitmap, targetBox, offsetX, offsetY, false);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawAtOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws this SceneLayer to a bitmap with its source already scrolled to
+//                  the passed in coordinates.
+
+void SceneLayer::DrawAtOffset(BITMAP *pTargetBitmap, Box &targetBox, int offsetX, int offsetY, bool scrollOverridden) const
+{
+    int sourceX = 0;
+    int sourceY = 0;
+    int sourceW = 0;
+    int sourceH = 0;
+    int destX = 0;
+    int destY = 0;
+
     // Make target box valid size if it's empty
     if (targetBox.IsEmpty())
     {
@@ -544,6 +544,21 @@ EntityAllocation(SceneLayer)
     virtual void Draw(BITMAP *pTargetBitmap, Box &targetBox, const Vector &scrollOverride = Vector(-1, -1)) const;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawWithOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws this SceneLayer scrolled to a specific offset instead of its
+//                  current one, wrapping and scroll ratios applied as usual. Doesn't
+//                  touch the offset of this, so several screens can be drawn at once.
+// Arguments:       The bitmap to draw to.
+//                  The box on the target bitmap to limit drawing to, with the corner of
+//                  box being where the scroll position lines up.
+//                  The offset to draw this scrolled to, like what SetOffset takes.
+// Return value:    None.
+
+    void DrawWithOffset(BITMAP *pTargetBitmap, Box &targetBox, const Vector &offset) const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  DrawScaled
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -604,6 +619,21 @@ protected:
 	void UpdateScrollRatiosForNetworkPlayer(int player);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawAtOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws this SceneLayer to a bitmap with its source already scrolled to
+//                  the passed in coordinates. Shared by Draw and DrawWithOffset.
+// Arguments:       The bitmap to draw to.
+//                  The box on the target bitmap to limit drawing to.
+//                  The source coordinates to draw from.
+//                  Whether the coordinates are a scroll override, which skips the special
+//                  handling of screens larger than the scene.
+// Return value:    None.
+
+    void DrawAtOffset(BITMAP *pTargetBitmap, Box &targetBox, int offsetX, int offsetY, bool scrollOverridden) const;
+
+
     // Member variables
     static Entity::ClassInfo m_sClass;
 
@@ -38,6 +38,8 @@
 #include "SceneLayer.h"
 #include "MOSParticle.h"
 #include "MOSRotating.h"
+#include "Actor.h"
+#include "GameActivity.h"
 #include "Controller.h"
 
 #include "MultiplayerServerLobby.h"
@@ -120,6 +122,11 @@ volatile bool g_Quit = false;
 bool g_ResetRTE = false; //!< Signals to reset the entire RTE next iteration.
 bool g_LaunchIntoEditor = false; //!< Flag for launching directly into editor activity.
 const char *g_EditorToLaunch = ""; //!< String with editor activity name to launch.
+bool g_RunBenchmark = false; //!< Flag for running the benchmark instead of the game.
+bool g_BenchmarkDraw = false; //!< Whether the benchmark draws every frame or only runs the simulation.
+std::string g_BenchmarkScene = ""; //!< The name of the Scene to run the benchmark in.
+std::string g_BenchmarkActivity = ""; //!< The name of the Activity to run the benchmark in.
+unsigned int g_BenchmarkFrames = 0; //!< How many sim updates the benchmark runs for.
 bool g_InActivity = false;
 bool g_ResetActivity = false;
 bool g_ResumeActivity = false;
@@ -131,6 +138,13 @@ int g_DifficultySetting = 4;
 int g_StationOffsetX;
 int g_StationOffsetY;
 
+const unsigned int c_BenchmarkSeed = 1337; //!< The random number seed the benchmark always starts with, so every run spawns the same workload.
+const unsigned int c_BenchmarkActorInterval = 60; //!< How many sim updates pass between each actor the benchmark spawns.
+const unsigned int c_BenchmarkExplosionInterval = 90; //!< How many sim updates pass between each benchmark actor getting blown up.
+const unsigned int c_BenchmarkDigInterval = 30; //!< How many sim updates pass between each hole the benchmark digs into the terrain.
+const int c_BenchmarkDigRadius = 12; //!< The radius of each hole the benchmark digs, in pixels.
+const std::string c_BenchmarkFileName = "Benchmark.csv"; //!< The file the benchmark performance counters are written to.
+
 MainMenuGUI *g_pMainMenuGUI = 0;
 ScenarioGUI *g_pScenarioGUI = 0;
 Controller *g_pMainMenuController = 0;
@@ -1806,6 +1820,142 @@ bool RunGameLoop() {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Sets up and starts the Scene and Activity given with the -benchmark argument, with the random number generator seeded the same way every time.
+/// </summary>
+/// <returns>Whether the benchmark Activity was started.</returns>
+bool StartBenchmarkActivity() {
+	const Activity *activityPreset = nullptr;
+	std::list<Entity *> activityPresets;
+	g_PresetMan.GetAllOfType(activityPresets, "Activity");
+	for (const Entity *preset : activityPresets) {
+		if (preset->GetPresetName() == g_BenchmarkActivity) {
+			activityPreset = dynamic_cast<const Activity *>(preset);
+			break;
+		}
+	}
+	if (!activityPreset) {
+		g_ConsoleMan.PrintString("ERROR: Finding Activity preset \'" + g_BenchmarkActivity + "\' for the benchmark failed! Has it been properly defined?");
+		return false;
+	}
+	if (g_SceneMan.SetSceneToLoad(g_BenchmarkScene) < 0) {
+		return false;
+	}
+	Activity *activity = dynamic_cast<Activity *>(activityPreset->Clone());
+	activity->ClearPlayers(false);
+	activity->AddPlayer(Activity::PLAYER_1, true, Activity::TEAM_1, 0);
+	GameActivity *gameActivity = dynamic_cast<GameActivity *>(activity);
+	if (gameActivity) { gameActivity->SetCPUTeam(Activity::TEAM_2); }
+	g_ActivityMan.SetStartActivity(activity);
+
+	// Seeding before the Activity starts makes loading the Scene and setting up the Activity pick the same random numbers on every run as well.
+	SeedRand(c_BenchmarkSeed);
+	return ResetActivity();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Adds the scripted benchmark workload for a sim update. Every so often an actor is dropped in, the oldest benchmark actor is blown up and a hole is dug into the terrain.
+/// What gets spawned and where is only picked with the seeded random number generator, so every run gets the same workload.
+/// </summary>
+/// <param name="frameNumber">The number of the sim update the workload is for.</param>
+/// <param name="benchmarkActors">The actors spawned by the benchmark that haven't been blown up yet, oldest first.</param>
+void UpdateBenchmarkWorkload(unsigned int frameNumber, std::deque<Actor *> &benchmarkActors) {
+	int sceneWidth = g_SceneMan.GetSceneWidth();
+	int sceneHeight = g_SceneMan.GetSceneHeight();
+
+	if (frameNumber % c_BenchmarkActorInterval == 0) {
+		const Actor *actorPreset = dynamic_cast<const Actor *>(g_PresetMan.GetRandomOfGroup("Actors", "AHuman"));
+		if (actorPreset) {
+			Actor *actor = dynamic_cast<Actor *>(actorPreset->Clone());
+			actor->SetPos(Vector(static_cast<float>(SelectRand(0, sceneWidth - 1)), 0));
+			actor->SetTeam(Activity::TEAM_2);
+			actor->SetControllerMode(Controller::CIM_AI);
+			g_MovableMan.AddActor(actor);
+			benchmarkActors.push_back(actor);
+		}
+	}
+	if (frameNumber > 0 && frameNumber % c_BenchmarkExplosionInterval == 0) {
+		// Actors can get killed and deleted by other things in the meantime, so skip the ones MovableMan doesn't have anymore.
+		while (!benchmarkActors.empty() && !g_MovableMan.IsActor(benchmarkActors.front())) {
+			benchmarkActors.pop_front();
+		}
+		if (!benchmarkActors.empty()) {
+			benchmarkActors.front()->GibThis(Vector(), 50);
+			benchmarkActors.pop_front();
+		}
+	}
+	if (frameNumber % c_BenchmarkDigInterval == 0) {
+		int digCenterX = SelectRand(0, sceneWidth - 1);
+		int digCenterY = SelectRand(0, sceneHeight - 1);
+		const Vector digImpulse(0, 100000.0F);
+		const Vector digVelocity(0, 100.0F);
+		float retardation = 0;
+
+		g_SceneMan.LockScene();
+		for (int offsetY = -c_BenchmarkDigRadius; offsetY <= c_BenchmarkDigRadius; ++offsetY) {
+			for (int offsetX = -c_BenchmarkDigRadius; offsetX <= c_BenchmarkDigRadius; ++offsetX) {
+				if (offsetX * offsetX + offsetY * offsetY <= c_BenchmarkDigRadius * c_BenchmarkDigRadius) { g_SceneMan.TryPenetrate(digCenterX + offsetX, digCenterY + offsetY, digImpulse, digVelocity, retardation, 1.0F); }
+			}
+		}
+		g_SceneMan.UnlockScene();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Benchmark loop. Runs the requested number of fixed sim updates as fast as possible with the scripted workload and records the performance counters of each to the benchmark CSV file.
+/// </summary>
+/// <returns>Whether the benchmark ran and its results were written.</returns>
+bool RunBenchmarkLoop() {
+	if (!g_PerformanceMan.StartBenchmarkRecording(c_BenchmarkFileName)) {
+		g_ConsoleMan.PrintString("ERROR: Opening \'" + c_BenchmarkFileName + "\' for writing the benchmark results failed!");
+		return false;
+	}
+	std::deque<Actor *> benchmarkActors;
+	g_TimerMan.PauseSim(false);
+
+	for (unsigned int frameNumber = 0; frameNumber < g_BenchmarkFrames && !g_Quit; ++frameNumber) {
+		int64_t frameStartTime = g_TimerMan.GetAbsoulteTime();
+
+		// Always step the sim exactly once, however long the last update took in real time.
+		g_TimerMan.UpdateFixedStep();
+		g_PerformanceMan.NewPerformanceSample();
+		g_TimerMan.UpdateSim();
+
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+
+		UpdateBenchmarkWorkload(frameNumber, benchmarkActors);
+
+		g_UInputMan.Update();
+		g_FrameMan.Update();
+		g_AudioMan.Update();
+		g_LuaMan.Update();
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+		g_ActivityMan.Update();
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+		g_MovableMan.Update();
+
+		g_ActivityMan.LateUpdateGlobalScripts();
+
+		g_ConsoleMan.Update();
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+
+		if (g_BenchmarkDraw) {
+			g_FrameMan.ClearBackBuffer8();
+			g_FrameMan.Draw();
+			g_FrameMan.FlipFrameBuffers();
+		}
+		g_PerformanceMan.RecordBenchmarkSample(frameNumber, static_cast<unsigned long long>(g_TimerMan.GetAbsoulteTime() - frameStartTime));
+	}
+	g_PerformanceMan.StopBenchmarkRecording();
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /// <summary>
 /// Command-line argument handling.
 /// </summary>
@@ -1827,6 +1977,15 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar) {
             // Print loading screen console to cout
 			if (std::strcmp(argv[i], "-cout") == 0) {
 				g_System.SetLogToCLI(true);
+			// Draw every frame when running the benchmark
+			} else if (std::strcmp(argv[i], "-benchmarkdraw") == 0) {
+				g_BenchmarkDraw = true;
+			// Run the benchmark with the given Scene, Activity and number of sim updates instead of the game
+			} else if (std::strcmp(argv[i], "-benchmark") == 0 && i + 3 < argc) {
+				g_BenchmarkScene = argv[++i];
+				g_BenchmarkActivity = argv[++i];
+				g_BenchmarkFrames = static_cast<unsigned int>(std::max(std::atoi(argv[++i]), 0));
+				g_RunBenchmark = true;
 			} else if (i + 1 < argc) {
 				// Launch game in server mode
                 if (std::strcmp(argv[i], "-server") == 0 && i + 1 < argc) {
@@ -1886,6 +2045,7 @@ int main(int argc, char *argv[]) {
     new LuaMan();
     new SettingsMan();
     new TimerMan();
+	new ThreadMan();
 	new PerformanceMan();
     new PresetMan();
     new FrameMan();
@@ -1917,7 +2077,9 @@ int main(int argc, char *argv[]) {
     if (!HandleMainArgs(argc, argv, exitVar)) {
 		return exitVar;
 	}
+	g_PerformanceMan.SetTraceThreadName("Main Thread");
     g_TimerMan.Create();
+	g_ThreadMan.Create();
 	g_PerformanceMan.Create();
     g_PresetMan.Create();
     g_FrameMan.Create();
@@ -1935,7 +2097,10 @@ int main(int argc, char *argv[]) {
     ///////////////////////////////////////////////////////////////////
     // Main game driver
 
-	if (g_NetworkServer.IsServerModeEnabled()) {
+	if (g_RunBenchmark) {
+		g_AudioMan.SetSoundsVolume(0);
+		g_AudioMan.SetMusicVolume(0);
+	} else if (g_NetworkServer.IsServerModeEnabled()) {
 		g_NetworkServer.Start();
 		g_FrameMan.SetMultiplayerMode(true);
 		g_AudioMan.SetMultiplayerMode(true);
@@ -1947,25 +2112,31 @@ int main(int argc, char *argv[]) {
 	g_LoadingGUI.InitLoadingScreen();
 	InitMainMenu();
 
-	if (g_LaunchIntoEditor) { 
-		// Force mouse + keyboard with default mapping so we won't need to change manually if player 1 is set to keyboard only or gamepad.
-		g_UInputMan.GetControlScheme(0)->SetDevice(1);
-		g_UInputMan.GetControlScheme(0)->SetPreset(1);
-		// Disable intro sequence.
-		g_SettingsMan.SetPlayIntro(false);
-		// Start the specified editor activity.
-		EnterEditorActivity(g_EditorToLaunch);
-	}
+	if (g_RunBenchmark) {
+		// The benchmark skips the intro and menus entirely and quits as soon as it's done instead of going into the game loop.
+		exitVar = (StartBenchmarkActivity() && RunBenchmarkLoop()) ? 0 : 2;
+	} else {
+		if (g_LaunchIntoEditor) { 
+			// Force mouse + keyboard with default mapping so we won't need to change manually if player 1 is set to keyboard only or gamepad.
+			g_UInputMan.GetControlScheme(0)->SetDevice(1);
+			g_UInputMan.GetControlScheme(0)->SetPreset(1);
+			// Disable intro sequence.
+			g_SettingsMan.SetPlayIntro(false);
+			// Start the specified editor activity.
+			EnterEditorActivity(g_EditorToLaunch);
+		}
 
-    if (g_SettingsMan.PlayIntro() && !g_NetworkServer.IsServerModeEnabled()) { PlayIntroTitle(); }
+		if (g_SettingsMan.PlayIntro() && !g_NetworkServer.IsServerModeEnabled()) { PlayIntroTitle(); }
 
-	// NETWORK Create multiplayer lobby activity to start as default if server is running
-	if (g_NetworkServer.IsServerModeEnabled()) { EnterMultiplayerLobby(); }
+		// NETWORK Create multiplayer lobby activity to start as default if server is running
+		if (g_NetworkServer.IsServerModeEnabled()) { EnterMultiplayerLobby(); }
 
-    // If we fail to start/reset the activity, then revert to the intro/menu
-    if (!ResetActivity()) { PlayIntroTitle(); }
-	
-    RunGameLoop();
+		// If we fail to start/reset the activity, then revert to the intro/menu
+		if (!ResetActivity()) { PlayIntroTitle(); }
+
+		RunGameLoop();
+		exitVar = 0;
+	}
 
     ///////////////////////////////////////////////////////////////////
     // Clean up
@@ -1983,6 +2154,7 @@ int main(int argc, char *argv[]) {
     g_UInputMan.Destroy();
 	g_PerformanceMan.Destroy();
     g_FrameMan.Destroy();
+	g_ThreadMan.Destroy();
     g_TimerMan.Destroy();
     g_SettingsMan.Destroy();
     g_LuaMan.Destroy();
@@ -1994,7 +2166,7 @@ int main(int argc, char *argv[]) {
     Entity::ClassInfo::DumpPoolMemoryInfo(Writer("MemCleanupInfo.txt"));
 #endif
 	
-    return 0;
+    return exitVar;
 }
 
 int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) { return main(__argc, __argv); }
\ No newline at end of file
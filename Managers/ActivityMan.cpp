@@ -18,6 +18,7 @@
 #include "AudioMan.h"
 #include "ConsoleMan.h"
 #include "MetaMan.h"
+#include "PerformanceMan.h"
 #include "GAScripted.h"
 #include "Controller.h"
 #include "Scene.h"
@@ -1834,6 +1835,8 @@ void ActivityMan::EndActivity()
 
 void ActivityMan::Update()
 {
+    PerformanceMan::ProfileZone profileZone("ActivityMan::Update");
+
     if (m_pActivity)
         m_pActivity->Update();
 }
@@ -6,6 +6,7 @@
 #include "ConsoleMan.h"
 #include "SettingsMan.h"
 #include "UInputMan.h"
+#include "ThreadMan.h"
 
 #include "SLTerrain.h"
 #include "Scene.h"
@@ -61,6 +62,7 @@ namespace RTE {
 		m_BackBuffer32 = 0;
 		m_DrawNetworkBackBuffer = false;
 		m_StoreNetworkBackBuffer = false;
+		m_MultithreadedScreenDrawing = false;
 		m_NetworkFrameCurrent = 0;
 		m_NetworkFrameReady = 1;
 		m_PaletteFile.Reset();
@@ -240,6 +242,8 @@ namespace RTE {
 			reader >> m_VSplitOverride;
 		} else if (propName == "PaletteFile") {
 			reader >> m_PaletteFile;
+		} else if (propName == "MultithreadedScreenDrawing") {
+			reader >> m_MultithreadedScreenDrawing;
 		} else if (propName == "PixelsPerMeter") {
 			reader >> m_PPM;
 			m_MPP = 1 / m_PPM;
@@ -764,6 +768,8 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void FrameMan::Draw() {
+		PerformanceMan::ProfileZone profileZone("FrameMan::Draw");
+
 		// Count how many split screens we'll need
 		int screenCount = (m_HSplit ? 2 : 1) * (m_VSplit ? 2 : 1);
 		RTEAssert(screenCount <= 1 || m_PlayerScreen, "Splitscreen surface not ready when needed!");
@@ -776,6 +782,9 @@ namespace RTE {
 
 		const Activity *pActivity = g_ActivityMan.GetActivity();
 
+		// The scene updates and HUDs touch too much shared state to be drawn on multiple threads, but once every screen's offset is known the scene layers and post effects only read from it
+		bool drawScreensInParallel = m_MultithreadedScreenDrawing && IsInMultiplayerMode() && g_SceneMan.GetLayerDrawMode() == g_LayerNormal && g_ThreadMan.GetWorkerThreadCount() > 0;
+
 		for (int playerScreen = 0; playerScreen < screenCount; ++playerScreen) {
 			screenRelativeEffects.clear();
 			screenRelativeGlowBoxes.clear();
@@ -817,6 +826,10 @@ namespace RTE {
 			// Draw the scene
 			if (!IsInMultiplayerMode()) {
 				g_SceneMan.Draw(drawScreen, drawScreenGUI, targetPos);
+			} else if (drawScreensInParallel) {
+				// Only the HUDs are drawn here, the scene layers of all screens are drawn together below
+				clear_to_color(drawScreenGUI, g_MaskColor);
+				g_SceneMan.DrawHUD(drawScreenGUI, targetPos);
 			} else {
 				clear_to_color(drawScreen, g_MaskColor);
 				clear_to_color(drawScreenGUI, g_MaskColor);
@@ -824,7 +837,7 @@ namespace RTE {
 			}
 
 			// Get only the scene-relative post effects that affect this player's screen
-			if (pActivity) {
+			if (pActivity && !drawScreensInParallel) {
 				g_PostProcessMan.GetPostScreenEffectsWrapped(targetPos, drawScreen->w, drawScreen->h, screenRelativeEffects, pActivity->GetTeamOfPlayer(pActivity->PlayerOfScreen(playerScreen)));
 				g_PostProcessMan.GetGlowAreasWrapped(targetPos, drawScreen->w, drawScreen->h, screenRelativeGlowBoxes);
 
@@ -853,6 +866,20 @@ namespace RTE {
 			}
 		}
 
+		if (drawScreensInParallel) {
+			g_ThreadMan.ParallelFor(screenCount, [this, pActivity](size_t playerScreen) {
+				BITMAP *drawScreen = m_NetworkBackBufferIntermediate8[m_NetworkFrameCurrent][playerScreen];
+				clear_to_color(drawScreen, g_MaskColor);
+				g_SceneMan.DrawMOColorLayer(drawScreen, playerScreen);
+
+				if (pActivity) {
+					list<PostEffect> screenEffects;
+					g_PostProcessMan.GetPostScreenEffectsWrapped(m_TargetPos[m_NetworkFrameCurrent][playerScreen], drawScreen->w, drawScreen->h, screenEffects, pActivity->GetTeamOfPlayer(pActivity->PlayerOfScreen(playerScreen)));
+					g_PostProcessMan.SetNetworkPostEffectsList(playerScreen, screenEffects);
+				}
+			});
+		}
+
 		// Clears the pixels that have been revealed from the unseen layers
 		g_SceneMan.ClearSeenPixels();
 
@@ -1022,15 +1049,24 @@ namespace RTE {
 		unsigned short dw = m_BackBuffer8->w / 2;
 		unsigned short dh = m_BackBuffer8->h / 2;
 
+		/// <summary>
+		/// Internal lambda function to copy a player screen's intermediate bitmaps to the final ones the server sends from.
+		/// </summary>
+		auto copyToFinalBuffers = [this](size_t i) {
+			m_NetworkBitmapLock[i].lock();
+			blit(m_NetworkBackBufferIntermediate8[m_NetworkFrameCurrent][i], m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i], 0, 0, 0, 0, m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i]->w, m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i]->h);
+			blit(m_NetworkBackBufferIntermediateGUI8[m_NetworkFrameCurrent][i], m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i], 0, 0, 0, 0, m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i]->w, m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i]->h);
+			m_NetworkBitmapLock[i].unlock();
+		};
+		bool copyInParallel = m_MultithreadedScreenDrawing && g_ThreadMan.GetWorkerThreadCount() > 0;
+		if (copyInParallel) { g_ThreadMan.ParallelFor(c_MaxScreenCount, copyToFinalBuffers); }
+
 		// Blit all four internal player screens onto the backbuffer
 		for (unsigned short i = 0; i < c_MaxScreenCount; i++) {
 			dx = (i == 1 || i == 3) ? dw : dx;
 			dy = (i == 2 || i == 3) ? dh : dy;
 
-			m_NetworkBitmapLock[i].lock();
-			blit(m_NetworkBackBufferIntermediate8[m_NetworkFrameCurrent][i], m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i], 0, 0, 0, 0, m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i]->w, m_NetworkBackBufferFinal8[m_NetworkFrameCurrent][i]->h);
-			blit(m_NetworkBackBufferIntermediateGUI8[m_NetworkFrameCurrent][i], m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i], 0, 0, 0, 0, m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i]->w, m_NetworkBackBufferFinalGUI8[m_NetworkFrameCurrent][i]->h);
-			m_NetworkBitmapLock[i].unlock();
+			if (!copyInParallel) { copyToFinalBuffers(i); }
 
 #if defined DEBUG_BUILD || defined MIN_DEBUG_BUILD
 			// Draw all player's screen into one
@@ -389,6 +389,18 @@ namespace RTE {
 		/// <param name="value">Whether this manager should operate in multiplayer mode.</param>
 		void SetMultiplayerMode(bool value) { m_StoreNetworkBackBuffer = value; }
 
+		/// <summary>
+		/// Gets whether the player screens are drawn on multiple threads in multiplayer mode.
+		/// </summary>
+		/// <returns>Whether the player screens are drawn on multiple threads.</returns>
+		bool IsMultithreadedScreenDrawingEnabled() const { return m_MultithreadedScreenDrawing; }
+
+		/// <summary>
+		/// Sets whether the player screens should be drawn on multiple threads in multiplayer mode. Only the scene layers and post effects of each screen are drawn in parallel, HUDs are still drawn one screen at a time.
+		/// </summary>
+		/// <param name="enable">Whether to draw the player screens on multiple threads or not.</param>
+		void EnableMultithreadedScreenDrawing(bool enable) { m_MultithreadedScreenDrawing = enable; }
+
 		/// <summary>
 		/// Gets the ready 8bpp backbuffer bitmap used to draw network transmitted image on top of everything.
 		/// </summary>
@@ -612,6 +624,7 @@ namespace RTE {
 
 		bool m_StoreNetworkBackBuffer; //!< If true, dumps the contents of the m_BackBuffer8 to the network backbuffers every frame.
 		bool m_DrawNetworkBackBuffer; //!< If true, draws the contents of the network backbuffers on top of m_BackBuffer8 every frame in FrameMan.Draw.
+		bool m_MultithreadedScreenDrawing; //!< Whether the scene layers and post effects of the player screens are drawn on the worker threads in multiplayer mode.
 
 		unsigned short m_NetworkFrameCurrent; //!< Which frame index is being rendered, 0 or 1.
 		unsigned short m_NetworkFrameReady; //!< Which frame is rendered and ready for transmission, 0 or 1.
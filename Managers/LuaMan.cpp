@@ -43,6 +43,7 @@ extern "C"
 #include "luabind/out_value_policy.hpp"
 #include "luabind/iterator_policy.hpp"
 #include "luabind/return_reference_to_policy.hpp"
+#include "luabind/raw_policy.hpp"
 // Boost
 //#include "boost/detail/shared_ptr_nmt.hpp"
 //#include "boost/shared_ptr.hpp"
@@ -105,6 +106,7 @@ namespace RTE
 {
 
 const string LuaMan::m_ClassName = "LuaMan";
+unsigned long LuaMan::m_ScriptPresetGeneration = 0;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -348,6 +350,55 @@ void AddParticle(MovableMan &This, MovableObject *pParticle)
     else
         This.AddParticle(pParticle);
 }
+luabind::object GetActorsInRadius(const MovableMan &This, lua_State *pState, const Vector &center, float radius)
+{
+    vector<Actor *> actorsInRadius;
+    This.GetActorsInRadius(center, radius, actorsInRadius);
+    luabind::object actorTable = luabind::newtable(pState);
+    for (size_t i = 0; i < actorsInRadius.size(); ++i)
+        actorTable[i + 1] = actorsInRadius[i];
+    return actorTable;
+}
+luabind::object GetItemsInRadius(const MovableMan &This, lua_State *pState, const Vector &center, float radius)
+{
+    vector<MovableObject *> itemsInRadius;
+    This.GetItemsInRadius(center, radius, itemsInRadius);
+    luabind::object itemTable = luabind::newtable(pState);
+    for (size_t i = 0; i < itemsInRadius.size(); ++i)
+        itemTable[i + 1] = itemsInRadius[i];
+    return itemTable;
+}
+luabind::object CastRays(SceneMan &This, lua_State *pState, const luabind::object &rayQueryTable, bool parallel)
+{
+    vector<RayQuery> rayQueries;
+    for (luabind::iterator queryItr(rayQueryTable), queryEnd; queryItr != queryEnd; ++queryItr)
+    {
+        boost::optional<RayQuery> rayQuery = luabind::object_cast_nothrow<RayQuery>(*queryItr);
+        if (!rayQuery)
+            g_ConsoleMan.PrintString("ERROR: Tried to cast something that isn't a RayQuery! It won't hit anything.");
+        else if (rayQuery->m_Type < RayQuery::MORAY || rayQuery->m_Type > RayQuery::STRENGTHRAY)
+            g_ConsoleMan.PrintString("ERROR: Tried to cast a RayQuery of unknown type " + std::to_string(rayQuery->m_Type) + "! It won't hit anything.");
+        // Keep a query for every entry, even ones that can't be cast, so the results line up with the queries
+        rayQueries.push_back(rayQuery ? *rayQuery : RayQuery());
+    }
+    This.CastRays(rayQueries, parallel);
+    luabind::object resultTable = luabind::newtable(pState);
+    for (size_t i = 0; i < rayQueries.size(); ++i)
+        resultTable[i + 1] = rayQueries[i];
+    return resultTable;
+}
+luabind::object CastRays(SceneMan &This, lua_State *pState, const luabind::object &rayQueryTable) { return CastRays(This, pState, rayQueryTable, false); }
+bool SaveTrace(PerformanceMan &This, const std::string &fileName)
+{
+    // Scripts may only write traces into the trace directory, so any name that could lead out of it is refused
+    if (fileName.empty() || fileName.find("..") != string::npos || fileName.find_first_of("/\\:") != string::npos)
+    {
+        g_ConsoleMan.PrintString("ERROR: Can't save a trace to \'" + fileName + "\', only plain file names are allowed! Traces are saved in the Traces directory.");
+        return false;
+    }
+    g_System.MakeDirectory(g_System.GetWorkingDirectory() + "/Traces");
+    return This.SaveTrace(g_System.GetWorkingDirectory() + "/Traces/" + fileName);
+}
 
 /*
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -396,6 +447,9 @@ void LuaMan::Clear()
     m_pTempEntity = 0;
     m_TempEntityVector.clear();
     m_TempEntityVector.shrink_to_fit();
+    m_FunctionPathSegments.clear();
+    // Any scripts loaded before were cleared along with the rest, so everything has to check its preset tables again
+    m_ScriptPresetGeneration++;
 
 	//Clear files list
 	for (int i = 0; i < MAX_OPEN_FILES; ++i)
@@ -771,6 +825,18 @@ int LuaMan::Create()
             .def("StringValueExists", &MOSRotating::StringValueExists)
             .def("NumberValueExists", &MOSRotating::NumberValueExists)
             .def("ObjectValueExists", &MOSRotating::ObjectValueExists)
+            .def("GetStringValueByKeyID", &MOSRotating::GetStringValueByKeyID)
+            .def("GetNumberValueByKeyID", &MOSRotating::GetNumberValueByKeyID)
+            .def("GetObjectValueByKeyID", &MOSRotating::GetObjectValueByKeyID)
+            .def("SetStringValueByKeyID", &MOSRotating::SetStringValueByKeyID)
+            .def("SetNumberValueByKeyID", &MOSRotating::SetNumberValueByKeyID)
+            .def("SetObjectValueByKeyID", &MOSRotating::SetObjectValueByKeyID)
+            .def("RemoveStringValueByKeyID", &MOSRotating::RemoveStringValueByKeyID)
+            .def("RemoveNumberValueByKeyID", &MOSRotating::RemoveNumberValueByKeyID)
+            .def("RemoveObjectValueByKeyID", &MOSRotating::RemoveObjectValueByKeyID)
+            .def("StringValueExistsByKeyID", &MOSRotating::StringValueExistsByKeyID)
+            .def("NumberValueExistsByKeyID", &MOSRotating::NumberValueExistsByKeyID)
+            .def("ObjectValueExistsByKeyID", &MOSRotating::ObjectValueExistsByKeyID)
             .def("AddAttachable", (void (MOSRotating::*)(Attachable *attachableToAdd))&MOSRotating::AddAttachable, adopt(_2))
             .def("AddAttachable", (void (MOSRotating::*)(Attachable *attachableToAdd, const Vector &parentOffset))&MOSRotating::AddAttachable, adopt(_2))
             .def("RemoveAttachable", (bool (MOSRotating::*)(Attachable *attachableToRemove))&MOSRotating::RemoveAttachable)
@@ -949,6 +1015,8 @@ int LuaMan::Create()
             .def("DrawWaypoints", &Actor::DrawWaypoints)
             .def("SetMovePathToUpdate", &Actor::SetMovePathToUpdate)
             .def("UpdateMovePath", &Actor::UpdateMovePath)
+            .def("QueueMovePathUpdate", &Actor::QueueMovePathUpdate)
+            .property("IsWaitingOnMovePath", &Actor::IsWaitingOnMovePath)
             .property("MovePathSize", &Actor::GetMovePathSize)
             .def_readwrite("MOMoveTarget", &Actor::m_pMOMoveTarget)
             .def_readwrite("MovePath", &Actor::m_MovePath, return_stl_iterator)
@@ -1424,6 +1492,12 @@ int LuaMan::Create()
             .def("TimeForSimUpdate", &TimerMan::TimeForSimUpdate)
             .def("DrawnSimUpdate", &TimerMan::DrawnSimUpdate),
 
+		class_<PerformanceMan>("PerformanceManager")
+			.property("CapturingTrace", &PerformanceMan::IsCapturingTrace)
+			.def("StartTraceCapture", &PerformanceMan::StartTraceCapture)
+			.def("StopTraceCapture", &PerformanceMan::StopTraceCapture)
+			.def("SaveTrace", &SaveTrace),
+
         class_<FrameMan>("FrameManager")
             .property("PPM", &FrameMan::GetPPM)
             .property("MPP", &FrameMan::GetMPP)
@@ -1669,6 +1743,7 @@ int LuaMan::Create()
 			.property("GlocalAcc", &Scene::GetGlobalAcc, &Scene::SetGlobalAcc)
 			.def("ResetPathFinding", &Scene::ResetPathFinding)
             .def("UpdatePathFinding", &Scene::UpdatePathFinding)
+            .def("BenchmarkPathFinding", &Scene::BenchmarkPathFinding)
             .def("PathFindingUpdated", &Scene::PathFindingUpdated)
             .def("CalculatePath", &Scene::CalculateScenePath)
             .def_readwrite("ScenePath", &Scene::m_ScenePath, return_stl_iterator)
@@ -1683,6 +1758,30 @@ int LuaMan::Create()
 			.property("ID", &Deployment::GetID)
 			.property("HFlipped", &Deployment::IsHFlipped),
 
+        class_<RayQuery>("RayQuery")
+            .def(constructor<>())
+            .def_readwrite("Type", &RayQuery::m_Type)
+            .def_readwrite("Start", &RayQuery::m_Start)
+            .def_readwrite("Ray", &RayQuery::m_Ray)
+            .def_readwrite("Skip", &RayQuery::m_Skip)
+            .def_readwrite("Team", &RayQuery::m_Team)
+            .def_readwrite("IgnoreMOID", &RayQuery::m_IgnoreMOID)
+            .def_readwrite("Material", &RayQuery::m_Material)
+            .def_readwrite("Strength", &RayQuery::m_Strength)
+            .def_readonly("Hit", &RayQuery::m_Hit)
+            .def_readonly("HitPos", &RayQuery::m_HitPos)
+            .def_readonly("HitMOID", &RayQuery::m_HitMOID)
+            .def_readonly("HitDistance", &RayQuery::m_HitDistance)
+            .def_readonly("FreePos", &RayQuery::m_FreePos)
+            .enum_("RayType")
+            [
+                value("MORAY", RayQuery::MORAY),
+                value("OBSTACLERAY", RayQuery::OBSTACLERAY),
+                value("SEERAY", RayQuery::SEERAY),
+                value("MATERIALRAY", RayQuery::MATERIALRAY),
+                value("STRENGTHRAY", RayQuery::STRENGTHRAY)
+            ],
+
         class_<SceneMan>("SceneManager")
             .property("Scene", &SceneMan::GetScene)
             .def("LoadScene", (int (SceneMan::*)(string, bool, bool))&SceneMan::LoadScene)
@@ -1733,12 +1832,15 @@ int LuaMan::Create()
             .def("CastNotMaterialRay", (bool (SceneMan::*)(const Vector &, const Vector &, unsigned char, Vector &, int, bool))&SceneMan::CastNotMaterialRay)
             .def("CastNotMaterialRay", (float (SceneMan::*)(const Vector &, const Vector &, unsigned char, int, bool))&SceneMan::CastNotMaterialRay)
             .def("CastStrengthSumRay", &SceneMan::CastStrengthSumRay)
-            .def("CastMaxStrengthRay", &SceneMan::CastMaxStrengthRay)
+            .def("CastMaxStrengthRay", (float (SceneMan::*)(const Vector &, const Vector &, int))&SceneMan::CastMaxStrengthRay)
             .def("CastStrengthRay", &SceneMan::CastStrengthRay)
             .def("CastWeaknessRay", &SceneMan::CastWeaknessRay)
             .def("CastMORay", &SceneMan::CastMORay)
             .def("CastFindMORay", &SceneMan::CastFindMORay)
             .def("CastObstacleRay", &SceneMan::CastObstacleRay)
+            .def("BenchmarkRayCasts", &SceneMan::BenchmarkRayCasts)
+            .def("CastRays", (luabind::object (*)(SceneMan &, lua_State *, const luabind::object &, bool))&CastRays, raw(_2))
+            .def("CastRays", (luabind::object (*)(SceneMan &, lua_State *, const luabind::object &))&CastRays, raw(_2))
             .def("GetLastRayHitPos", &SceneMan::GetLastRayHitPos)
             .def("FindAltitude", &SceneMan::FindAltitude)
             .def("MovePointToGround", &SceneMan::MovePointToGround)
@@ -2138,6 +2240,8 @@ int LuaMan::Create()
             .def("GetClosestEnemyActor", &MovableMan::GetClosestEnemyActor)
             .def("GetFirstTeamActor", &MovableMan::GetFirstTeamActor)
             .def("GetClosestActor", &MovableMan::GetClosestActor)
+            .def("GetActorsInRadius", &GetActorsInRadius, raw(_2))
+            .def("GetItemsInRadius", &GetItemsInRadius, raw(_2))
             .def("GetClosestBrainActor", &MovableMan::GetClosestBrainActor)
             .def("GetFirstBrainActor", &MovableMan::GetFirstBrainActor)
             .def("GetClosestOtherBrainActor", &MovableMan::GetClosestOtherBrainActor)
@@ -2204,6 +2308,7 @@ int LuaMan::Create()
         def("NormalRand", &NormalRand),
         def("RangeRand", &RangeRand),
         def("SelectRand", &SelectRand),
+        def("GetCustomValueKeyID", &CustomValueKeys::GetKeyID),
         def("LERP", &LERP),
         def("EaseIn", &EaseIn),
         def("EaseOut", &EaseOut),
@@ -2213,6 +2318,7 @@ int LuaMan::Create()
 
     // Assign the manager instances to globals in the lua master state
     globals(m_pMasterState)["TimerMan"] = &g_TimerMan;
+	globals(m_pMasterState)["PerformanceMan"] = &g_PerformanceMan;
     globals(m_pMasterState)["FrameMan"] = &g_FrameMan;
 	globals(m_pMasterState)["PostProcessMan"] = &g_PostProcessMan;
 	globals(m_pMasterState)["PrimitiveMan"] = &g_PrimitiveMan;
@@ -2414,6 +2520,24 @@ bool LuaMan::ExpressionIsTrue(string expression, bool consoleErrors)
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int LuaMan::RunScriptedFunction(const std::string &functionName, const std::string &selfObjectName, std::vector<std::string> variablesToSafetyCheck, std::vector<Entity *> functionEntityArguments, std::vector<std::string> functionLiteralArguments) {
+    PerformanceMan::ProfileZone profileZone("LuaMan::RunScriptedFunction");
+    g_PerformanceMan.AddScriptInvocation();
+
+    // The compiled path treats a missing function or self object as a reason to fall back, so it's only equivalent when every safety check is the self object or a table on the way to the function.
+    bool safetyChecksCoveredByPaths = true;
+    for (const std::string &variableToSafetyCheck : variablesToSafetyCheck) {
+        bool isFunctionPathPrefix = functionName.compare(0, variableToSafetyCheck.size(), variableToSafetyCheck) == 0 && (functionName.size() == variableToSafetyCheck.size() || functionName[variableToSafetyCheck.size()] == '.' || functionName[variableToSafetyCheck.size()] == '[');
+        if (!isFunctionPathPrefix && variableToSafetyCheck != selfObjectName) {
+            safetyChecksCoveredByPaths = false;
+            break;
+        }
+    }
+    int error = 0;
+    if (safetyChecksCoveredByPaths && RunCompiledFunction(functionName, selfObjectName, functionEntityArguments, functionLiteralArguments, error)) {
+        return error;
+    }
+    g_PerformanceMan.AddUncompiledScriptInvocation();
+
     std::string scriptString = "";
     if (!variablesToSafetyCheck.empty()) {
         scriptString += "if ";
@@ -2449,7 +2573,150 @@ int LuaMan::RunScriptedFunction(const std::string &functionName, const std::stri
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool LuaMan::RunCompiledFunction(const std::string &functionName, const std::string &selfObjectName, const std::vector<Entity *> &functionEntityArguments, const std::vector<std::string> &functionLiteralArguments, int &error) {
+    int stackTop = lua_gettop(m_pMasterState);
+    lua_pushcfunction(m_pMasterState, &AddFileAndLineToError);
+    int errorHandlerIndex = lua_gettop(m_pMasterState);
+
+    // Only the splitting up of the function name is cached. The function itself is looked up again every time, since scripts can reassign it whenever they like
+    std::unordered_map<std::string, std::vector<std::string>>::const_iterator functionPathSegments = m_FunctionPathSegments.find(functionName);
+    if (functionPathSegments == m_FunctionPathSegments.end()) {
+        std::vector<std::string> pathSegments;
+        if (!SplitGlobalPath(functionName, pathSegments)) {
+            pathSegments.clear();
+        }
+        functionPathSegments = m_FunctionPathSegments.insert({functionName, pathSegments}).first;
+    }
+    if (!PushGlobalPathValue(functionPathSegments->second) || !lua_isfunction(m_pMasterState, -1)) {
+        lua_settop(m_pMasterState, stackTop);
+        return false;
+    }
+
+    // Self object names are different for every object, so they aren't worth caching
+    std::vector<std::string> selfObjectPathSegments;
+    if (!SplitGlobalPath(selfObjectName, selfObjectPathSegments) || !PushGlobalPathValue(selfObjectPathSegments) || lua_isnil(m_pMasterState, -1)) {
+        lua_settop(m_pMasterState, stackTop);
+        return false;
+    }
+
+    try {
+        for (Entity *functionEntityArgument : functionEntityArguments) {
+            // Cast the argument to its actual type through the same To<Class> function the script string would use, so scripts get the full interface.
+            lua_getglobal(m_pMasterState, ("To" + functionEntityArgument->GetClassName()).c_str());
+            if (!lua_isfunction(m_pMasterState, -1)) {
+                lua_settop(m_pMasterState, stackTop);
+                return false;
+            }
+            luabind::object(m_pMasterState, functionEntityArgument).push(m_pMasterState);
+            if (lua_pcall(m_pMasterState, 1, 1, errorHandlerIndex)) {
+                lua_settop(m_pMasterState, stackTop);
+                return false;
+            }
+        }
+    } catch (const std::exception &) {
+        lua_settop(m_pMasterState, stackTop);
+        return false;
+    }
+    for (const std::string &functionLiteralArgument : functionLiteralArguments) {
+        // Only plain decimal numbers are pushed as numbers. strtod would also take inf, nan and hex, which Lua reads as names or parses differently
+        bool isPlainNumber = !functionLiteralArgument.empty() && functionLiteralArgument.find_first_not_of("0123456789+-.eE") == std::string::npos;
+        char *numberEnd = nullptr;
+        double numberValue = isPlainNumber ? std::strtod(functionLiteralArgument.c_str(), &numberEnd) : 0;
+        if (isPlainNumber && *numberEnd == '\0') {
+            lua_pushnumber(m_pMasterState, numberValue);
+        } else if (functionLiteralArgument == "true" || functionLiteralArgument == "false") {
+            lua_pushboolean(m_pMasterState, functionLiteralArgument == "true");
+        } else if (functionLiteralArgument == "nil") {
+            lua_pushnil(m_pMasterState);
+        } else {
+            lua_settop(m_pMasterState, stackTop);
+            return false;
+        }
+    }
+
+    error = 0;
+    try {
+        if (lua_pcall(m_pMasterState, 1 + static_cast<int>(functionEntityArguments.size() + functionLiteralArguments.size()), 0, errorHandlerIndex)) {
+            m_LastError = lua_tostring(m_pMasterState, -1);
+            lua_pop(m_pMasterState, 1);
+            g_ConsoleMan.PrintString("ERROR: " + m_LastError);
+            ClearErrors();
+            error = -1;
+        }
+    } catch (const std::exception &e) {
+        m_LastError = e.what();
+        g_ConsoleMan.PrintString("ERROR: " + m_LastError);
+        ClearErrors();
+        error = -1;
+    }
+    lua_settop(m_pMasterState, stackTop);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::SplitGlobalPath(const std::string &globalPath, std::vector<std::string> &pathSegments) {
+    pathSegments.clear();
+    size_t position = 0;
+    while (position < globalPath.size()) {
+        if (globalPath[position] == '[') {
+            // String index, i.e. ["Key"]. Escapes aren't supported, those names get the script string treatment instead.
+            if (pathSegments.empty() || position + 1 >= globalPath.size() || globalPath[position + 1] != '"') {
+                return false;
+            }
+            size_t keyEnd = globalPath.find('"', position + 2);
+            if (keyEnd == std::string::npos || keyEnd + 1 >= globalPath.size() || globalPath[keyEnd + 1] != ']' || globalPath.find('\\', position + 2) < keyEnd) {
+                return false;
+            }
+            pathSegments.push_back(globalPath.substr(position + 2, keyEnd - position - 2));
+            position = keyEnd + 2;
+        } else {
+            if (globalPath[position] == '.') {
+                if (pathSegments.empty()) {
+                    return false;
+                }
+                ++position;
+            } else if (!pathSegments.empty()) {
+                return false;
+            }
+            size_t nameEnd = position;
+            while (nameEnd < globalPath.size() && (std::isalnum(static_cast<unsigned char>(globalPath[nameEnd])) || globalPath[nameEnd] == '_')) {
+                ++nameEnd;
+            }
+            if (nameEnd == position) {
+                return false;
+            }
+            pathSegments.push_back(globalPath.substr(position, nameEnd - position));
+            position = nameEnd;
+        }
+    }
+    return !pathSegments.empty();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::PushGlobalPathValue(const std::vector<std::string> &pathSegments) {
+    if (pathSegments.empty()) {
+        return false;
+    }
+
+    lua_getglobal(m_pMasterState, pathSegments.front().c_str());
+    for (size_t segment = 1; segment < pathSegments.size(); ++segment) {
+        if (!lua_istable(m_pMasterState, -1)) {
+            lua_pop(m_pMasterState, 1);
+            lua_pushnil(m_pMasterState);
+            return true;
+        }
+        lua_getfield(m_pMasterState, -1, pathSegments[segment].c_str());
+        lua_remove(m_pMasterState, -2);
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int LuaMan::RunScriptString(const std::string &scriptString, bool consoleErrors) {
+    PerformanceMan::ProfileZone profileZone("LuaMan::RunScriptString");
     if (scriptString.empty()) {
         return -1;
     }
@@ -2486,6 +2753,7 @@ int LuaMan::RunScriptString(const std::string &scriptString, bool consoleErrors)
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int LuaMan::RunScriptFile(const std::string &filePath, bool consoleErrors) {
+    PerformanceMan::ProfileZone profileZone("LuaMan::RunScriptFile");
     if (filePath.empty()) {
         m_LastError = "Can't run a script file with an empty filepath!";
         return -1;
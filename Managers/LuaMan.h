@@ -230,6 +230,7 @@ enum ServerResult
     /// <summary>
     /// Runs the given Lua function with optional safety checks and arguments. The first argument to the function will always be the self object.
     /// If either argument list has entries, they will be passed into the function in order, with entity arguments first.
+    /// The function is pushed and called directly, so calls don't need to build and compile a script string. If the function or arguments can't be pushed directly, the script string is run instead.
     /// </summary>
     /// <param name="functionName">The name that gives access to the function in the global Lua namespace.</param>
     /// <param name="selfObjectName">The name that gives access to the self object in the global Lua namespace.</param>
@@ -385,6 +386,17 @@ enum ServerResult
 
 	void ClearUserModuleCache();
 
+    /// <summary>
+    /// Gets the current script preset generation. It changes every time scripts are reloaded, so scripted objects only need to check their preset tables in Lua when it differs from the one they last checked against.
+    /// </summary>
+    /// <returns>The current script preset generation. Never 0.</returns>
+    unsigned long GetScriptPresetGeneration() const { return m_ScriptPresetGeneration; }
+
+    /// <summary>
+    /// Advances the script preset generation, making all scripted objects check their preset tables again on their next script update.
+    /// </summary>
+    void IncrementScriptPresetGeneration() { m_ScriptPresetGeneration++; }
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Protected member variable and method declarations
@@ -408,6 +420,12 @@ protected:
     Entity *m_pTempEntity;
     // Temporary holder for a vector of Entities that we want to pass into the Lua state without a fuss. Usually used to pass arguments to special Lua functions.
     std::vector<Entity *> m_TempEntityVector;
+    // The segments of the function names RunScriptedFunction has already split up, keyed by the name that gives access to the function in the global Lua namespace.
+    // Only the names are cached, the functions are looked up through them again on every call since scripts can reassign them at any time.
+    std::unordered_map<std::string, std::vector<std::string>> m_FunctionPathSegments;
+    // The current script preset generation, incremented whenever scripts are reloaded. See GetScriptPresetGeneration.
+    // Static so it keeps counting up over the whole run even when the LuaMan is destroyed and created again, so no object can mistake a new generation for one it already checked against.
+    static unsigned long m_ScriptPresetGeneration;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -425,6 +443,32 @@ private:
 
     void Clear();
 
+    /// <summary>
+    /// Splits up a name that gives access to a value in the global Lua namespace into the keys to look up one after the other. Only plain names, dot access and string indices (i.e. `Table.Field["Key"]`) are supported.
+    /// </summary>
+    /// <param name="globalPath">The name that gives access to the value in the global Lua namespace.</param>
+    /// <param name="pathSegments">Vector to fill with the keys to look up, starting with the global one.</param>
+    /// <returns>Whether the name could be split up.</returns>
+    static bool SplitGlobalPath(const std::string &globalPath, std::vector<std::string> &pathSegments);
+
+    /// <summary>
+    /// Pushes the value that the given keys give access to in the global Lua namespace onto the stack. If any table along the way is missing, nil is pushed.
+    /// </summary>
+    /// <param name="pathSegments">The keys to look up one after the other, as split up by SplitGlobalPath.</param>
+    /// <returns>Whether a value was pushed. Nothing is pushed if there are no keys.</returns>
+    bool PushGlobalPathValue(const std::vector<std::string> &pathSegments);
+
+    /// <summary>
+    /// Runs the given Lua function by pushing it and its arguments directly and calling it with lua_pcall, instead of building a script string. See RunScriptedFunction.
+    /// </summary>
+    /// <param name="functionName">The name that gives access to the function in the global Lua namespace.</param>
+    /// <param name="selfObjectName">The name that gives access to the self object in the global Lua namespace.</param>
+    /// <param name="functionEntityArguments">Vector of entity pointers that should be passed into the Lua function.</param>
+    /// <param name="functionLiteralArguments">Vector of strings that should be passed into the Lua function. Only numbers, booleans and nil can be pushed directly.</param>
+    /// <param name="error">Set to the error return value of the function call if it was run.</param>
+    /// <returns>Whether the function was run. If false, nothing was run and the stack is left as it was, so the script string should be run instead.</returns>
+    bool RunCompiledFunction(const std::string &functionName, const std::string &selfObjectName, const std::vector<Entity *> &functionEntityArguments, const std::vector<std::string> &functionLiteralArguments, int &error);
+
 
     // Disallow the use of some implicit methods.
     LuaMan(const LuaMan &reference);
@@ -24,6 +24,10 @@
 #include "Actor.h"
 #include "ADoor.h"
 #include "Atom.h"
+#include "ThreadMan.h"
+#include "Scene.h"
+#include "ConsoleMan.h"
+#include "SettingsMan.h"
 
 namespace RTE {
 
@@ -72,6 +76,13 @@ void MovableMan::Clear()
     m_SloMoDuration = 1000;
     m_SettlingEnabled = true;
     m_MOSubtractionEnabled = true;
+    m_MultithreadedParticleTravel = false;
+    m_IncrementalMOIDs = false;
+    m_ValidateMOIDs = false;
+    m_MOIDLayerTracker.Reset();
+    m_ActorGrid.Reset();
+    m_ItemGrid.Reset();
+    m_SpatialGridsNeedRebuild = true;
 }
 
 
@@ -125,6 +136,12 @@ int MovableMan::ReadProperty(std::string propName, Reader &reader)
         reader >> m_SettlingEnabled;
     else if (propName == "EnableMOSubtraction")
         reader >> m_MOSubtractionEnabled;
+    else if (propName == "MultithreadedParticleTravel")
+        reader >> m_MultithreadedParticleTravel;
+    else if (propName == "IncrementalMOIDs")
+        reader >> m_IncrementalMOIDs;
+    else if (propName == "ValidateMOIDs")
+        reader >> m_ValidateMOIDs;
     else
         // See if the base class(es) can find a match instead
         return Serializable::ReadProperty(propName, reader);
@@ -242,6 +259,7 @@ void MovableMan::PurgeAllMOs()
     m_AddedActors.clear();
     m_AddedItems.clear();
     m_AddedParticles.clear();
+    m_SpatialGridsNeedRebuild = true;
     m_ActorRoster[Activity::TEAM_1].clear();
     m_ActorRoster[Activity::TEAM_2].clear();
     m_ActorRoster[Activity::TEAM_3].clear();
@@ -254,6 +272,8 @@ void MovableMan::PurgeAllMOs()
     m_AddedAlarmEvents.clear();
     m_AlarmEvents.clear();
     m_MOIDIndex.clear();
+    // The purged MOs are gone from the MOID layer as well
+    m_MOIDLayerTracker.EraseAll();
 
     // Set the time limit to 0 so it will report as being past it from the start of simulation
     m_SloMoTimer.SetRealTimeLimitMS(0);
@@ -559,50 +579,24 @@ Actor * MovableMan::GetClosestTeamActor(int team, int player, const Vector &scen
     Activity *pActivity = g_ActivityMan.GetActivity();
 
     Vector distanceVec;
-    float distance;
-    float shortestDistance = maxRadius;
     Actor *pClosestActor = 0;
 
     // If we're looking for a noteam actor, then go through the entire actor list instead
     if (team == Activity::NOTEAM)
     {
-        for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
-        {
-            if ((*aIt) == pExcludeThis || (*aIt)->GetTeam() != Activity::NOTEAM)
-                continue;
-
-            distanceVec = g_SceneMan.ShortestDistance((*aIt)->GetPos(), scenePoint);
-            distance = distanceVec.GetMagnitude();
-
-            // Check if even within search radius
-            if (distance < shortestDistance)
-            {
-                shortestDistance = distance;
-                pClosestActor = *aIt;
-            }
-        }
+        pClosestActor = FindClosestActor(scenePoint, maxRadius, false, [pExcludeThis](const Actor *pActor) {
+            return pActor != pExcludeThis && pActor->GetTeam() == Activity::NOTEAM;
+        }, distanceVec);
     }
-    // A specific team, so use the rosters instead
+    // A specific team, so go by the same Actors as the roster, which also has the ones added this frame
     else
     {
-        for (list<Actor *>::iterator aIt = m_ActorRoster[team].begin(); aIt != m_ActorRoster[team].end(); ++aIt)
-        {
-            if ((*aIt) == pExcludeThis || (*aIt)->GetController()->IsPlayerControlled(player) || (pActivity && pActivity->IsOtherPlayerBrain(*aIt, player)))
-                continue;
-
-            distanceVec = g_SceneMan.ShortestDistance((*aIt)->GetPos(), scenePoint);
-            distance = distanceVec.GetMagnitude();
-
-            // Check if even within search radius
-            if (distance < shortestDistance)
-            {
-                shortestDistance = distance;
-                pClosestActor = *aIt;
-            }
-        }
+        pClosestActor = FindClosestActor(scenePoint, maxRadius, true, [team, player, pExcludeThis, pActivity](const Actor *pActor) {
+            return pActor != pExcludeThis && pActor->GetTeam() == team && !const_cast<Actor *>(pActor)->GetController()->IsPlayerControlled(player) && !(pActivity && pActivity->IsOtherPlayerBrain(const_cast<Actor *>(pActor), player));
+        }, distanceVec);
     }
 
-    getDistance = shortestDistance;
+    getDistance = pClosestActor ? distanceVec.GetMagnitude() : maxRadius;
     return pClosestActor;
 }
 
@@ -617,32 +611,8 @@ Actor * MovableMan::GetClosestEnemyActor(int team, const Vector &scenePoint, int
 {
     if (team < Activity::NOTEAM || team >= Activity::MAXTEAMCOUNT || m_Actors.empty() ||  m_ActorRoster[team].empty())
         return 0;
-    
-    Activity *pActivity = g_ActivityMan.GetActivity();
-    
-    Vector distanceVec;
-    float distance;
-    float shortestDistance = maxRadius;
-    Actor *pClosestActor = 0;
-    
-    for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
-    {
-        if ((*aIt)->GetTeam() == team)
-            continue;
 
-        distanceVec = g_SceneMan.ShortestDistance((*aIt)->GetPos(), scenePoint);
-        distance = distanceVec.GetMagnitude();
-        
-        // Check if even within search radius
-        if (distance < shortestDistance)
-        {
-            shortestDistance = distance;
-            pClosestActor = *aIt;
-            getDistance.SetXY(distanceVec.GetX(), distanceVec.GetY());
-        }
-    }
-    
-    return pClosestActor;
+    return FindClosestActor(scenePoint, maxRadius, false, [team](const Actor *pActor) { return pActor->GetTeam() != team; }, getDistance);
 }
 
 
@@ -657,30 +627,113 @@ Actor * MovableMan::GetClosestActor(Vector &scenePoint, int maxRadius, float &ge
     if (m_Actors.empty())
         return 0;
 
-    Activity *pActivity = g_ActivityMan.GetActivity();
-
     Vector distanceVec;
-    float distance;
-    float shortestDistance = maxRadius;
-    Actor *pClosestActor = 0;
+    Actor *pClosestActor = FindClosestActor(scenePoint, maxRadius, false, [pExcludeThis](const Actor *pActor) { return pActor != pExcludeThis; }, distanceVec);
 
-    for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
+    getDistance = pClosestActor ? distanceVec.GetMagnitude() : maxRadius;
+    return pClosestActor;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetActorsInRadius
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all Actors in the internal Actor list that are within a radius of
+//                  a specific scene point, taking Scene wrapping into account.
+
+void MovableMan::GetActorsInRadius(const Vector &scenePoint, float radius, std::vector<Actor *> &actorsInRadius) const
+{
+    UpdateSpatialGrids();
+
+    std::vector<MovableObject *> objectsInRadius;
+    m_ActorGrid.GetObjectsInRadius(scenePoint, radius, objectsInRadius);
+    for (MovableObject *pObject : objectsInRadius)
+        actorsInRadius.push_back(static_cast<Actor *>(pObject));
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetItemsInRadius
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all Items in the internal Item list that are within a radius of
+//                  a specific scene point, taking Scene wrapping into account.
+
+void MovableMan::GetItemsInRadius(const Vector &scenePoint, float radius, std::vector<MovableObject *> &itemsInRadius) const
+{
+    UpdateSpatialGrids();
+    m_ItemGrid.GetObjectsInRadius(scenePoint, radius, itemsInRadius);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateSpatialGrids
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Refills the Actor and Item spatial grids if they are out of date.
+
+void MovableMan::UpdateSpatialGrids() const
+{
+    if (!m_SpatialGridsNeedRebuild)
+        return;
+
+    // Cells about the size of a big Actor keep the buckets small without the searches having to look through lots of empty ones
+    const int gridCellSize = 128;
+
+    int sceneWidth = g_SceneMan.GetSceneWidth();
+    int sceneHeight = g_SceneMan.GetSceneHeight();
+    bool wrapsX = g_SceneMan.SceneWrapsX();
+    bool wrapsY = g_SceneMan.SceneWrapsY();
+    if (!m_ActorGrid.Covers(sceneWidth, sceneHeight, wrapsX, wrapsY))
     {
-        if ((*aIt) == pExcludeThis)
-            continue;
+        m_ActorGrid.Create(sceneWidth, sceneHeight, wrapsX, wrapsY, gridCellSize);
+        m_ItemGrid.Create(sceneWidth, sceneHeight, wrapsX, wrapsY, gridCellSize);
+    }
+    m_ActorGrid.Reset();
+    m_ItemGrid.Reset();
+
+    for (Actor *pActor : m_Actors)
+        m_ActorGrid.Add(pActor);
+    for (MovableObject *pItem : m_Items)
+        m_ItemGrid.Add(pItem);
+
+    m_SpatialGridsNeedRebuild = false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FindClosestActor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds the Actor closest to a scene point out of the ones that pass a
+//                  filter, using the Actor spatial grid.
+
+Actor * MovableMan::FindClosestActor(const Vector &scenePoint, float maxDistance, bool includeAddedActors, const std::function<bool(const Actor *)> &actorFilter, Vector &getDistance) const
+{
+    UpdateSpatialGrids();
 
-        distanceVec = g_SceneMan.ShortestDistance((*aIt)->GetPos(), scenePoint);
-        distance = distanceVec.GetMagnitude();
+    Vector distanceVec;
+    Actor *pClosestActor = static_cast<Actor *>(m_ActorGrid.GetClosestObject(scenePoint, maxDistance, [&actorFilter](const MovableObject *pObject) { return actorFilter(static_cast<const Actor *>(pObject)); }, distanceVec));
+    float shortestDistance = pClosestActor ? distanceVec.GetMagnitude() : maxDistance;
 
-        // Check if even within search radius
-        if (distance < shortestDistance)
+    // The Actors added this frame aren't in the grid yet, but there are few enough of them to just go through
+    if (includeAddedActors)
+    {
+        for (Actor *pActor : m_AddedActors)
         {
-            shortestDistance = distance;
-            pClosestActor = *aIt;
+            if (!actorFilter(pActor))
+                continue;
+
+            Vector addedDistanceVec = g_SceneMan.ShortestDistance(pActor->GetPos(), scenePoint);
+            float distance = addedDistanceVec.GetMagnitude();
+            if (distance < shortestDistance)
+            {
+                shortestDistance = distance;
+                pClosestActor = pActor;
+                distanceVec = addedDistanceVec;
+            }
         }
     }
 
-    getDistance = shortestDistance;
+    if (pClosestActor)
+        getDistance = distanceVec;
     return pClosestActor;
 }
 
@@ -697,27 +750,9 @@ Actor * MovableMan::GetClosestBrainActor(int team, const Vector &scenePoint) con
         return 0;
 
     Vector distanceVec;
-    float distance;
-    float shortestDistance = g_SceneMan.GetSceneDim().GetLargest();
-    Actor *pClosestBrain = 0;
-
-    for (list<Actor *>::const_iterator aIt = m_ActorRoster[team].begin(); aIt != m_ActorRoster[team].end(); ++aIt)
-    {
-        if (!(*aIt)->HasObjectInGroup("Brains"))
-            continue;
-
-        distanceVec = g_SceneMan.ShortestDistance((*aIt)->GetPos(), scenePoint);
-        distance = distanceVec.GetMagnitude();
-
-        // Check if closer than best so far
-        if (distance < shortestDistance)
-        {
-            shortestDistance = distance;
-            pClosestBrain = *aIt;
-        }
-    }
-
-    return pClosestBrain;
+    return FindClosestActor(scenePoint, g_SceneMan.GetSceneDim().GetLargest(), true, [team](const Actor *pActor) {
+        return pActor->GetTeam() == team && pActor->HasObjectInGroup("Brains");
+    }, distanceVec);
 }
 
 
@@ -977,6 +1012,8 @@ bool MovableMan::RemoveActor(MovableObject *pActorToRem)
         }
 		RemoveActorFromTeamRoster(dynamic_cast<Actor *>(pActorToRem));
     }
+    if (removed)
+        m_SpatialGridsNeedRebuild = true;
     return removed;
 }
 
@@ -1017,6 +1054,8 @@ bool MovableMan::RemoveItem(MovableObject *pItemToRem)
             }
         }
     }
+    if (removed)
+        m_SpatialGridsNeedRebuild = true;
     return removed;
 }
 
@@ -1462,6 +1501,8 @@ int MovableMan::EjectAllActors(list<SceneObject *> &actorList, int onlyTeam, boo
     for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team)
         m_ActorRoster[team].clear();
 
+    m_SpatialGridsNeedRebuild = true;
+
     return addedCount;
 }
 
@@ -1494,6 +1535,8 @@ int MovableMan::EjectAllItems(list<SceneObject *> &itemList)
     // Clear the internal Item list; we transferred the ownership of them
     m_AddedItems.clear();
 
+    m_SpatialGridsNeedRebuild = true;
+
     return addedCount;
 }
 
@@ -1584,6 +1627,33 @@ void MovableMan::OverrideMaterialDoors(bool enable, int team)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDoorMaterialFootprints
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the areas and materials of all door material representations of a
+//                  specific team that are currently drawn into the terrain.
+
+void MovableMan::GetDoorMaterialFootprints(int team, std::vector<std::pair<Box, unsigned char>> &doorFootprints) const
+{
+    Box footprintArea;
+    unsigned char materialID;
+    const ADoor *pDoor = 0;
+    for (deque<Actor *>::const_iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
+    {
+        pDoor = dynamic_cast<const ADoor *>(*aIt);
+        if (pDoor && (team == Activity::NOTEAM || pDoor->GetTeam() == team) && pDoor->GetDoorMaterialFootprint(footprintArea, materialID))
+            doorFootprints.push_back(std::make_pair(footprintArea, materialID));
+    }
+    // Also check all doors added this frame
+    for (deque<Actor *>::const_iterator aIt = m_AddedActors.begin(); aIt != m_AddedActors.end(); ++aIt)
+    {
+        pDoor = dynamic_cast<const ADoor *>(*aIt);
+        if (pDoor && (team == Activity::NOTEAM || pDoor->GetTeam() == team) && pDoor->GetDoorMaterialFootprint(footprintArea, materialID))
+            doorFootprints.push_back(std::make_pair(footprintArea, materialID));
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RedrawOverlappingMOIDs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1634,6 +1704,77 @@ void MovableMan::OnPieMenu(Actor * pActor)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TravelParticlesMultithreaded
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Does the first pass travel of all particles, spreading the ones that
+//                  only need to read the Scene across the ThreadMan worker threads. Any
+//                  particle that needs to write to the Scene or hit other MOs is deferred
+//                  and travelled serially afterwards, in list order.
+
+void MovableMan::TravelParticlesMultithreaded()
+{
+    // Too small chunks cost more in scheduling than they gain, too many means more deferred lists to merge
+    const size_t minParticlesPerChunk = 64;
+
+    struct ParticleTravelChunk
+    {
+        SpeculativeTravelContext Context;
+        // Indices of the particles that couldn't travel speculatively, and whether they already got their ApplyForces and PreTravel
+        std::vector<std::pair<size_t, bool> > DeferredParticles;
+    };
+
+    size_t particleCount = m_Particles.size();
+    size_t chunkCount = std::min((particleCount + minParticlesPerChunk - 1) / minParticlesPerChunk, static_cast<size_t>(g_ThreadMan.GetWorkerThreadCount() + 1) * 4);
+    if (chunkCount == 0)
+        return;
+    size_t chunkSize = (particleCount + chunkCount - 1) / chunkCount;
+    std::vector<ParticleTravelChunk> chunks(chunkCount);
+
+    g_ThreadMan.ParallelFor(chunkCount, [this, &chunks, chunkSize, particleCount](size_t chunkIndex) {
+        ParticleTravelChunk &chunk = chunks[chunkIndex];
+        size_t chunkEnd = std::min((chunkIndex + 1) * chunkSize, particleCount);
+        for (size_t particleIndex = chunkIndex * chunkSize; particleIndex < chunkEnd; ++particleIndex)
+        {
+            MovableObject *pParticle = m_Particles[particleIndex];
+            if (pParticle->IsUpdated())
+                continue;
+            if (!pParticle->CanTravelSpeculatively())
+            {
+                chunk.DeferredParticles.push_back(std::make_pair(particleIndex, false));
+                continue;
+            }
+            pParticle->ApplyForces();
+            pParticle->PreTravel();
+            if (pParticle->TravelSpeculatively(chunk.Context))
+                pParticle->PostTravel();
+            else
+                chunk.DeferredParticles.push_back(std::make_pair(particleIndex, true));
+        }
+    });
+
+    // Merge back in chunk order so the outcome doesn't depend on how the chunks got scheduled
+    for (ParticleTravelChunk &chunk : chunks)
+    {
+        Atom::DrawQueuedTrails(chunk.Context);
+        for (const std::pair<size_t, bool> &deferredParticle : chunk.DeferredParticles)
+        {
+            MovableObject *pParticle = m_Particles[deferredParticle.first];
+            if (!deferredParticle.second)
+            {
+                pParticle->ApplyForces();
+                pParticle->PreTravel();
+            }
+            pParticle->Travel();
+            pParticle->PostTravel();
+        }
+    }
+
+    for (MovableObject *pParticle : m_Particles)
+        pParticle->NewFrame();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1641,6 +1782,8 @@ void MovableMan::OnPieMenu(Actor * pActor)
 
 void MovableMan::Update()
 {
+    PerformanceMan::ProfileZone profileZone("MovableMan::Update");
+
     // Don't update if paused
     if (g_ActivityMan.GetActivity() && g_ActivityMan.ActivityPaused())
         return;
@@ -1726,6 +1869,11 @@ void MovableMan::Update()
 
         // Travel particles
 		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS1);
+        if (m_MultithreadedParticleTravel && g_ThreadMan.GetWorkerThreadCount() > 0)
+        {
+            TravelParticlesMultithreaded();
+        }
+        else
         {
             for (parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
             {
@@ -1742,6 +1890,9 @@ void MovableMan::Update()
 		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS1);
 
         g_SceneMan.UnlockScene();
+
+        // Everything has moved, so the spatial grids need to be refilled before they're used by any proximity queries in the second pass
+        m_SpatialGridsNeedRebuild = true;
     }
 
     ////////////////////////////////////////////////////////////////////////////
@@ -1800,12 +1951,23 @@ void MovableMan::Update()
             }
         }
 		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS2);
+
+        // Calculate all the paths the Actors queued up during their updates in one go
+        if (g_SceneMan.GetScene())
+            g_SceneMan.GetScene()->ProcessPathRequests();
     }
 
     ///////////////////////////////////////////////////
     // Clear the MOID layer before starting to delete stuff which may be in the MOIDIndex
 
-    g_SceneMan.ClearAllMOIDDrawings();
+    if (m_IncrementalMOIDs)
+        EraseRemovedMOIDs();
+    else
+    {
+        g_SceneMan.ClearAllMOIDDrawings();
+        // In case the MOID layer was updated incrementally until now
+        m_MOIDLayerTracker.EraseAll();
+    }
 //    g_SceneMan.MOIDClearCheck();
 
     ///////////////////////////////////////////////////
@@ -2046,6 +2208,9 @@ void MovableMan::Update()
         if (m_SortTeamRoster[Activity::TEAM_4])
             m_ActorRoster[Activity::TEAM_4].sort(MOXPosComparison());
     }
+
+    // Actors and Items have been added, killed and deleted, so the spatial grids are out of date
+    m_SpatialGridsNeedRebuild = true;
 }
 
 
@@ -2108,6 +2273,12 @@ void MovableMan::VerifyMOIDIndex()
 
 void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
 {
+    if (m_IncrementalMOIDs)
+    {
+        UpdateDrawMOIDsIncrementally(pTargetBitmap);
+        return;
+    }
+
     int aCount = m_Actors.size();
     int iCount = m_Items.size();
     int parCount = m_Particles.size();
@@ -2158,6 +2329,79 @@ void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDrawMOIDsIncrementally
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the MOIDs of all current MOs and brings the MOID layer up to
+//                  date by only erasing and redrawing the MOs that changed since the last
+//                  update, along with whatever overlaps them.
+
+void MovableMan::UpdateDrawMOIDsIncrementally(BITMAP *pTargetBitmap)
+{
+    // Gather all the MOs that go on the MOID layer, in the same order a full redraw draws them in
+    vector<MovableObject *> rootMOs;
+    rootMOs.reserve(m_Actors.size() + m_Items.size() + m_Particles.size());
+
+    for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
+    {
+        if ((*aIt)->GetsHitByMOs() && !(*aIt)->IsSetToDelete())
+            rootMOs.push_back(*aIt);
+        else
+            (*aIt)->SetID(g_NoMOID);
+    }
+    for (deque<MovableObject *>::iterator iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt)
+    {
+        if ((*iIt)->GetsHitByMOs() && !(*iIt)->IsSetToDelete())
+            rootMOs.push_back(*iIt);
+        else
+            (*iIt)->SetID(g_NoMOID);
+    }
+    for (deque<MovableObject *>::iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
+    {
+        if ((*parIt)->GetsHitByMOs() && !(*parIt)->IsSetToDelete())
+            rootMOs.push_back(*parIt);
+        else
+            (*parIt)->SetID(g_NoMOID);
+    }
+
+    // With precise collisions, every MO that travelled erased itself from the MOID layer and drew itself again afterwards
+    m_MOIDLayerTracker.Update(pTargetBitmap, rootMOs, m_MOIDIndex, g_SettingsMan.PreciseCollisions());
+
+    if (m_ValidateMOIDs)
+    {
+        int wrongPixelCount = m_MOIDLayerTracker.Validate(rootMOs);
+        if (wrongPixelCount > 0)
+            g_ConsoleMan.PrintString("ERROR: " + std::to_string(wrongPixelCount) + " pixels of the incrementally updated MOID layer differed from a full redraw and were corrected.");
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EraseRemovedMOIDs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Erases the MOs about to be deleted or settled from the incrementally
+//                  updated MOID layer, so no MOID on it points to a deleted MO.
+
+void MovableMan::EraseRemovedMOIDs()
+{
+    for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
+    {
+        if ((*aIt)->ToDelete() || (*aIt)->ToSettle())
+            m_MOIDLayerTracker.EraseObject(*aIt);
+    }
+    for (deque<MovableObject *>::iterator iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt)
+    {
+        if ((*iIt)->ToDelete() || (*iIt)->ToSettle())
+            m_MOIDLayerTracker.EraseObject(*iIt);
+    }
+    for (deque<MovableObject *>::iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
+    {
+        if ((*parIt)->ToDelete() || (*parIt)->ToSettle())
+            m_MOIDLayerTracker.EraseObject(*parIt);
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Draw
 //////////////////////////////////////////////////////////////////////////////////////////
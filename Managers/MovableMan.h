@@ -25,6 +25,8 @@
 #include "LuaMan.h"
 #include "ActivityMan.h"
 #include "Vector.h"
+#include "SpatialPartitionGrid.h"
+#include "MOIDLayerTracker.h"
 //#include "MOPixel.h"
 //#include "AHuman.h"
 //#include "MovableObject.h"
@@ -354,6 +356,32 @@ public:
     Actor * GetClosestActor(Vector &scenePoint, int maxRadius, float &getDistance, const Actor *pExcludeThis = 0);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetActorsInRadius
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all Actors in the internal Actor list that are within a radius of
+//                  a specific scene point, taking Scene wrapping into account.
+// Arguments:       The Scene point to search around.
+//                  The radius around that scene point to search.
+//                  A vector to add all found Actors to. Ownership is NOT transferred!
+// Return value:    None.
+
+    void GetActorsInRadius(const Vector &scenePoint, float radius, std::vector<Actor *> &actorsInRadius) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetItemsInRadius
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all Items in the internal Item list that are within a radius of
+//                  a specific scene point, taking Scene wrapping into account.
+// Arguments:       The Scene point to search around.
+//                  The radius around that scene point to search.
+//                  A vector to add all found Items to. Ownership is NOT transferred!
+// Return value:    None.
+
+    void GetItemsInRadius(const Vector &scenePoint, float radius, std::vector<MovableObject *> &itemsInRadius) const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetClosestBrainActor
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -767,6 +795,19 @@ public:
     void OverrideMaterialDoors(bool enable, int team = Activity::NOTEAM);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDoorMaterialFootprints
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the areas and materials of all door material representations of a
+//                  specific team that are currently drawn into the terrain. Used for letting
+//                  pathfinding see through friendly doors without erasing them.
+// Arguments:       Which team to get the door footprints of. NOTEAM means all teams.
+//                  The vector to add the door areas and their material IDs to.
+// Return value:    None.
+
+    void GetDoorMaterialFootprints(int team, std::vector<std::pair<Box, unsigned char>> &doorFootprints) const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RegisterAlarmEvent
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -833,6 +874,74 @@ public:
     void EnableParticleSettling(bool enable = true) { m_SettlingEnabled = enable; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsMultithreadedParticleTravelEnabled
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether simple particles get their travel pass spread across
+//                  the ThreadMan worker threads.
+// Arguments:       None.
+// Return value:    Whether enabled or not.
+
+    bool IsMultithreadedParticleTravelEnabled() const { return m_MultithreadedParticleTravel; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EnableMultithreadedParticleTravel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether simple particles get their travel pass spread across
+//                  the ThreadMan worker threads.
+// Arguments:       Whether to enable or not.
+// Return value:    None.
+
+    void EnableMultithreadedParticleTravel(bool enable = true) { m_MultithreadedParticleTravel = enable; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsIncrementalMOIDsEnabled
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether the MOID layer is kept up to date by only redrawing the
+//                  MOs that changed, instead of being redrawn fully each sim update.
+// Arguments:       None.
+// Return value:    Whether enabled or not.
+
+    bool IsIncrementalMOIDsEnabled() const { return m_IncrementalMOIDs; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EnableIncrementalMOIDs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether the MOID layer is kept up to date by only redrawing the
+//                  MOs that changed, instead of being redrawn fully each sim update.
+// Arguments:       Whether to enable or not.
+// Return value:    None.
+
+    void EnableIncrementalMOIDs(bool enable = true) { m_IncrementalMOIDs = enable; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsMOIDValidationEnabled
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether the incrementally updated MOID layer gets compared
+//                  against a full redraw each sim update, reporting any differences.
+// Arguments:       None.
+// Return value:    Whether enabled or not.
+
+    bool IsMOIDValidationEnabled() const { return m_ValidateMOIDs; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EnableMOIDValidation
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether the incrementally updated MOID layer gets compared
+//                  against a full redraw each sim update, reporting any differences.
+//                  Only meant for testing, as it makes every update as slow as a full
+//                  redraw.
+// Arguments:       Whether to enable or not.
+// Return value:    None.
+
+    void EnableMOIDValidation(bool enable = true) { m_ValidateMOIDs = enable; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsMOSubtractionEnabled
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -882,6 +991,8 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Updates the MOIDs of all current MOs and draws their ID's to a BITMAP
 //                  of choice. If there are more than 255 MO's to draw, some will not be.
+//                  With incremental MOIDs enabled, only the MOs that changed since the
+//                  last call are erased and redrawn, along with whatever overlaps them.
 // Arguments:       A pointer to a BITMAP to draw on.
 // Return value:    None.
 
@@ -1049,6 +1160,21 @@ protected:
     bool m_SettlingEnabled;
     // Whtehr MO's vcanng et subtracted form the terrain at all
     bool m_MOSubtractionEnabled;
+    // Whether the travel pass of simple particles is spread across the ThreadMan worker threads
+    bool m_MultithreadedParticleTravel;
+    // Whether the MOID layer is kept up to date by only redrawing the MOs that changed
+    bool m_IncrementalMOIDs;
+    // Whether the incrementally updated MOID layer gets compared against a full redraw each update
+    bool m_ValidateMOIDs;
+    // What's on the MOID layer and which MOIDs each MO has, when the MOID layer is updated incrementally
+    MOIDLayerTracker m_MOIDLayerTracker;
+
+    // Spatial grids of the Actors and Items for the closest and in-radius queries, so they don't have to go through every one of them.
+    // Rebuilt lazily on the first query after anything moved or the lists changed, which is why they can be touched by const queries.
+    mutable SpatialPartitionGrid m_ActorGrid;
+    mutable SpatialPartitionGrid m_ItemGrid;
+    // Whether the spatial grids are out of date with the Actor and Item lists or their positions
+    mutable bool m_SpatialGridsNeedRebuild;
 
 	unsigned int m_SimUpdateFrameNumber;
 
@@ -1072,6 +1198,70 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TravelParticlesMultithreaded
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Does the first pass travel of all particles, spreading the ones that
+//                  only need to read the Scene across the ThreadMan worker threads. Any
+//                  particle that needs to write to the Scene or hit other MOs is deferred
+//                  and travelled serially afterwards, in list order.
+// Arguments:       None.
+// Return value:    None.
+
+    void TravelParticlesMultithreaded();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDrawMOIDsIncrementally
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the MOIDs of all current MOs and brings the MOID layer up to
+//                  date by only erasing and redrawing the MOs that changed since the last
+//                  update, along with whatever overlaps them. The MOs keep their MOIDs
+//                  between updates as long as they're around.
+// Arguments:       A pointer to the MOID layer BITMAP to update.
+// Return value:    None.
+
+    void UpdateDrawMOIDsIncrementally(BITMAP *pTargetBitmap);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EraseRemovedMOIDs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Erases the MOs about to be deleted or settled from the incrementally
+//                  updated MOID layer, so no MOID on it points to a deleted MO.
+// Arguments:       None.
+// Return value:    None.
+
+    void EraseRemovedMOIDs();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateSpatialGrids
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Refills the Actor and Item spatial grids if they are out of date.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateSpatialGrids() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FindClosestActor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds the Actor closest to a scene point out of the ones that pass a
+//                  filter, using the Actor spatial grid.
+// Arguments:       The Scene point to search for the closest to.
+//                  Only Actors strictly closer than this are considered.
+//                  Whether to also consider the Actors added this frame, like the team
+//                  rosters do.
+//                  Returns whether an Actor should be considered.
+//                  A vector to be filled out with the distance from the returned closest
+//                  to the search point. Will be unaltered if no Actor was found.
+// Return value:    The closest Actor that passed the filter, or 0 if none did.
+
+    Actor * FindClosestActor(const Vector &scenePoint, float maxDistance, bool includeAddedActors, const std::function<bool(const Actor *)> &actorFilter, Vector &getDistance) const;
+
+
     // Disallow the use of some implicit methods.
     MovableMan(const MovableMan &reference);
     MovableMan & operator=(const MovableMan &rhs);
@@ -888,7 +888,8 @@ namespace RTE
 		m_ReceivedData += frameData->DataSize;
 		m_CompressedData += frameData->UncompressedSize;
 
-		if (bpx + maxWidth - 1 < bmp->w && bpy + maxHeight - 1 < bmp->h && bpx >= 0 && bpy >= 0)
+		// The server may only send the boxes that changed since it last sent them, so this bitmap is kept between frames and only patched where boxes arrive
+		if (bpx + maxWidth - 1 < bmp->w && bpy + maxHeight - 1 < bmp->h && bpx >= 0 && bpy >= 0 && maxWidth * maxHeight == frameData->UncompressedSize && frameData->UncompressedSize <= MAX_PIXEL_LINE_BUFFER_SIZE)
 		{
 			// Unpack box
 			if (frameData->DataSize == 0)
@@ -898,10 +899,18 @@ namespace RTE
 			}
 			else
 			{
+				int unpackedSize = size;
 				if (frameData->DataSize == frameData->UncompressedSize)
-					memcpy_s(m_aPixelLineBuffer, size, p->data + sizeof(MsgFrameBox), size);
+					memcpy_s(m_aPixelLineBuffer, MAX_PIXEL_LINE_BUFFER_SIZE, p->data + sizeof(MsgFrameBox), size);
 				else
-					LZ4_decompress_safe((char *)(p->data + sizeof(MsgFrameBox)), (char *)(m_aPixelLineBuffer), size, frameData->UncompressedSize);
+					unpackedSize = LZ4_decompress_safe((char *)(p->data + sizeof(MsgFrameBox)), (char *)(m_aPixelLineBuffer), size, frameData->UncompressedSize);
+
+				// Leave the retained box as it was rather than patch garbage into it, the next keyframe will bring it up to date
+				if (unpackedSize != frameData->UncompressedSize)
+				{
+					release_bitmap(bmp);
+					return;
+				}
 
 				// Copy box to bitmap line by line
 				unsigned char * lineAddr = m_aPixelLineBuffer;
@@ -29,6 +29,7 @@
 #include "Scene.h"
 #include "SLTerrain.h"
 #include "TimerMan.h"
+#include "PerformanceMan.h"
 #include "AudioMan.h"
 #include "GameActivity.h"
 
@@ -45,6 +46,8 @@ namespace RTE
 
 	void BackgroundSendThreadFunction(NetworkServer * ns, int player)
 	{
+		g_PerformanceMan.SetTraceThreadName("Network Send Thread " + std::to_string(player));
+
 		while (ns->IsServerModeEnabled() && ns->IsPlayerConnected(player))
 		{
 			if (ns->NeedToSendSceneSetupData(player) && ns->IsSceneAvailable(player))
@@ -133,6 +136,20 @@ namespace RTE
 
 			m_FrameNumbers[i] = 0;
 
+			m_TerrainChangesOverflowed[i] = false;
+			m_TerrainTileCountX[i] = 0;
+			m_TerrainTileCountY[i] = 0;
+			for (int layer = 0; layer < 2; layer++)
+			{
+				m_DirtyTerrainTiles[i][layer].clear();
+				m_DirtyTerrainTileList[i][layer].clear();
+			}
+
+			m_FramesSinceKeyFrame[i] = 0;
+			m_SendKeyFrame[i] = true;
+			m_BoxHashes[i][0].clear();
+			m_BoxHashes[i][1].clear();
+
 			m_Ping[i] = 0;
 			m_PingTimer[i].Reset();
 
@@ -152,6 +169,8 @@ namespace RTE
 				m_PostEffectDataSentCurrent[i][j] = 0;
 				m_SoundDataSentCurrent[i][j] = 0;
 				m_TerrainDataSentCurrent[i][j] = 0;
+				m_TerrainChangesCurrent[i][j] = 0;
+				m_TerrainPatchesSentCurrent[i][j] = 0;
 				m_OtherDataSentCurrent[i][j] = 0;
 			}
 
@@ -168,6 +187,7 @@ namespace RTE
 
 			m_EmptyBlocks[i] = 0;
 			m_FullBlocks[i] = 0;
+			m_UnchangedBlocks[i] = 0;
 		}
 
 		m_UseHighCompression = true;
@@ -181,6 +201,8 @@ namespace RTE
 		m_TransmitAsBoxes = true;
 		m_BoxWidth = 32;
 		m_BoxHeight = 44;
+		m_UseDeltaCompression = true;
+		m_DeltaKeyFrameInterval = 30;
 		m_NatServerConnected = false;
 		m_LastPackedReceived.Reset();
 	}
@@ -205,6 +227,8 @@ namespace RTE
 
 			m_pLZ4CompressionState[i] = malloc(LZ4_sizeofStateHC());
 			m_pLZ4FastCompressionState[i] = malloc(LZ4_sizeofState());
+
+			m_PendingTerrainChanges[i].Create(16384);
 		}
 
 		m_UseHighCompression = g_SettingsMan.GetServerUseHighCompression();
@@ -217,6 +241,8 @@ namespace RTE
 		m_TransmitAsBoxes = g_SettingsMan.GetServerTransmitAsBoxes();
 		m_BoxWidth = g_SettingsMan.GetServerBoxWidth();
 		m_BoxHeight = g_SettingsMan.GetServerBoxHeight();
+		m_UseDeltaCompression = g_SettingsMan.GetServerUseDeltaCompression();
+		m_DeltaKeyFrameInterval = g_SettingsMan.GetServerDeltaKeyFrameInterval();
 
 		return 0;
 	}
@@ -235,6 +261,8 @@ namespace RTE
 			m_PostEffectDataSentCurrent[player][STAT_SHOWN] = m_PostEffectDataSentCurrent[player][STAT_CURRENT];
 			m_SoundDataSentCurrent[player][STAT_SHOWN] = m_SoundDataSentCurrent[player][STAT_CURRENT];
 			m_TerrainDataSentCurrent[player][STAT_SHOWN] = m_TerrainDataSentCurrent[player][STAT_CURRENT];
+			m_TerrainChangesCurrent[player][STAT_SHOWN] = m_TerrainChangesCurrent[player][STAT_CURRENT];
+			m_TerrainPatchesSentCurrent[player][STAT_SHOWN] = m_TerrainPatchesSentCurrent[player][STAT_CURRENT];
 			m_OtherDataSentCurrent[player][STAT_SHOWN] = m_OtherDataSentCurrent[player][STAT_CURRENT];
 
 			m_DataUncompressedCurrent[player][STAT_CURRENT] = 0;
@@ -243,6 +271,8 @@ namespace RTE
 			m_PostEffectDataSentCurrent[player][STAT_CURRENT] = 0;
 			m_SoundDataSentCurrent[player][STAT_CURRENT] = 0;
 			m_TerrainDataSentCurrent[player][STAT_CURRENT] = 0;
+			m_TerrainChangesCurrent[player][STAT_CURRENT] = 0;
+			m_TerrainPatchesSentCurrent[player][STAT_CURRENT] = 0;
 			m_OtherDataSentCurrent[player][STAT_CURRENT] = 0;
 		}
 
@@ -578,7 +608,7 @@ namespace RTE
 		guid += GetServerGuid().ToString();
 		g_FrameMan.GetLargeFont()->DrawAligned(&pGUIBitmap, midX, 5, guid, GUIFont::Centre);
 
-		char buf[256];
+		char buf[512];
 
 		if (m_NatServerConnected)
 		{
@@ -612,6 +642,8 @@ namespace RTE
 		m_DataSentCurrent[STATS_SUM][STAT_SHOWN] = 0;
 		m_FrameDataSentCurrent[STATS_SUM][STAT_SHOWN] = 0;
 		m_TerrainDataSentCurrent[STATS_SUM][STAT_SHOWN] = 0;
+		m_TerrainChangesCurrent[STATS_SUM][STAT_SHOWN] = 0;
+		m_TerrainPatchesSentCurrent[STATS_SUM][STAT_SHOWN] = 0;
 		m_OtherDataSentCurrent[STATS_SUM][STAT_SHOWN] = 0;
 
 		m_FrameDataSentTotal[STATS_SUM] = 0;
@@ -626,6 +658,7 @@ namespace RTE
 
 		m_FullBlocks[STATS_SUM] = 0;
 		m_EmptyBlocks[STATS_SUM] = 0;
+		m_UnchangedBlocks[STATS_SUM] = 0;
 
 
 		for (int i = 0; i < MAX_STAT_RECORDS; i++)
@@ -640,6 +673,8 @@ namespace RTE
 				m_DataSentCurrent[STATS_SUM][STAT_SHOWN] += m_DataSentCurrent[i][STAT_SHOWN];
 				m_FrameDataSentCurrent[STATS_SUM][STAT_SHOWN] += m_FrameDataSentCurrent[i][STAT_SHOWN];
 				m_TerrainDataSentCurrent[STATS_SUM][STAT_SHOWN] += m_TerrainDataSentCurrent[i][STAT_SHOWN];
+				m_TerrainChangesCurrent[STATS_SUM][STAT_SHOWN] += m_TerrainChangesCurrent[i][STAT_SHOWN];
+				m_TerrainPatchesSentCurrent[STATS_SUM][STAT_SHOWN] += m_TerrainPatchesSentCurrent[i][STAT_SHOWN];
 				m_OtherDataSentCurrent[STATS_SUM][STAT_SHOWN] += m_OtherDataSentCurrent[i][STAT_SHOWN];
 
 				m_FrameDataSentTotal[STATS_SUM] += m_FrameDataSentTotal[i];
@@ -654,6 +689,7 @@ namespace RTE
 
 				m_FullBlocks[STATS_SUM] += m_FullBlocks[i];
 				m_EmptyBlocks[STATS_SUM] += m_EmptyBlocks[i];
+				m_UnchangedBlocks[STATS_SUM] += m_UnchangedBlocks[i];
 			}
 
 			// Update compression ratio
@@ -664,7 +700,7 @@ namespace RTE
 			if (m_MsecPerFrame[i] > 0)
 				fps = 1000 / m_MsecPerFrame[i];
 
-			sprintf_s(buf, sizeof(buf), "%s\nPing %u\nCmp Mbit: %.1f\nUnc Mbit: %.1f\nR: %.2f\nFrame Kbit: %lu\nGlow Kbit: %lu\nSound Kbit: %lu\nScene Kbit: %lu\nFrames sent: %uK\nFrame skipped: %uK\nBlocks full: %uK\nBlocks empty: %uK\nBlk Ratio: %.2f\nFPS: %d\nSend Ms %d\nTotal Data %lu MB",
+			sprintf_s(buf, sizeof(buf), "%s\nPing %u\nCmp Mbit: %.1f\nUnc Mbit: %.1f\nR: %.2f\nFrame Kbit: %lu\nGlow Kbit: %lu\nSound Kbit: %lu\nScene Kbit: %lu\nTerrain chg/s: %lu\nTerrain pkt/s: %lu\nFrames sent: %uK\nFrame skipped: %uK\nBlocks full: %uK\nBlocks empty: %uK\nBlocks unchanged: %uK\nBlk Ratio: %.2f\nFPS: %d\nSend Ms %d\nTotal Data %lu MB",
 				i == STATS_SUM ? "- TOTALS - " : IsPlayerConnected(i) ? GetPlayerName(i).c_str() : "- NO PLAYER -",
 				i < c_MaxClients ? m_Ping[i] : 0,
 				(double)m_DataSentCurrent[i][STAT_SHOWN] / (125000),
@@ -674,10 +710,13 @@ namespace RTE
 				m_PostEffectDataSentCurrent[i][STAT_SHOWN] / (125),
 				m_SoundDataSentCurrent[i][STAT_SHOWN] / (125),
 				m_TerrainDataSentCurrent[i][STAT_SHOWN] / (125),
+				m_TerrainChangesCurrent[i][STAT_SHOWN],
+				m_TerrainPatchesSentCurrent[i][STAT_SHOWN],
 				m_FramesSent[i] / 1000,
 				m_FramesSkipped[i] / 1000,
 				m_FullBlocks[i] / 1000,
 				m_EmptyBlocks[i] / 1000,
+				m_UnchangedBlocks[i] / 1000,
 				emptyRatio,
 				i < c_MaxClients ? fps : 0,
 				i < c_MaxClients ? m_MsecPerSendCall[i] : 0,
@@ -717,6 +756,11 @@ namespace RTE
 	{
 		m_pBackBuffer8[player] = create_bitmap_ex(8, w, h);
 		m_pBackBufferGUI8[player] = create_bitmap_ex(8, w, h);
+
+		// Whatever the client has retained no longer lines up with the new buffer size, so start over with a keyframe
+		m_BoxHashes[player][0].clear();
+		m_BoxHashes[player][1].clear();
+		m_SendKeyFrame[player] = true;
 	}
 
 	void NetworkServer::DestroyBackBuffer(int player)
@@ -730,6 +774,25 @@ namespace RTE
 		m_pBackBufferGUI8[player] = 0;
 	}
 
+	size_t NetworkServer::GetBoxHash(const unsigned char * boxData, int size) const
+	{
+		// FNV-1a over whole words where possible, it only needs to tell apart consecutive contents of the same box so collisions aren't a concern
+		const size_t fnvPrime = sizeof(size_t) == 8 ? static_cast<size_t>(1099511628211ULL) : static_cast<size_t>(16777619U);
+		size_t hash = sizeof(size_t) == 8 ? static_cast<size_t>(14695981039346656037ULL) : static_cast<size_t>(2166136261U);
+
+		int counter = 0;
+		for (; counter + static_cast<int>(sizeof(size_t)) <= size; counter += sizeof(size_t))
+		{
+			size_t word;
+			memcpy(&word, boxData + counter, sizeof(size_t));
+			hash = (hash ^ word) * fnvPrime;
+		}
+		for (; counter < size; counter++)
+			hash = (hash ^ boxData[counter]) * fnvPrime;
+
+		return hash;
+	}
+
 	void NetworkServer::SendSceneSetupData(int player)
 	{
 		RTE::MsgSceneSetup msgSceneSetup;
@@ -839,79 +902,145 @@ namespace RTE
 		{
 			for (int p = 0; p < c_MaxClients; p++)
 			{
-				if (IsPlayerConnected(p))
-				{
-					m_Mutex[p].lock();
-					m_PendingTerrainChanges[p].push(tc);
-					m_Mutex[p].unlock();
-				}
+				if (IsPlayerConnected(p) && !m_PendingTerrainChanges[p].Push(tc))
+					m_TerrainChangesOverflowed[p].store(true, std::memory_order_release);
 			}
 		}
 	}
 
 	bool NetworkServer::NeedToProcessTerrainChanges(int player)
 	{
-		bool result;
-
-		m_Mutex[player].lock();
-		result = !m_PendingTerrainChanges[player].empty();
-		m_Mutex[player].unlock();
-
-		return result;
+		return !m_PendingTerrainChanges[player].IsEmpty() || m_TerrainChangesOverflowed[player].load(std::memory_order_acquire);
 	}
 
 	void NetworkServer::ProcessTerrainChanges(int player)
 	{
-		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty())
+		if (!NeedToProcessTerrainChanges(player))
+			return;
+
+		SceneMan::TerrainChange tc;
+
+		Scene * pScene = g_SceneMan.GetScene();
+		if (!pScene || !pScene->GetTerrain())
 		{
-			m_CurrentTerrainChanges[player].push(m_PendingTerrainChanges[player].front());
-			m_PendingTerrainChanges[player].pop();
+			while (m_PendingTerrainChanges[player].Pop(tc)) {}
+			m_TerrainChangesOverflowed[player].store(false, std::memory_order_release);
+			return;
 		}
-		m_Mutex[player].unlock();
 
-		while (!m_CurrentTerrainChanges[player].empty())
+		// Start over with clean tiles if the scene size changed since the last tick
+		int tileCountX = (g_SceneMan.GetSceneWidth() + c_TerrainTileSize - 1) / c_TerrainTileSize;
+		int tileCountY = (g_SceneMan.GetSceneHeight() + c_TerrainTileSize - 1) / c_TerrainTileSize;
+		if (m_TerrainTileCountX[player] != tileCountX || m_TerrainTileCountY[player] != tileCountY)
 		{
-			int maxSize = 1280;
-
-			SceneMan::TerrainChange tc = m_CurrentTerrainChanges[player].front();
-			m_CurrentTerrainChanges[player].pop();
+			m_TerrainTileCountX[player] = tileCountX;
+			m_TerrainTileCountY[player] = tileCountY;
+			for (int layer = 0; layer < 2; layer++)
+			{
+				m_DirtyTerrainTiles[player][layer].assign(tileCountX * tileCountY, false);
+				m_DirtyTerrainTileList[player][layer].clear();
+			}
+		}
 
-			// Fragment region if it does not fit one packet
-			if (tc.w * tc.h > maxSize)
+		// Some changes didn't make it into the queue, and there's no telling where they were, so all tiles have to be sent again.
+		// The flag is cleared before draining the queue, so changes that overflow while draining are caught on the next tick
+		if (m_TerrainChangesOverflowed[player].exchange(false, std::memory_order_acq_rel))
+		{
+			SceneMan::TerrainChange wholeScene;
+			wholeScene.x = 0;
+			wholeScene.y = 0;
+			wholeScene.w = g_SceneMan.GetSceneWidth();
+			wholeScene.h = g_SceneMan.GetSceneHeight();
+			wholeScene.color = 0;
+			for (int layer = 0; layer < 2; layer++)
 			{
-				int size = 0;
-				int height = 1;
-				int heightStart = 0;
+				wholeScene.back = layer == 1;
+				MarkTerrainTilesDirty(player, wholeScene);
+			}
+		}
 
-				for (int y = 0; y < tc.h; y++)
-				{
-					height++;
-					size += tc.w;
+		// Any number of changes to the same tile since the last tick end up as a single patch of its current contents
+		while (m_PendingTerrainChanges[player].Pop(tc))
+		{
+			MarkTerrainTilesDirty(player, tc);
+			m_TerrainChangesCurrent[player][STAT_CURRENT]++;
+		}
 
-					// Store changed block if the size is over the MTU or if it's the last block.
-					if (size + tc.w >= maxSize || y == tc.h - 1)
-					{
-						SceneMan::TerrainChange tcf;
-						tcf.x = tc.x;
-						tcf.y = tc.y + heightStart;
-						tcf.w = tc.w;
-						tcf.h = height;
-						tcf.back = tc.back;
-						tcf.color = tc.color;
-
-						SendTerrainChangeMsg(player, tcf);
-
-						size = 0;
-						heightStart = y;
-						height = 1;
-					}
+		SendDirtyTerrainTiles(player);
+	}
+
+	void NetworkServer::MarkTerrainTilesDirty(int player, const SceneMan::TerrainChange &tc)
+	{
+		int left = std::max(tc.x, 0);
+		int top = std::max(tc.y, 0);
+		int right = std::min(tc.x + tc.w, g_SceneMan.GetSceneWidth()) - 1;
+		int bottom = std::min(tc.y + tc.h, g_SceneMan.GetSceneHeight()) - 1;
+		if (right < left || bottom < top)
+			return;
+
+		int layer = tc.back ? 1 : 0;
+		std::vector<bool> &dirtyTiles = m_DirtyTerrainTiles[player][layer];
+
+		for (int tileY = top / c_TerrainTileSize; tileY <= bottom / c_TerrainTileSize; tileY++)
+		{
+			for (int tileX = left / c_TerrainTileSize; tileX <= right / c_TerrainTileSize; tileX++)
+			{
+				int tileIndex = tileY * m_TerrainTileCountX[player] + tileX;
+				if (!dirtyTiles[tileIndex])
+				{
+					dirtyTiles[tileIndex] = true;
+					m_DirtyTerrainTileList[player][layer].push_back(tileIndex);
 				}
 			}
-			else 
+		}
+	}
+
+	void NetworkServer::SendDirtyTerrainTiles(int player)
+	{
+		// Keep patches under the MTU like the old fragmenting did, which fits a handful of tiles side by side
+		int maxSize = 1280;
+		int maxTilesPerPatch = std::max(1, maxSize / (c_TerrainTileSize * c_TerrainTileSize));
+
+		SLTerrain * pTerrain = g_SceneMan.GetScene()->GetTerrain();
+
+		for (int layer = 0; layer < 2; layer++)
+		{
+			std::vector<int> &dirtyTileList = m_DirtyTerrainTileList[player][layer];
+			if (dirtyTileList.empty())
+				continue;
+
+			BITMAP * bmp = layer == 1 ? pTerrain->GetBGColorBitmap() : pTerrain->GetFGColorBitmap();
+
+			// Sorting puts the tiles of a row next to each other, so runs of dirty tiles can be sent as one patch
+			std::sort(dirtyTileList.begin(), dirtyTileList.end());
+
+			for (size_t i = 0; i < dirtyTileList.size();)
 			{
-				SendTerrainChangeMsg(player, tc);
+				int firstTile = dirtyTileList[i];
+				int tileX = firstTile % m_TerrainTileCountX[player];
+				int tileY = firstTile / m_TerrainTileCountX[player];
+
+				int runLength = 1;
+				while (i + runLength < dirtyTileList.size() && runLength < maxTilesPerPatch && tileX + runLength < m_TerrainTileCountX[player] && dirtyTileList[i + runLength] == firstTile + runLength)
+					runLength++;
+
+				SceneMan::TerrainChange patch;
+				patch.x = tileX * c_TerrainTileSize;
+				patch.y = tileY * c_TerrainTileSize;
+				patch.w = std::min(runLength * c_TerrainTileSize, bmp->w - patch.x);
+				patch.h = std::min(c_TerrainTileSize, bmp->h - patch.y);
+				patch.back = layer == 1;
+				// Only used if the patch ends up a single pixel at the scene edge, which is sent without any bitmap data
+				patch.color = _getpixel(bmp, patch.x, patch.y);
+
+				SendTerrainChangeMsg(player, patch);
+				m_TerrainPatchesSentCurrent[player][STAT_CURRENT]++;
+
+				for (int tile = 0; tile < runLength; tile++)
+					m_DirtyTerrainTiles[player][layer][firstTile + tile] = false;
+				i += runLength;
 			}
+			dirtyTileList.clear();
 		}
 	}
 
@@ -1004,12 +1133,16 @@ namespace RTE
 
 	void NetworkServer::ClearTerrainChangeQueue(int player)
 	{
-		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty())
-			m_PendingTerrainChanges[player].pop();
-		while (!m_CurrentTerrainChanges[player].empty())
-			m_CurrentTerrainChanges[player].pop();
-		m_Mutex[player].unlock();
+		SceneMan::TerrainChange tc;
+		while (m_PendingTerrainChanges[player].Pop(tc)) {}
+		m_TerrainChangesOverflowed[player].store(false, std::memory_order_release);
+
+		// The whole scene is about to be sent anyway
+		for (int layer = 0; layer < 2; layer++)
+		{
+			std::fill(m_DirtyTerrainTiles[player][layer].begin(), m_DirtyTerrainTiles[player][layer].end(), false);
+			m_DirtyTerrainTileList[player][layer].clear();
+		}
 	}
 
 
@@ -1138,7 +1271,11 @@ namespace RTE
 	{
 		for (int player = 0; player < c_MaxClients; player++)
 			if (m_ClientConnections[player].ClientId == p->systemAddress)
+			{
+				// The client just loaded a new scene and cleared what it had retained, so it needs a full frame
+				m_SendKeyFrame[player] = true;
 				m_SendFrameData[player] = true;
+			}
 	}
 
 	void NetworkServer::SendPostEffectData(int player)
@@ -1380,6 +1517,8 @@ namespace RTE
 
 	int NetworkServer::SendFrame(int player)
 	{
+		PerformanceMan::ProfileZone profileZone("NetworkServer::SendFrame");
+
 		// Calc timing stuff
 		int64_t currentTicks = g_TimerMan.GetRealTickCount();
 		double fps = (double)m_EncodingFps;
@@ -1488,12 +1627,35 @@ namespace RTE
 			int bw = m_pBackBuffer8[player]->w / m_BoxWidth;
 			int bh = m_pBackBuffer8[player]->h / m_BoxHeight;
 
+			// Keyframes send every box regardless of whether it changed, so whatever the client missed since the last one gets repaired
+			bool sendKeyFrame = m_SendKeyFrame[player] || m_FramesSinceKeyFrame[player] >= m_DeltaKeyFrameInterval;
+			if (sendKeyFrame)
+			{
+				m_SendKeyFrame[player] = false;
+				m_FramesSinceKeyFrame[player] = 0;
+			}
+			else
+			{
+				m_FramesSinceKeyFrame[player]++;
+			}
+
+			int boxCount = (bw + 1) * (bh + 1);
+			for (int layer = 0; layer < 2; layer++)
+			{
+				if (static_cast<int>(m_BoxHashes[player][layer].size()) != boxCount)
+				{
+					m_BoxHashes[player][layer].assign(boxCount, 0);
+					sendKeyFrame = true;
+				}
+			}
+
 			for (int by = 0; by <= bh; by++)
 			{
 				int step = 1;
 				int startLine = 0;
 
-				if (m_UseInterlacing)
+				// Keyframes go out whole even when interlacing, or half of the boxes would miss out until the next one
+				if (m_UseInterlacing && !(m_UseDeltaCompression && sendKeyFrame))
 				{
 					step = 2;
 					if (m_SendEven[player])
@@ -1515,27 +1677,29 @@ namespace RTE
 
 					int maxWidth = m_BoxWidth;
 					if (bpx + m_BoxWidth >= m_pBackBuffer8[player]->w)
-					{
 						maxWidth = m_pBackBuffer8[player]->w - bpx;
-						frameData->BoxWidth = maxWidth;
-					}
 
 					int maxHeight = m_BoxHeight;
 					if (bpy + m_BoxHeight >= m_pBackBuffer8[player]->h)
-					{
 						maxHeight = m_pBackBuffer8[player]->h - bpy;
-						frameData->BoxHeight = maxHeight;
-					}
+
+					// Set for every box, otherwise a box clipped at the right edge would leave its narrower width on the first box of the next row
+					frameData->BoxWidth = maxWidth;
+					frameData->BoxHeight = maxHeight;
+
+					int boxIndex = by * (bw + 1) + bx;
 
 					int size = maxWidth * maxHeight;
 					frameData->UncompressedSize = size;
-					frameData->DataSize = size;
 
 					for (int layer = 0; layer < 2; layer++)
 					{
 						bool boxIsEmpty = true;
 						int line = 0;
 
+						// Reset per layer, the previous layer may have left its compressed size here
+						frameData->DataSize = size;
+
 						BITMAP * backBuffer = 0;
 						if (layer == 0)
 							backBuffer = m_pBackBuffer8[player];
@@ -1553,6 +1717,19 @@ namespace RTE
 							memcpy(pDest, backBuffer->line[bpy + line] + bpx, maxWidth);
 							pDest += maxWidth;
 						}
+
+						// Skip boxes the client already has, which is most of the screen when the view is still and saves compressing them all over again
+						if (m_UseDeltaCompression)
+						{
+							size_t boxHash = GetBoxHash(m_aTerrainChangeBuffer[player], size);
+							if (!sendKeyFrame && m_BoxHashes[player][layer][boxIndex] == boxHash)
+							{
+								m_UnchangedBlocks[player]++;
+								continue;
+							}
+							m_BoxHashes[player][layer][boxIndex] = boxHash;
+						}
+
 						// Check if block is empty
 						unsigned long int * pixelInt = (unsigned long int *)m_aTerrainChangeBuffer[player];
 						int counter = 0;
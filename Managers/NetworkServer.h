@@ -15,6 +15,7 @@
 #include "Singleton.h"
 #include "UInputMan.h"
 #include "SceneMan.h"
+#include "SPSCQueue.h"
 
 #include "Network.h"
 #include "NetworkClient.h"
@@ -200,12 +201,18 @@ namespace RTE
 
 		void ProcessTerrainChanges(int player);
 
+		void MarkTerrainTilesDirty(int player, const SceneMan::TerrainChange &tc);
+
+		void SendDirtyTerrainTiles(int player);
+
 		void SendTerrainChangeMsg(int player, SceneMan::TerrainChange tc);
 
 		bool ReadyForSimulation();
 
 		void SetInterlacingMode(bool newMode) { m_UseInterlacing = newMode; }
 
+		void SetDeltaCompressionMode(bool newMode) { m_UseDeltaCompression = newMode; }
+
 		void SendNATServerRegistrationMsg(RakNet::SystemAddress addr);
 
 		void ClearInputMessages(int player);
@@ -228,6 +235,8 @@ namespace RTE
 
 		void LockScene(bool isLocked);
 
+		size_t GetBoxHash(const unsigned char * boxData, int size) const;
+
 		unsigned int GetPing(int player) const { return m_Ping[player]; }
 
 		//////////////////////////////////////////////////////////////////////////////////////////
@@ -294,6 +303,9 @@ namespace RTE
 		unsigned long int m_TerrainDataSentCurrent[MAX_STAT_RECORDS][2];
 		unsigned long int m_TerrainDataSentTotal[MAX_STAT_RECORDS];
 
+		unsigned long int m_TerrainChangesCurrent[MAX_STAT_RECORDS][2];
+		unsigned long int m_TerrainPatchesSentCurrent[MAX_STAT_RECORDS][2];
+
 		unsigned long int m_OtherDataSentCurrent[MAX_STAT_RECORDS][2];
 		unsigned long int m_OtherDataSentTotal[MAX_STAT_RECORDS];
 
@@ -302,6 +314,8 @@ namespace RTE
 
 		int m_FullBlocks[MAX_STAT_RECORDS];
 
+		int m_UnchangedBlocks[MAX_STAT_RECORDS];
+
 		int m_SendBufferBytes[MAX_STAT_RECORDS];
 
 		int m_SendBufferMessages[MAX_STAT_RECORDS];
@@ -360,11 +374,17 @@ namespace RTE
 		bool m_SendFrameData[c_MaxClients];
 		std::mutex m_SceneLock[c_MaxClients];
 
-		std::queue<SceneMan::TerrainChange> m_PendingTerrainChanges[c_MaxClients];
+		// Terrain changes are handed from the sim thread to each player's send thread without locking, so the sim never waits on the network.
+		// If a player's queue fills up before its send thread gets to it, the changes that didn't fit are lost and the whole terrain is sent to that player again instead
+		SPSCQueue<SceneMan::TerrainChange> m_PendingTerrainChanges[c_MaxClients];
+		std::atomic<bool> m_TerrainChangesOverflowed[c_MaxClients];
 
-		std::queue<SceneMan::TerrainChange> m_CurrentTerrainChanges[c_MaxClients];
-
-		std::mutex m_Mutex[c_MaxClients];
+		// Terrain changes are gathered into dirty tiles per player and layer, then sent as merged patches once per network tick instead of as one message per change
+		static const int c_TerrainTileSize = 16;
+		int m_TerrainTileCountX[c_MaxClients];
+		int m_TerrainTileCountY[c_MaxClients];
+		std::vector<bool> m_DirtyTerrainTiles[c_MaxClients][2];
+		std::vector<int> m_DirtyTerrainTileList[c_MaxClients][2];
 
 		//std::mutex m_InputQueueMutex[c_MaxClients];
 		std::queue<NetworkClient::MsgInput>m_InputMessages[c_MaxClients];
@@ -390,6 +410,13 @@ namespace RTE
 		int m_BoxWidth;
 		int m_BoxHeight;
 
+		// Only transmit boxes whose contents changed since they were last sent, with a full keyframe every m_DeltaKeyFrameInterval frames to repair boxes the client never received
+		bool m_UseDeltaCompression;
+		int m_DeltaKeyFrameInterval;
+		int m_FramesSinceKeyFrame[c_MaxClients];
+		bool m_SendKeyFrame[c_MaxClients];
+		std::vector<size_t> m_BoxHashes[c_MaxClients][2];
+
 		bool m_NatServerConnected;
 
 		RakNet::SystemAddress m_NATServiceServerID;
@@ -2,6 +2,8 @@
 #include "MovableMan.h"
 #include "FrameMan.h"
 #include "AudioMan.h"
+#include "PostProcessMan.h"
+#include "ConsoleMan.h"
 #include "Timer.h"
 
 #include "GUI.h"
@@ -11,6 +13,11 @@ namespace RTE {
 
 	const std::string PerformanceMan::c_ClassName = "PerformanceMan";
 
+	std::atomic<unsigned int> PerformanceMan::s_ThreadTraceListNumber(0);
+	thread_local PerformanceMan::ThreadTrace *PerformanceMan::s_ThreadTrace = nullptr;
+	thread_local unsigned int PerformanceMan::s_ThreadTraceNumber = 0;
+	thread_local std::string PerformanceMan::s_ThreadTraceName;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::Clear() {
@@ -21,6 +28,9 @@ namespace RTE {
 		m_MSPFs.clear();
 		m_MSPFAverage = 0;
 		m_SimSpeed = 1.0;
+		m_CapturingTrace.store(false);
+		m_TraceCaptureNumber.store(0);
+		m_ThreadTraces.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +45,8 @@ namespace RTE {
 			m_PerfMeasureStart[counter] = 0;
 			m_PerfMeasureStop[counter] = 0;
 		}
+		std::fill_n(m_ScriptInvocations, c_MaxSamples, 0);
+		std::fill_n(m_UncompiledScriptInvocations, c_MaxSamples, 0);
 
 		// Set up performance counter's names
 		m_PerfCounterNames[PERF_SIM_TOTAL] = "Total";
@@ -51,8 +63,14 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::Destroy() {
+		StopBenchmarkRecording();
+		StopTraceCapture();
 		delete m_FrameTimer;
-		Clear();
+		{
+			std::lock_guard<std::mutex> threadTracesLock(m_ThreadTracesMutex);
+			Clear();
+			s_ThreadTraceListNumber++;
+		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -114,6 +132,180 @@ namespace RTE {
 			m_PerfData[counter][m_Sample] = 0;
 			m_PerfPercentages[counter][m_Sample] = 0;
 		}
+		m_ScriptInvocations[m_Sample] = 0;
+		m_UncompiledScriptInvocations[m_Sample] = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PerformanceMan::StartBenchmarkRecording(const std::string &fileName) {
+		StopBenchmarkRecording();
+		m_BenchmarkFile.open(fileName, std::ios_base::out | std::ios_base::trunc);
+		if (!m_BenchmarkFile.is_open()) {
+			return false;
+		}
+		m_BenchmarkFile << "Frame,Frame Time";
+		for (unsigned short counter = 0; counter < PERF_COUNT; ++counter) {
+			m_BenchmarkFile << "," << m_PerfCounterNames[counter];
+		}
+		m_BenchmarkFile << ",Script Calls,Uncompiled Script Calls,Particles,Objects,MOIDs\n";
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::RecordBenchmarkSample(unsigned int frameNumber, unsigned long long frameTime) {
+		if (!m_BenchmarkFile.is_open()) {
+			return;
+		}
+		m_BenchmarkFile << frameNumber << "," << frameTime;
+		for (unsigned short counter = 0; counter < PERF_COUNT; ++counter) {
+			m_BenchmarkFile << "," << m_PerfData[counter][m_Sample];
+		}
+		m_BenchmarkFile << "," << m_ScriptInvocations[m_Sample] << "," << m_UncompiledScriptInvocations[m_Sample] << "," << g_MovableMan.GetParticleCount() << "," << g_MovableMan.GetKnownObjectsCount() << "," << g_MovableMan.GetMOIDCount() << "\n";
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::StopBenchmarkRecording() {
+		if (m_BenchmarkFile.is_open()) { m_BenchmarkFile.close(); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::ProfileZone::Begin() {
+		ThreadTrace &threadTrace = g_PerformanceMan.GetThreadTrace();
+		threadTrace.m_Depth++;
+		m_StartTime = g_TimerMan.GetAbsoulteTime();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::ProfileZone::End() {
+		int64_t endTime = g_TimerMan.GetAbsoulteTime();
+		ThreadTrace &threadTrace = g_PerformanceMan.GetThreadTrace();
+		threadTrace.m_Depth--;
+		g_PerformanceMan.RecordTraceEvent(threadTrace, { m_Name, m_StartTime, endTime - m_StartTime, threadTrace.m_Depth });
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::StartTraceCapture() {
+		m_TraceCaptureNumber++;
+		m_CapturingTrace.store(true, std::memory_order_relaxed);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PerformanceMan::SaveTrace(const std::string &fileName) {
+		std::ofstream traceFile(fileName, std::ios_base::out | std::ios_base::trunc);
+		if (!traceFile.is_open()) {
+			g_ConsoleMan.PrintString("ERROR: Opening \'" + fileName + "\' for writing the trace failed!");
+			return false;
+		}
+		/// <summary>
+		/// Internal lambda function to write a string as a JSON string value, escaping what JSON requires.
+		/// </summary>
+		auto writeJSONString = [&traceFile](const std::string &stringToWrite) {
+			traceFile << "\"";
+			for (const char &character : stringToWrite) {
+				if (character == '"' || character == '\\') {
+					traceFile << '\\' << character;
+				} else if (static_cast<unsigned char>(character) >= 0x20) {
+					traceFile << character;
+				}
+			}
+			traceFile << "\"";
+		};
+
+		unsigned int captureNumber = m_TraceCaptureNumber.load(std::memory_order_acquire);
+		size_t savedEventCount = 0;
+		size_t droppedEventCount = 0;
+		bool firstEntry = true;
+
+		traceFile << "{\"traceEvents\":[";
+		{
+			std::lock_guard<std::mutex> threadTracesLock(m_ThreadTracesMutex);
+			for (const std::unique_ptr<ThreadTrace> &threadTrace : m_ThreadTraces) {
+				traceFile << (firstEntry ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadTrace->m_ThreadIndex << ",\"args\":{\"name\":";
+				writeJSONString(threadTrace->m_ThreadName);
+				traceFile << "}}";
+				firstEntry = false;
+
+				// The capture number has to be checked before the event count, so events from an older capture are never mistaken for ones of this capture while the thread is throwing them away.
+				if (threadTrace->m_CaptureNumber.load(std::memory_order_acquire) != captureNumber) {
+					continue;
+				}
+				size_t eventCount = threadTrace->m_EventCount.load(std::memory_order_acquire);
+				for (size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex) {
+					const TraceEvent &traceEvent = threadTrace->m_Events[eventIndex];
+					traceFile << ",\n{\"name\":";
+					writeJSONString(traceEvent.m_Name);
+					traceFile << ",\"cat\":\"RTE\",\"ph\":\"X\",\"ts\":" << traceEvent.m_StartTime << ",\"dur\":" << traceEvent.m_Duration << ",\"pid\":0,\"tid\":" << threadTrace->m_ThreadIndex << ",\"args\":{\"depth\":" << traceEvent.m_Depth << "}}";
+				}
+				savedEventCount += eventCount;
+				droppedEventCount += threadTrace->m_DroppedEventCount.load(std::memory_order_relaxed);
+			}
+		}
+		traceFile << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		g_ConsoleMan.PrintString("SYSTEM: Saved " + std::to_string(savedEventCount) + " trace events to \'" + fileName + "\'" + (droppedEventCount > 0 ? ", " + std::to_string(droppedEventCount) + " more didn't fit in the trace buffers." : "."));
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::SetTraceThreadName(const std::string &threadName) {
+		s_ThreadTraceName = threadName;
+		if (s_ThreadTrace && s_ThreadTraceNumber == s_ThreadTraceListNumber.load()) {
+			std::lock_guard<std::mutex> threadTracesLock(m_ThreadTracesMutex);
+			s_ThreadTrace->m_ThreadName = threadName;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PerformanceMan::ThreadTrace & PerformanceMan::GetThreadTrace() {
+		if (!s_ThreadTrace || s_ThreadTraceNumber != s_ThreadTraceListNumber.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> threadTracesLock(m_ThreadTracesMutex);
+			std::unique_ptr<ThreadTrace> threadTrace(new ThreadTrace);
+			threadTrace->m_ThreadIndex = static_cast<unsigned int>(m_ThreadTraces.size());
+			threadTrace->m_ThreadName = s_ThreadTraceName.empty() ? "Thread " + std::to_string(threadTrace->m_ThreadIndex) : s_ThreadTraceName;
+			threadTrace->m_EventCount.store(0);
+			threadTrace->m_DroppedEventCount.store(0);
+			threadTrace->m_CaptureNumber.store(m_TraceCaptureNumber.load());
+			threadTrace->m_Depth = 0;
+
+			s_ThreadTrace = threadTrace.get();
+			s_ThreadTraceNumber = s_ThreadTraceListNumber.load(std::memory_order_relaxed);
+			m_ThreadTraces.push_back(std::move(threadTrace));
+		}
+		return *s_ThreadTrace;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::RecordTraceEvent(ThreadTrace &threadTrace, const TraceEvent &traceEvent) {
+		if (!IsCapturingTrace()) {
+			return;
+		}
+		unsigned int captureNumber = m_TraceCaptureNumber.load(std::memory_order_relaxed);
+		if (threadTrace.m_CaptureNumber.load(std::memory_order_relaxed) != captureNumber) {
+			// A new capture started since this thread last recorded, so throw away the old events. The count is cleared before the new capture number is published so SaveTrace can't pair the new number with old events.
+			threadTrace.m_EventCount.store(0, std::memory_order_release);
+			threadTrace.m_DroppedEventCount.store(0, std::memory_order_relaxed);
+			threadTrace.m_CaptureNumber.store(captureNumber, std::memory_order_release);
+		}
+		if (threadTrace.m_Events.empty()) { threadTrace.m_Events.resize(c_MaxTraceEventsPerThread); }
+
+		size_t eventCount = threadTrace.m_EventCount.load(std::memory_order_relaxed);
+		if (eventCount >= threadTrace.m_Events.size()) {
+			threadTrace.m_DroppedEventCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		threadTrace.m_Events[eventCount] = traceEvent;
+		// Releasing the new count makes the event written above visible to SaveTrace before it can see there is an event.
+		threadTrace.m_EventCount.store(eventCount + 1, std::memory_order_release);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -138,6 +330,19 @@ namespace RTE {
 		return totalPerformanceMeasurement / c_Average;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned int PerformanceMan::GetSampleCountAverage(const unsigned int *sampleCounts) const {
+		unsigned int totalCount = 0;
+		unsigned short sample = m_Sample;
+		for (unsigned short i = 0; i < c_Average; ++i) {
+			totalCount += sampleCounts[sample];
+			if (sample == 0) { sample = c_MaxSamples; }
+			sample--;
+		}
+		return totalCount / c_Average;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::Draw(AllegroBitmap bitmapToDrawTo) {
@@ -196,6 +401,12 @@ namespace RTE {
 			}
 			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 100, str, GUIFont::Left);
 
+			sprintf_s(str, sizeof(str), "Script Calls: %u | %u Uncompiled", GetSampleCountAverage(m_ScriptInvocations), GetSampleCountAverage(m_UncompiledScriptInvocations));
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 110, str, GUIFont::Left);
+
+			sprintf_s(str, sizeof(str), "Rotated Effect Cache: %u Hits | %u Misses Last Frame | %u KB", g_PostProcessMan.GetRotatedEffectCacheHits(), g_PostProcessMan.GetRotatedEffectCacheMisses(), static_cast<unsigned int>(g_PostProcessMan.GetRotatedEffectCacheMemory() / 1024));
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 120, str, GUIFont::Left);
+
 			// If in split screen mode don't draw graphs because they don't fit anyway.
 			if (m_AdvancedPerfStats && g_FrameMan.GetScreenCount() == 1) { DrawPeformanceGraphs(bitmapToDrawTo); }
 		}
@@ -4,6 +4,8 @@
 #include "Singleton.h"
 #include "Constants.h"
 
+#include <atomic>
+
 #define g_PerformanceMan PerformanceMan::Instance()
 
 namespace RTE {
@@ -32,6 +34,45 @@ namespace RTE {
 			PERF_COUNT
 		};
 
+		/// <summary>
+		/// Times the code from its construction to its destruction and records it to the trace of the thread it's on, if a trace is being captured.
+		/// Zones on the same thread nest by their lifetimes, so a zone around a call site also shows how its time splits up among the zones inside it.
+		/// </summary>
+		class ProfileZone {
+
+		public:
+
+			/// <summary>
+			/// Constructor method used to start timing a ProfileZone. Costs no more than a flag check if no trace is being captured.
+			/// </summary>
+			/// <param name="zoneName">The name to show for this zone in the trace. Only the pointer is kept, so this should be a string literal.</param>
+			explicit ProfileZone(const char *zoneName) : m_Name(zoneName), m_StartTime(-1) { if (g_PerformanceMan.IsCapturingTrace()) { Begin(); } }
+
+			/// <summary>
+			/// Destructor method used to stop timing a ProfileZone and record it to the trace.
+			/// </summary>
+			~ProfileZone() { if (m_StartTime >= 0) { End(); } }
+
+		private:
+
+			const char *m_Name; //!< The name to show for this zone in the trace.
+			int64_t m_StartTime; //!< When this zone started, in microseconds. Negative if this zone isn't being recorded.
+
+			/// <summary>
+			/// Starts timing this zone and goes one level deeper in the calling thread's zone nesting.
+			/// </summary>
+			void Begin();
+
+			/// <summary>
+			/// Stops timing this zone, goes back up one level in the calling thread's zone nesting and records this zone to its trace.
+			/// </summary>
+			void End();
+
+			// Disallow the use of some implicit methods.
+			ProfileZone(const ProfileZone &reference) {}
+			ProfileZone & operator=(const ProfileZone &rhs) {}
+		};
+
 #pragma region Creation
 		/// <summary>
 		///  Constructor method used to instantiate a PerformanceMan object in system memory. Create() should be called before using the object.
@@ -135,6 +176,68 @@ namespace RTE {
 		/// </summary>
 		/// <param name="ping">Ping value to display.</param>
 		void SetCurrentPing(unsigned short ping) { m_CurrentPing = ping; }
+
+		/// <summary>
+		/// Counts a scripted function invocation towards the current performance sample.
+		/// </summary>
+		void AddScriptInvocation() { m_ScriptInvocations[m_Sample]++; }
+
+		/// <summary>
+		/// Counts a scripted function invocation that couldn't use a compiled function and had its script string compiled instead towards the current performance sample.
+		/// </summary>
+		void AddUncompiledScriptInvocation() { m_UncompiledScriptInvocations[m_Sample]++; }
+#pragma endregion
+
+#pragma region Benchmark Recording
+		/// <summary>
+		/// Opens a CSV file and writes its header, so the counters of each following sim update can be recorded to it with RecordBenchmarkSample().
+		/// </summary>
+		/// <param name="fileName">The path of the CSV file to write. Any existing file there is overwritten.</param>
+		/// <returns>Whether the file was opened for writing.</returns>
+		bool StartBenchmarkRecording(const std::string &fileName);
+
+		/// <summary>
+		/// Writes a row with all the performance counters and object counts of the current sample to the benchmark CSV file. Does nothing if no recording was started.
+		/// </summary>
+		/// <param name="frameNumber">The number of the frame the current sample belongs to.</param>
+		/// <param name="frameTime">How long the whole frame took to run, in microseconds.</param>
+		void RecordBenchmarkSample(unsigned int frameNumber, unsigned long long frameTime);
+
+		/// <summary>
+		/// Flushes and closes the benchmark CSV file, if one is open.
+		/// </summary>
+		void StopBenchmarkRecording();
+#pragma endregion
+
+#pragma region Trace Capture
+		/// <summary>
+		/// Gets whether ProfileZones are currently being recorded.
+		/// </summary>
+		/// <returns>Whether a trace is being captured.</returns>
+		bool IsCapturingTrace() const { return m_CapturingTrace.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Starts recording all ProfileZones on all threads, throwing away whatever the previous capture recorded.
+		/// </summary>
+		void StartTraceCapture();
+
+		/// <summary>
+		/// Stops recording ProfileZones. What was recorded is kept until the next capture is started, so it can be saved with SaveTrace.
+		/// </summary>
+		void StopTraceCapture() { m_CapturingTrace.store(false, std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Writes the ProfileZones recorded by the current or last capture to a file in the Chrome trace event format, to be viewed with chrome://tracing or a compatible viewer.
+		/// </summary>
+		/// <param name="fileName">The path of the file to write. Any existing file there is overwritten.</param>
+		/// <returns>Whether the file was written.</returns>
+		bool SaveTrace(const std::string &fileName);
+
+		/// <summary>
+		/// Sets the name the calling thread is shown with in saved traces.
+		/// </summary>
+		/// <param name="threadName">The name to show for the calling thread.</param>
+		void SetTraceThreadName(const std::string &threadName);
 #pragma endregion
 
 #pragma region Class Info
@@ -155,7 +258,7 @@ namespace RTE {
 		const unsigned short c_StatsOffsetX = 17; //!< Offset of the stat text from the left edge of the screen.
 		const unsigned short c_StatsHeight = 14; //!< Height of each stat text line.
 		const unsigned short c_GraphsOffsetX = 14; //!< Offset of the graph from the left edge of the screen.
-		const unsigned short c_GraphsStartOffsetY = 134; //!< Position the first graph block will be drawn from the top edge of the screen.
+		const unsigned short c_GraphsStartOffsetY = 144; //!< Position the first graph block will be drawn from the top edge of the screen.
 		const unsigned short c_GraphHeight = 20; //!< Height of the performance graph.
 		const unsigned short c_GraphBlockHeight = 34; //!< Height of the whole graph block (text height and graph height combined).
 
@@ -176,6 +279,46 @@ namespace RTE {
 		unsigned long long m_PerfMeasureStart[PERF_COUNT]; //!< Current measurement start time in microseconds.
 		unsigned long long m_PerfMeasureStop[PERF_COUNT]; //!< Current measurement stop time in microseconds.
 
+		unsigned int m_ScriptInvocations[c_MaxSamples]; //!< Array to store how many scripted functions were invoked in each sample.
+		unsigned int m_UncompiledScriptInvocations[c_MaxSamples]; //!< Array to store how many of the scripted function invocations in each sample had to compile a script string.
+
+		std::ofstream m_BenchmarkFile; //!< The CSV file benchmark samples are written to while a benchmark is recorded.
+
+		static constexpr size_t c_MaxTraceEventsPerThread = 1 << 18; //!< How many ProfileZones each thread can record per capture. Any more are dropped.
+
+		/// <summary>
+		/// A recorded ProfileZone.
+		/// </summary>
+		struct TraceEvent {
+			const char *m_Name; //!< The name of the zone.
+			int64_t m_StartTime; //!< When the zone started, in microseconds.
+			int64_t m_Duration; //!< How long the zone took, in microseconds.
+			unsigned short m_Depth; //!< How many other zones the zone was nested in.
+		};
+
+		/// <summary>
+		/// The ProfileZones recorded by a single thread. Only that thread ever writes to it, and the events below the event count can be read from any thread at any time without locking.
+		/// </summary>
+		struct ThreadTrace {
+			std::string m_ThreadName; //!< The name the thread is shown with in saved traces. Guarded by m_ThreadTracesMutex.
+			unsigned int m_ThreadIndex; //!< The number the thread is shown with in saved traces.
+			std::vector<TraceEvent> m_Events; //!< The recorded events. Filled up to capacity the first time the thread records anything, and never resized after.
+			std::atomic<size_t> m_EventCount; //!< How many of the events are recorded.
+			std::atomic<size_t> m_DroppedEventCount; //!< How many events didn't fit in the current capture.
+			std::atomic<unsigned int> m_CaptureNumber; //!< Which capture the recorded events belong to.
+			unsigned short m_Depth; //!< How many recorded zones the thread is currently inside.
+		};
+
+		std::atomic<bool> m_CapturingTrace; //!< Whether ProfileZones are currently being recorded.
+		std::atomic<unsigned int> m_TraceCaptureNumber; //!< Which capture is the current one. Threads throw away their recorded events when they notice this changed.
+		std::vector<std::unique_ptr<ThreadTrace>> m_ThreadTraces; //!< The traces of all threads that recorded anything, owned by this.
+		std::mutex m_ThreadTracesMutex; //!< Mutex guarding the list of thread traces and their names.
+
+		static std::atomic<unsigned int> s_ThreadTraceListNumber; //!< Changed every time the list of thread traces is thrown away, so threads know their trace pointer is stale.
+		static thread_local ThreadTrace *s_ThreadTrace; //!< The calling thread's trace, once it recorded anything. Not owned.
+		static thread_local unsigned int s_ThreadTraceNumber; //!< The list number the calling thread's trace pointer belongs to.
+		static thread_local std::string s_ThreadTraceName; //!< The name the calling thread asked to be shown with, if any.
+
 	private:
 
 #pragma region Performance Counter Handling
@@ -197,6 +340,28 @@ namespace RTE {
 		/// <param name="counter">Counter to get average value from.</param>
 		/// <returns>An average value for specified counter.</returns>
 		unsigned long long GetPerformanceCounterAverage(PerformanceCounters counter);
+
+		/// <summary>
+		/// Returns an average value of c_Average last samples of the specified per-sample count array.
+		/// </summary>
+		/// <param name="sampleCounts">Array of c_MaxSamples counts to get average value from.</param>
+		/// <returns>An average value for specified count array.</returns>
+		unsigned int GetSampleCountAverage(const unsigned int *sampleCounts) const;
+#pragma endregion
+
+#pragma region Trace Capture
+		/// <summary>
+		/// Gets the calling thread's trace, making one for it if it doesn't have one yet.
+		/// </summary>
+		/// <returns>The calling thread's trace.</returns>
+		ThreadTrace & GetThreadTrace();
+
+		/// <summary>
+		/// Adds a finished ProfileZone to a thread's trace, if a trace is still being captured. Must only be called from the thread the trace belongs to.
+		/// </summary>
+		/// <param name="threadTrace">The calling thread's trace.</param>
+		/// <param name="traceEvent">The finished zone to add.</param>
+		void RecordTraceEvent(ThreadTrace &threadTrace, const TraceEvent &traceEvent);
 #pragma endregion
 
 		/// <summary>
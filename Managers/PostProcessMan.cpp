@@ -1,8 +1,17 @@
 #include "PostProcessMan.h"
 #include "FrameMan.h"
+#include "PerformanceMan.h"
 #include "Scene.h"
 #include "ContentFile.h"
 #include "Matrix.h"
+#include "SettingsMan.h"
+
+#include "allegro/internal/aintern.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define RTE_GLOW_SCAN_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace RTE {
 
@@ -19,6 +28,12 @@ namespace RTE {
 		m_RedGlowHash = 0;
 		m_BlueGlow = 0;
 		m_BlueGlowHash = 0;
+		m_RotatedEffects.clear();
+		m_RotatedEffectLookup.clear();
+		m_RotatedEffectCacheBudget = 0;
+		m_RotatedEffectCacheMemory = 0;
+		m_RotatedEffectCacheHits = 0;
+		m_RotatedEffectCacheMisses = 0;
 		for (short i = 0; i < c_MaxScreenCount; ++i) {
 			m_ScreenRelativeEffects->clear();
 		}
@@ -47,6 +62,7 @@ namespace RTE {
 			{256, create_bitmap(256, 256)},
 			{512, create_bitmap(512, 512)}
 		};
+		m_RotatedEffectCacheBudget = static_cast<size_t>(std::max(g_SettingsMan.GetRotatedPostEffectCacheSizeMB(), 0)) * 1024 * 1024;
 
 		return 0;
 	}
@@ -56,6 +72,7 @@ namespace RTE {
 	void PostProcessMan::Destroy() {
 		ClearScreenPostEffects();
 		ClearScenePostEffects();
+		ClearRotatedEffectCache();
 		Clear();
 		for (std::pair<unsigned short, BITMAP *> tempBitmapEntry : m_TempEffectBitmaps) {
 			destroy_bitmap(tempBitmapEntry.second);
@@ -136,6 +153,17 @@ namespace RTE {
 		return correspondingBitmapSizeEntry->second;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PostProcessMan::ClearRotatedEffectCache() {
+		for (const RotatedEffect &rotatedEffect : m_RotatedEffects) {
+			destroy_bitmap(rotatedEffect.m_Bitmap);
+		}
+		m_RotatedEffects.clear();
+		m_RotatedEffectLookup.clear();
+		m_RotatedEffectCacheMemory = 0;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PostProcessMan::RegisterGlowDotEffect(const Vector &effectPos, DotGlowColor color, unsigned char strength) {
@@ -274,12 +302,17 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PostProcessMan::PostProcess() {
+		PerformanceMan::ProfileZone profileZone("PostProcessMan::PostProcess");
+
 		// First copy the current 8bpp backbuffer to the 32bpp buffer; we'll add effects to it
 		blit(g_FrameMan.GetBackBuffer8(), g_FrameMan.GetBackBuffer32(), 0, 0, 0, 0, g_FrameMan.GetBackBuffer8()->w, g_FrameMan.GetBackBuffer8()->h);
 
 		// Set the screen blender mode for glows
 		set_screen_blender(128, 128, 128, 128);
 
+		// The performance stats are drawn before post processing, so they show the counts of the frame before this one
+		ResetRotatedEffectCacheCounters();
+
 		// Reference. Do not remove.
 		//acquire_bitmap(m_BackBuffer8);
 		//acquire_bitmap(m_BackBuffer32);
@@ -300,25 +333,19 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PostProcessMan::DrawDotGlowEffects() {
-		int x = 0;
-		int y = 0;
-		int startX = 0;
-		int startY = 0;
-		int endX = 0;
-		int endY = 0;
-		unsigned short testpixel = 0;
-
-		// Randomly sample the entire backbuffer, looking for pixels to put a glow on.
-		// NOTE THIS IS SLOW, especially on higher resolutions!
+		BITMAP *backBuffer8 = g_FrameMan.GetBackBuffer8();
+		int scanTop = backBuffer8->h;
+		int scanBottom = 0;
+
+		m_GlowScanRects.clear();
 		for (const Box &glowBox : m_PostScreenGlowBoxes) {
-			startX = glowBox.m_Corner.m_X;
-			startY = glowBox.m_Corner.m_Y;
-			endX = startX + glowBox.m_Width;
-			endY = startY + glowBox.m_Height;
+			int startX = glowBox.m_Corner.m_X;
+			int startY = glowBox.m_Corner.m_Y;
+			int endX = startX + glowBox.m_Width;
+			int endY = startY + glowBox.m_Height;
 
 			// Sanity check a little at least
-			if (startX < 0 || startX >= g_FrameMan.GetBackBuffer8()->w || startY < 0 || startY >= g_FrameMan.GetBackBuffer8()->h ||
-				endX < 0 || endX >= g_FrameMan.GetBackBuffer8()->w || endY < 0 || endY >= g_FrameMan.GetBackBuffer8()->h) {
+			if (startX < 0 || startX >= backBuffer8->w || startY < 0 || startY >= backBuffer8->h || endX < 0 || endX >= backBuffer8->w || endY < 0 || endY >= backBuffer8->h) {
 				continue;
 			}
 
@@ -326,29 +353,156 @@ namespace RTE {
 			// Draw a rectangle around the glow box so we see it's position and size
 			rect(g_FrameMan.GetBackBuffer32(), startX, startY, endX, endY, g_RedColor);
 #endif
-			
-			for (y = startY; y < endY; ++y) {
-				for (x = startX; x < endX; ++x) {
-					testpixel = _getpixel(g_FrameMan.GetBackBuffer8(), x, y);
-
-					// YELLOW
-					if ((testpixel == g_YellowGlowColor && PosRand() < 0.9) || testpixel == 98 || (testpixel == 120 && PosRand() < 0.7)) {
-						draw_trans_sprite(g_FrameMan.GetBackBuffer32(), m_YellowGlow, x - 2, y - 2);
-					}
-					// TODO: Enable and add more colors once we actually have something that needs these.
-					// RED
-					/*
-					if (testpixel == 13) {
-						draw_trans_sprite(m_BackBuffer32, m_RedGlow, x - 2, y - 2);
-					}
-					// BLUE
-					if (testpixel == 166) {
-						draw_trans_sprite(g_FrameMan.GetBackBuffer32(), m_BlueGlow, x - 2, y - 2);
-					}
-					*/
+			m_GlowScanRects.push_back(IntRect(startX, startY, endX, endY));
+			scanTop = std::min(scanTop, startY);
+			scanBottom = std::max(scanBottom, endY);
+		}
+
+		// Scan the backbuffer a row at a time, merging the spans of all boxes that cover the row so pixels in overlapping boxes don't get looked at (and glow) more than once
+		m_DotGlowPositions.clear();
+		for (int y = scanTop; y < scanBottom; ++y) {
+			m_GlowRowSpans.clear();
+			for (const IntRect &glowRect : m_GlowScanRects) {
+				if (y >= glowRect.m_Top && y < glowRect.m_Bottom) { m_GlowRowSpans.push_back({ glowRect.m_Left, glowRect.m_Right }); }
+			}
+			if (m_GlowRowSpans.empty()) {
+				continue;
+			}
+			std::sort(m_GlowRowSpans.begin(), m_GlowRowSpans.end());
+
+			int spanStart = m_GlowRowSpans.front().first;
+			int spanEnd = m_GlowRowSpans.front().second;
+			for (const std::pair<int, int> &rowSpan : m_GlowRowSpans) {
+				if (rowSpan.first > spanEnd) {
+					FindDotGlowPixelsInSpan(backBuffer8->line[y], spanStart, spanEnd, y);
+					spanStart = rowSpan.first;
+				}
+				spanEnd = std::max(spanEnd, rowSpan.second);
+			}
+			FindDotGlowPixelsInSpan(backBuffer8->line[y], spanStart, spanEnd, y);
+		}
+
+		// Blend all the found glows in one go now that the backbuffer has been scanned
+		BlendDotGlows(g_FrameMan.GetBackBuffer32(), m_YellowGlow, m_DotGlowPositions);
+		// TODO: Enable and add more colors once we actually have something that needs these.
+		// RED pixels of color 13 would get m_RedGlow, BLUE pixels of color 166 would get m_BlueGlow.
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PostProcessMan::BlendDotGlows(BITMAP *targetBitmap, BITMAP *glowBitmap, const std::vector<std::pair<int, int>> &glowPositions) const {
+		// The glows have always been drawn 2 pixels up and left of the glowing pixel, which centers the tiny glow bitmaps on it
+		const int offsetX = 2;
+		const int offsetY = 2;
+
+		// Only 32bpp memory bitmaps can be blended pixel by pixel here, anything else goes through Allegro one glow at a time
+		if (!is_memory_bitmap(targetBitmap) || bitmap_color_depth(targetBitmap) != 32 || bitmap_color_depth(glowBitmap) != 32) {
+			for (const std::pair<int, int> &glowPos : glowPositions) {
+				draw_trans_sprite(targetBitmap, glowBitmap, glowPos.first - offsetX, glowPos.second - offsetY);
+			}
+			return;
+		}
+
+		// Same as what draw_trans_sprite does for every pixel, minus setting up the blender, clipping and dispatching for each glow
+		BLENDER_FUNC blender = _blender_func32;
+		unsigned long blenderAlpha = static_cast<unsigned long>(_blender_alpha);
+		for (const std::pair<int, int> &glowPos : glowPositions) {
+			int left = glowPos.first - offsetX;
+			int top = glowPos.second - offsetY;
+			int startX = std::max(targetBitmap->cl - left, 0);
+			int endX = std::min(targetBitmap->cr - left, glowBitmap->w);
+			int startY = std::max(targetBitmap->ct - top, 0);
+			int endY = std::min(targetBitmap->cb - top, glowBitmap->h);
+
+			for (int glowY = startY; glowY < endY; ++glowY) {
+				const uint32_t *glowRow = reinterpret_cast<const uint32_t *>(glowBitmap->line[glowY]);
+				uint32_t *targetRow = reinterpret_cast<uint32_t *>(targetBitmap->line[top + glowY]) + left;
+				for (int glowX = startX; glowX < endX; ++glowX) {
+					if (glowRow[glowX] != MASK_COLOR_32) { targetRow[glowX] = static_cast<uint32_t>(blender(glowRow[glowX], targetRow[glowX], blenderAlpha)); }
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PostProcessMan::FindDotGlowPixelsInSpan(const unsigned char *row, int startX, int endX, int y) {
+		/// <summary>
+		/// Internal lambda function to decide whether a pixel of one of the glowing colors gets a glow this frame, and add it to the list if it does.
+		/// </summary>
+		auto testPixel = [this, y](int x, unsigned char pixel) {
+			// YELLOW
+			if ((pixel == g_YellowGlowColor && PosRand() < 0.9) || pixel == 98 || (pixel == 120 && PosRand() < 0.7)) { m_DotGlowPositions.push_back({ x, y }); }
+		};
+
+		int x = startX;
+#ifdef RTE_GLOW_SCAN_SSE2
+		// Compare 16 pixels at a time against all the glowing colors, only looking at single pixels when there is at least one match among them
+		const __m128i yellowGlowColor = _mm_set1_epi8(static_cast<char>(g_YellowGlowColor));
+		const __m128i yellowGlowColor98 = _mm_set1_epi8(static_cast<char>(98));
+		const __m128i yellowGlowColor120 = _mm_set1_epi8(static_cast<char>(120));
+		for (; x + 16 <= endX; x += 16) {
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+			__m128i matches = _mm_or_si128(_mm_cmpeq_epi8(pixels, yellowGlowColor), _mm_or_si128(_mm_cmpeq_epi8(pixels, yellowGlowColor98), _mm_cmpeq_epi8(pixels, yellowGlowColor120)));
+			int matchMask = _mm_movemask_epi8(matches);
+			if (matchMask == 0) {
+				continue;
+			}
+			for (int i = 0; i < 16; ++i) {
+				if (matchMask & (1 << i)) { testPixel(x + i, row[x + i]); }
+			}
+		}
+#endif
+		for (; x < endX; ++x) {
+			testPixel(x, row[x]);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	BITMAP * PostProcessMan::GetRotatedEffectBitmap(const PostEffect &postEffect) {
+		Matrix newAngle;
+		newAngle.SetRadAngle(postEffect.m_Angle);
+		// Round to a whole angle step so effects that are almost the same angle share the same cached bitmap. Masking wraps negative steps around to the positive ones.
+		int angleStep = static_cast<int>(std::round(newAngle.GetAllegroAngle())) & (c_RotatedEffectAngleSteps - 1);
+
+		BITMAP *tempBitmap = GetTempEffectBitmap(postEffect.m_Bitmap);
+		std::pair<size_t, int> effectKey(postEffect.m_BitmapHash, angleStep);
+
+		// Effects without a hash can't be told apart, so they're rotated every time like before
+		if (m_RotatedEffectCacheBudget > 0 && postEffect.m_BitmapHash != 0) {
+			std::map<std::pair<size_t, int>, std::list<RotatedEffect>::iterator>::iterator lookupEntry = m_RotatedEffectLookup.find(effectKey);
+			if (lookupEntry != m_RotatedEffectLookup.end()) {
+				m_RotatedEffectCacheHits++;
+				m_RotatedEffects.splice(m_RotatedEffects.begin(), m_RotatedEffects, lookupEntry->second);
+				return lookupEntry->second->m_Bitmap;
+			}
+			m_RotatedEffectCacheMisses++;
+
+			// Same size as the temporary bitmap it would otherwise be rotated in, so the rotated corners get drawn exactly the same
+			size_t bitmapMemory = static_cast<size_t>(tempBitmap->w) * static_cast<size_t>(tempBitmap->h) * static_cast<size_t>((bitmap_color_depth(tempBitmap) + 7) / 8);
+			if (bitmapMemory <= m_RotatedEffectCacheBudget) {
+				while (m_RotatedEffectCacheMemory + bitmapMemory > m_RotatedEffectCacheBudget && !m_RotatedEffects.empty()) {
+					const RotatedEffect &leastRecentlyUsed = m_RotatedEffects.back();
+					destroy_bitmap(leastRecentlyUsed.m_Bitmap);
+					m_RotatedEffectCacheMemory -= leastRecentlyUsed.m_Memory;
+					m_RotatedEffectLookup.erase(leastRecentlyUsed.m_Key);
+					m_RotatedEffects.pop_back();
 				}
+				BITMAP *rotatedBitmap = create_bitmap_ex(bitmap_color_depth(tempBitmap), tempBitmap->w, tempBitmap->h);
+				clear_to_color(rotatedBitmap, 0);
+				rotate_sprite(rotatedBitmap, postEffect.m_Bitmap, 0, 0, itofix(angleStep));
+
+				m_RotatedEffects.push_front({ effectKey, rotatedBitmap, bitmapMemory });
+				m_RotatedEffectLookup.insert({ effectKey, m_RotatedEffects.begin() });
+				m_RotatedEffectCacheMemory += bitmapMemory;
+				return rotatedBitmap;
 			}
 		}
+		// Nothing is shared when not caching, so the exact angle is used
+		clear_to_color(tempBitmap, 0);
+		rotate_sprite(tempBitmap, postEffect.m_Bitmap, 0, 0, ftofix(newAngle.GetAllegroAngle()));
+		return tempBitmap;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -371,14 +525,7 @@ namespace RTE {
 				if (postEffect.m_Angle == 0) {
 					draw_trans_sprite(g_FrameMan.GetBackBuffer32(), effectBitmap, effectPosX, effectPosY);
 				} else {
-					BITMAP *targetBitmap = GetTempEffectBitmap(effectBitmap);
-					clear_to_color(targetBitmap, 0);
-
-					Matrix newAngle;
-					newAngle.SetRadAngle(postEffect.m_Angle);
-
-					rotate_sprite(targetBitmap, effectBitmap, 0, 0, ftofix(newAngle.GetAllegroAngle()));
-					draw_trans_sprite(g_FrameMan.GetBackBuffer32(), targetBitmap, effectPosX, effectPosY);
+					draw_trans_sprite(g_FrameMan.GetBackBuffer32(), GetRotatedEffectBitmap(postEffect), effectPosX, effectPosY);
 				}
 			}
 		}
@@ -131,6 +131,34 @@ namespace RTE {
 		/// <param name="bitmapSize">Size of bitmap to get.</param>
 		/// <returns>Pointer to the temporary bitmap.</returns>
 		BITMAP* GetTempEffectBitmap(BITMAP *bitmap) const;
+
+		/// <summary>
+		/// Gets how many times a rotated post effect was found in the rotated effect cache.
+		/// </summary>
+		/// <returns>The number of rotated effect cache hits during the last drawn frame.</returns>
+		unsigned int GetRotatedEffectCacheHits() const { return m_RotatedEffectCacheHits; }
+
+		/// <summary>
+		/// Gets how many times a rotated post effect had to be rotated because it wasn't in the rotated effect cache.
+		/// </summary>
+		/// <returns>The number of rotated effect cache misses during the last drawn frame.</returns>
+		unsigned int GetRotatedEffectCacheMisses() const { return m_RotatedEffectCacheMisses; }
+
+		/// <summary>
+		/// Gets how much bitmap memory the rotated effect cache is using.
+		/// </summary>
+		/// <returns>The memory used by the cached rotated effect bitmaps, in bytes.</returns>
+		size_t GetRotatedEffectCacheMemory() const { return m_RotatedEffectCacheMemory; }
+
+		/// <summary>
+		/// Resets the rotated effect cache hit and miss counters. Done at the start of every PostProcess, so they only count the effects of one frame.
+		/// </summary>
+		void ResetRotatedEffectCacheCounters() { m_RotatedEffectCacheHits = 0; m_RotatedEffectCacheMisses = 0; }
+
+		/// <summary>
+		/// Destroys all the bitmaps in the rotated effect cache.
+		/// </summary>
+		void ClearRotatedEffectCache();
 #pragma endregion
 
 #pragma region Post Pixel Glow Handling
@@ -209,6 +237,10 @@ namespace RTE {
 		std::list<Box> m_PostScreenGlowBoxes; //!< List of areas that will be processed with glow.
 		std::list<IntRect> m_GlowAreas; //!< All the areas to do post glow pixel effects on, in scene coordinates.
 
+		std::vector<IntRect> m_GlowScanRects; //!< The glow boxes of this frame that are within the backbuffer. Kept between frames so it doesn't need to be allocated every time.
+		std::vector<std::pair<int, int>> m_GlowRowSpans; //!< The start and end X of each merged span of the row being scanned for glow pixels. Kept between frames so it doesn't need to be allocated every time.
+		std::vector<std::pair<int, int>> m_DotGlowPositions; //!< The positions of all the pixels getting a dot glow this frame. Kept between frames so it doesn't need to be allocated every time.
+
 		std::list<PostEffect> m_ScreenRelativeEffects[c_MaxScreenCount]; //!< List of screen relative effects for each player in online multiplayer.
 		std::mutex ScreenRelativeEffectsMutex[c_MaxScreenCount]; //!< Mutex for the ScreenRelativeEffects list when accessed by multiple threads in online multiplayer.
 
@@ -222,6 +254,24 @@ namespace RTE {
 
 		std::unordered_map<unsigned short, BITMAP *> m_TempEffectBitmaps; //!< Stores temporary bitmaps to rotate post effects in for quick access.
 
+		/// <summary>
+		/// A copy of a post effect bitmap rotated to one of the cached angle steps.
+		/// </summary>
+		struct RotatedEffect {
+			std::pair<size_t, int> m_Key; //!< The hash of the original bitmap and the angle step it was rotated to.
+			BITMAP *m_Bitmap; //!< The rotated bitmap. Owned by this.
+			size_t m_Memory; //!< The memory used by the rotated bitmap, in bytes.
+		};
+
+		static constexpr int c_RotatedEffectAngleSteps = 256; //!< How many angle steps the rotated effect cache has in a full turn. Matches the integer part of Allegro's angles.
+
+		std::list<RotatedEffect> m_RotatedEffects; //!< The rotated effect cache, with the most recently used bitmaps at the front.
+		std::map<std::pair<size_t, int>, std::list<RotatedEffect>::iterator> m_RotatedEffectLookup; //!< Finds the rotated effects in the cache by original bitmap hash and angle step.
+		size_t m_RotatedEffectCacheBudget; //!< The most memory the rotated effect cache may use, in bytes. 0 means rotated effects aren't cached at all.
+		size_t m_RotatedEffectCacheMemory; //!< The memory used by the rotated effect cache, in bytes.
+		unsigned int m_RotatedEffectCacheHits; //!< How many times a rotated effect was found in the cache.
+		unsigned int m_RotatedEffectCacheMisses; //!< How many times a rotated effect had to be made because it wasn't in the cache.
+
 	private:
 
 #pragma region Post Effect Handling
@@ -271,6 +321,30 @@ namespace RTE {
 		/// </summary>
 		void DrawDotGlowEffects();
 
+		/// <summary>
+		/// Scans a span of a row of the 8bpp backbuffer for pixels that should get a dot glow, and adds their positions to the dot glow list.
+		/// </summary>
+		/// <param name="row">Pointer to the first pixel of the row.</param>
+		/// <param name="startX">The X of the first pixel of the span.</param>
+		/// <param name="endX">The X one past the last pixel of the span.</param>
+		/// <param name="y">The Y of the row.</param>
+		void FindDotGlowPixelsInSpan(const unsigned char *row, int startX, int endX, int y);
+
+		/// <summary>
+		/// Blends a glow bitmap onto a bitmap around each of a list of glowing pixels, in a single pass with the blender mode that is currently set. Looks the same as calling draw_trans_sprite for each pixel.
+		/// </summary>
+		/// <param name="targetBitmap">The bitmap to blend the glows onto.</param>
+		/// <param name="glowBitmap">The glow bitmap to blend.</param>
+		/// <param name="glowPositions">The positions of the glowing pixels.</param>
+		void BlendDotGlows(BITMAP *targetBitmap, BITMAP *glowBitmap, const std::vector<std::pair<int, int>> &glowPositions) const;
+
+		/// <summary>
+		/// Gets the bitmap of a post effect rotated to its angle, from the rotated effect cache if it's there. Effects that can't be cached are rotated into a temporary bitmap.
+		/// </summary>
+		/// <param name="postEffect">The post effect to get the rotated bitmap of.</param>
+		/// <returns>The rotated bitmap. Only valid until the next call. Ownership is NOT transferred!</returns>
+		BITMAP * GetRotatedEffectBitmap(const PostEffect &postEffect);
+
 		/// <summary>
 		/// Draws all the glow effects registered for this frame. This is called from PostProcess().
 		/// </summary>
@@ -12,6 +12,7 @@
 
 #include "SettingsMan.h"
 #include "TimerMan.h"
+#include "ThreadMan.h"
 #include "FrameMan.h"
 #include "PrimitiveMan.h"
 #include "PerformanceMan.h"
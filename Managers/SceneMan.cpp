@@ -19,6 +19,8 @@
 #include "ConsoleMan.h"
 #include "PrimitiveMan.h"
 #include "SettingsMan.h"
+#include "PerformanceMan.h"
+#include "ThreadMan.h"
 #include "Scene.h"
 #include "SLTerrain.h"
 #include "TerrainObject.h"
@@ -32,6 +34,8 @@
 // Temp
 #include "Controller.h"
 
+#include <random>
+
 namespace RTE
 {
 
@@ -39,6 +43,8 @@ namespace RTE
 #define COMPACTINGHEIGHT 25
 
 const std::string SceneMan::m_ClassName = "SceneMan";
+thread_local Vector SceneMan::m_LastRayHitPos;
+thread_local bool SceneMan::m_SkipRayDebugDrawing = false;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +85,12 @@ void SceneMan::Clear()
     m_pMOColorLayer = 0;
     m_pMOIDLayer = 0;
     m_MOIDDrawings.clear();
+    m_ppLockedMaterialRows = 0;
+    m_ppLockedMOIDRows = 0;
+    m_LockedSceneWidth = 0;
+    m_LockedSceneHeight = 0;
+    m_LockedWrapsX = false;
+    m_LockedWrapsY = false;
     m_pDebugLayer = 0;
     m_LastRayHitPos.Reset();
 
@@ -113,6 +125,8 @@ void SceneMan::Clear()
 	if (m_pOrphanSearchBitmap)
 		destroy_bitmap(m_pOrphanSearchBitmap);
 	m_pOrphanSearchBitmap = create_bitmap_ex(8, MAXORPHANRADIUS , MAXORPHANRADIUS);
+
+    m_UseReferenceRayMarch = false;
 }
 
 /*
@@ -174,7 +188,9 @@ int SceneMan::LoadScene(Scene *pNewScene, bool placeObjects, bool placeUnits)
     if (!pNewScene)
         return -1;
 
-    // Unload and destroy any scene we might have loaded already
+    // Unload and destroy any scene we might have loaded already, and forget any rows cached from its bitmaps
+    m_ppLockedMaterialRows = 0;
+    m_ppLockedMOIDRows = 0;
     if (m_pCurrentScene)
     {
         delete m_pCurrentScene;
@@ -575,12 +591,13 @@ bool SceneMan::MOIDClearCheck()
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetTerrMatter
+// Method:          GetTerrMatterFromBitmap
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Gets a specific pixel from the total material representation of
-//                  this Scene. LockScene() must be called before using this method.
+//                  this Scene through WrapPosition and the material bitmap, for when the
+//                  rows aren't cached or the position is too far off to wrap cheaply.
 
-unsigned char SceneMan::GetTerrMatter(int pixelX, int pixelY)
+unsigned char SceneMan::GetTerrMatterFromBitmap(int pixelX, int pixelY)
 {
     RTEAssert(m_pCurrentScene, "Trying to get terrain matter before there is a scene or terrain!");
 
@@ -603,12 +620,13 @@ unsigned char SceneMan::GetTerrMatter(int pixelX, int pixelY)
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetMOIDPixel
+// Method:          GetMOIDPixelFromBitmap
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Gets a MOID from pixel coordinates in the Scene. LockScene() must be
-//                  called before using this method.
+// Description:     Gets a MOID from pixel coordinates in the Scene through WrapPosition
+//                  and the MOID layer bitmap, for when the rows aren't cached or the
+//                  position is too far off to wrap cheaply.
 
-MOID SceneMan::GetMOIDPixel(int pixelX, int pixelY)
+MOID SceneMan::GetMOIDPixelFromBitmap(int pixelX, int pixelY)
 {
     WrapPosition(pixelX, pixelY);
 
@@ -838,6 +856,19 @@ void SceneMan::LockScene()
         m_pMOColorLayer->LockBitmaps();
         m_pMOIDLayer->LockBitmaps();
     }
+
+    // Cache the bitmap rows for GetTerrMatter and GetMOIDPixel, as long as both layers line up like they should
+    BITMAP *pMaterialBitmap = m_pCurrentScene->GetTerrain()->GetMaterialBitmap();
+    BITMAP *pMOIDBitmap = m_pMOIDLayer->GetBitmap();
+    if (pMaterialBitmap && pMOIDBitmap && pMaterialBitmap->w == pMOIDBitmap->w && pMaterialBitmap->h == pMOIDBitmap->h && bitmap_color_depth(pMOIDBitmap) == c_MOIDLayerBitDepth)
+    {
+        m_ppLockedMaterialRows = pMaterialBitmap->line;
+        m_ppLockedMOIDRows = pMOIDBitmap->line;
+        m_LockedSceneWidth = pMaterialBitmap->w;
+        m_LockedSceneHeight = pMaterialBitmap->h;
+        m_LockedWrapsX = m_pCurrentScene->GetTerrain()->WrapsX();
+        m_LockedWrapsY = m_pCurrentScene->GetTerrain()->WrapsY();
+    }
 }
 
 
@@ -858,6 +889,8 @@ void SceneMan::UnlockScene()
         m_pMOColorLayer->UnlockBitmaps();
         m_pMOIDLayer->UnlockBitmaps();
     }
+    m_ppLockedMaterialRows = 0;
+    m_ppLockedMOIDRows = 0;
 }
 
 
@@ -1347,7 +1380,7 @@ bool SceneMan::TryPenetrate(const int posX,
                         // Clear the terrain pixel now when the particle has been generated from it
 						RegisterTerrainChange(posX, testY, 1, 1, g_MaskColor, false);
                         _putpixel(pFGColor, posX, testY, g_MaskColor);
-                        _putpixel(pMaterial, posX, testY, g_MaterialAir);
+                        m_pCurrentScene->GetTerrain()->SetMaterialPixel(posX, testY, g_MaterialAir);
                     }
                     // There is support, so stop checking
                     else
@@ -1610,37 +1643,68 @@ void SceneMan::RestoreUnseenBox(const int posX, const int posY, const int width,
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastUnseenRay
+// Method:          MarchRay
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and reveals or hides pixels on the unseen layer of a team
-//                  as long as the accumulated material strengths traced through the terrain
-//                  don't exceed a specific value.
+// Description:     Steps along a ray with Bresenham's line algorithm and hands every
+//                  checked pixel to a visitor, which decides whether the ray stops there.
 
-bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip, bool reveal)
+template <bool ReadMOIDs, typename PixelVisitor>
+bool SceneMan::MarchRay(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, bool skipAirTiles, PixelVisitor &&visitPixel)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
+    if (m_SkipRayDebugDrawing)
+        debugColor = -1;
+    else if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
 #endif
 
-    if (!m_pCurrentScene->GetUnseenLayer(team))
-        return false;
+    bool stopped;
+    if (m_UseReferenceRayMarch)
+        stopped = MarchRayReference<ReadMOIDs>(start, ray, skip, wrap, debugColor, visitPixel);
+    else
+    {
+        // Pick the kernel specialized on how the scene wraps, so no wrapping is done on axes that don't wrap
+        const SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+        if (pTerrain->WrapsX())
+            stopped = pTerrain->WrapsY() ? MarchRaySteps<ReadMOIDs, true, true>(start, ray, skip, wrap, debugColor, skipAirTiles, visitPixel) : MarchRaySteps<ReadMOIDs, true, false>(start, ray, skip, wrap, debugColor, skipAirTiles, visitPixel);
+        else
+            stopped = pTerrain->WrapsY() ? MarchRaySteps<ReadMOIDs, false, true>(start, ray, skip, wrap, debugColor, skipAirTiles, visitPixel) : MarchRaySteps<ReadMOIDs, false, false>(start, ray, skip, wrap, debugColor, skipAirTiles, visitPixel);
+    }
 
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
+#ifdef DEBUG_BUILD
+    if (!m_SkipRayDebugDrawing && m_pDebugLayer)
+        m_pDebugLayer->UnlockBitmaps();
+#endif
+
+    return stopped;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarchRaySteps
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The ray march kernel behind MarchRay, specialized on which axes the
+//                  scene wraps, so the wrapping is only done where it's needed and reads
+//                  the terrain material and MOID layer rows directly.
+
+template <bool ReadMOIDs, bool WrapX, bool WrapY, typename PixelVisitor>
+bool SceneMan::MarchRaySteps(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, bool skipAirTiles, PixelVisitor &visitPixel)
+{
+    static_assert(c_MOIDLayerBitDepth == 16, "MarchRaySteps reads the MOID layer as 16 bit pixels!");
+#ifndef DEBUG_BUILD
+    // Only used to draw debug graphics
+    static_cast<void>(debugColor);
+#endif
+
+    int error, dom, sub, domSteps, skipped = skip;
     int intPos[2], delta[2], delta2[2], increment[2];
-    bool affectedAny = false;
-    unsigned char materialID;
-    Material const * foundMaterial;
-    int totalStrength = 0;
-    // Save the projected end of the ray pos
-    endPos = start + ray;
 
     intPos[X] = floorf(start.m_X);
     intPos[Y] = floorf(start.m_Y);
     delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
     delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
+
+    if (delta[X] == 0 && delta[Y] == 0)
         return false;
 
     /////////////////////////////////////////////////////
@@ -1678,15 +1742,38 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
 
     error = delta2[sub] - delta[dom];
 
+    BITMAP *pMaterialBitmap = m_pCurrentScene->GetTerrain()->GetMaterialBitmap();
+    BITMAP *pMOIDBitmap = ReadMOIDs ? m_pMOIDLayer->GetBitmap() : 0;
+    const int width = pMaterialBitmap->w;
+    const int height = pMaterialBitmap->h;
+
+    // Air tiles can only be jumped over while the occupancy grid covers the material layer, and never when MOIDs are read, as they'd be missed on the jumped over pixels
+    const MaterialOccupancyGrid &materialOccupancy = m_pCurrentScene->GetTerrain()->GetMaterialOccupancyGrid();
+    skipAirTiles = skipAirTiles && !ReadMOIDs && materialOccupancy.Covers(width, height);
+
+    // The pixels are read at a copy of the position that is wrapped once here, and after that only has to be moved back over the seam it crossed on the axes that wrap
+    int readPos[2] = { intPos[X], intPos[Y] };
+    WrapPosition(readPos[X], readPos[Y]);
+    // The visitor gets the wrapped position if the cast wraps, and the position as stepped otherwise
+    const int *reportedPos = wrap ? readPos : intPos;
+
+    RayPixel pixel;
+    pixel.m_MOID = g_NoMOID;
+
     /////////////////////////////////////////////////////
     // Bresenham's line drawing algorithm execution
 
     for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
     {
+        pixel.m_PrevPosX = reportedPos[X];
+        pixel.m_PrevPosY = reportedPos[Y];
+
         intPos[dom] += increment[dom];
+        readPos[dom] += increment[dom];
         if (error >= 0)
         {
             intPos[sub] += increment[sub];
+            readPos[sub] += increment[sub];
             error -= delta2[dom];
         }
         error += delta2[sub];
@@ -1694,94 +1781,121 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
         // Only check pixel if we're not due to skip any, or if this is the last pixel
         if (++skipped > skip || domSteps + 1 == delta[dom])
         {
-            // Scene wrapping
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-            // Reveal if we can, save the result
-			if (reveal)
-				affectedAny = RevealUnseen(intPos[X], intPos[Y], team) || affectedAny;
-			else
-				affectedAny = RestoreUnseen(intPos[X], intPos[Y], team) || affectedAny;
-
-            // Check the strength of the terrain to see if we can penetrate further
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
-            // Get the material object
-            foundMaterial = GetMaterialFromID(materialID);
-            // Add the encountered material's strength to the tally
-            totalStrength += foundMaterial->strength;
-            // See if we have hit the limits of our ray's strength
-            if (totalStrength >= strengthLimit)
+            // The position can't have moved more than the skipped pixels since the last check, so this rarely loops more than once
+            if (WrapX)
             {
-                // Save the position of the end of the ray where blocked
-                endPos.SetXY(intPos[X], intPos[Y]);
-                break;
+                while (readPos[X] < 0)
+                    readPos[X] += width;
+                while (readPos[X] >= width)
+                    readPos[X] -= width;
+            }
+            if (WrapY)
+            {
+                while (readPos[Y] < 0)
+                    readPos[Y] += height;
+                while (readPos[Y] >= height)
+                    readPos[Y] -= height;
+            }
+
+            pixel.m_Step = domSteps;
+            pixel.m_PosX = reportedPos[X];
+            pixel.m_PosY = reportedPos[Y];
+
+            // Pixels outside the scene are air with no MOID, like GetTerrMatter and GetMOIDPixel report them. Axes that wrap are always within it by now
+            bool inScene = (WrapX || static_cast<unsigned int>(readPos[X]) < static_cast<unsigned int>(width)) && (WrapY || static_cast<unsigned int>(readPos[Y]) < static_cast<unsigned int>(height));
+            if (inScene)
+            {
+                pixel.m_Material = pMaterialBitmap->line[readPos[Y]][readPos[X]];
+                if (ReadMOIDs)
+                    pixel.m_MOID = reinterpret_cast<const unsigned short *>(pMOIDBitmap->line[readPos[Y]])[readPos[X]];
+            }
+            else
+            {
+                pixel.m_Material = g_MaterialAir;
+                pixel.m_MOID = g_NoMOID;
             }
-            // Reset skip counter
+
+            if (visitPixel(pixel))
+                return true;
+
             skipped = 0;
+
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (debugColor >= 0 && m_pDebugLayer)
+                m_pDebugLayer->SetPixel(pixel.m_PosX, pixel.m_PosY, debugColor);
 #endif
+
+            // If this pixel is in a tile of all air, jump ahead to the last step still within that tile, as if all the pixels on the way were checked
+            int tileSize = (skipAirTiles && inScene && pixel.m_Material == g_MaterialAir) ? materialOccupancy.GetAirTileSize(readPos[X], readPos[Y]) : 0;
+            if (tileSize > 0)
+            {
+                int tileFirst[2], tileLast[2];
+                tileFirst[X] = readPos[X] - readPos[X] % tileSize;
+                tileFirst[Y] = readPos[Y] - readPos[Y] % tileSize;
+                tileLast[X] = MIN(tileFirst[X] + tileSize, width) - 1;
+                tileLast[Y] = MIN(tileFirst[Y] + tileSize, height) - 1;
+
+                // How many more pixels each axis can move before leaving the tile
+                int domRoom = increment[dom] > 0 ? tileLast[dom] - readPos[dom] : readPos[dom] - tileFirst[dom];
+                int subRoom = increment[sub] > 0 ? tileLast[sub] - readPos[sub] : readPos[sub] - tileFirst[sub];
+
+                // Never jump onto the last pixel, so it's still checked by a regular step
+                int jumpSteps = MIN(domRoom, delta[dom] - domSteps - 2);
+
+                // The error is a running sum of delta2[sub] per step, offset so it stays below delta2[dom] and moves the sub axis each time it wraps around.
+                // So the sub axis leaves the tile after the step where the sum reaches delta2[dom] once more than there is room for
+                long long errorSum = error + delta2[dom] - delta2[sub];
+                if (delta2[sub] > 0)
+                    jumpSteps = MIN(jumpSteps, static_cast<int>((static_cast<long long>(delta2[dom]) * (subRoom + 1) - errorSum - 1) / delta2[sub]));
+
+                if (jumpSteps > 0)
+                {
+                    errorSum += static_cast<long long>(jumpSteps) * delta2[sub];
+                    int subSteps = static_cast<int>(errorSum / delta2[dom]);
+
+                    intPos[dom] += increment[dom] * jumpSteps;
+                    readPos[dom] += increment[dom] * jumpSteps;
+                    intPos[sub] += increment[sub] * subSteps;
+                    readPos[sub] += increment[sub] * subSteps;
+                    error = static_cast<int>(errorSum % delta2[dom]) - delta2[dom] + delta2[sub];
+
+                    domSteps += jumpSteps;
+                    // Keep checking the same pixels after the jump as without it
+                    skipped = skip > 0 ? jumpSteps % (skip + 1) : 0;
+                }
+            }
         }
     }
 
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
-
-    return affectedAny;
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastSeeRay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and reveals pixels on the unseen layer of a team
-//                  as long as the accumulated material strengths traced through the terrain
-//                  don't exceed a specific value.
-
-bool SceneMan::CastSeeRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip)
-{
-	return CastUnseenRay(team, start, ray, endPos, strengthLimit, skip, true);
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastUnseeRay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and hides pixels on the unseen layer of a team
-//                  as long as the accumulated material strengths traced through the terrain
-//                  don't exceed a specific value.
-
-bool SceneMan::CastUnseeRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip)
-{
-	return CastUnseenRay(team, start, ray, endPos, strengthLimit, skip, false);
+    return false;
 }
 
 
-
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastMaterialRay
+// Method:          MarchRayReference
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and gets the location of the first encountered
-//                  pixel of a specific material in the terrain.
+// Description:     The per-pixel loop the ray casts used before MarchRaySteps, which wraps
+//                  and reads every checked pixel through WrapPosition and getpixel, like
+//                  GetTerrMatter and GetMOIDPixel did before they cached the bitmap rows.
+//                  Only kept for BenchmarkRayCasts to compare against.
 
-bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool wrap)
+template <bool ReadMOIDs, typename PixelVisitor>
+bool SceneMan::MarchRayReference(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, PixelVisitor &visitPixel)
 {
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+#ifndef DEBUG_BUILD
+    // Only used to draw debug graphics
+    static_cast<void>(debugColor);
 #endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
+    int error, dom, sub, domSteps, skipped = skip;
     int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
 
     intPos[X] = floorf(start.m_X);
     intPos[Y] = floorf(start.m_Y);
     delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
     delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
+
+    if (delta[X] == 0 && delta[Y] == 0)
         return false;
 
     /////////////////////////////////////////////////////
@@ -1819,11 +1933,16 @@ bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
 
     error = delta2[sub] - delta[dom];
 
+    RayPixel pixel;
+
     /////////////////////////////////////////////////////
     // Bresenham's line drawing algorithm execution
 
     for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
     {
+        pixel.m_PrevPosX = intPos[X];
+        pixel.m_PrevPosY = intPos[Y];
+
         intPos[dom] += increment[dom];
         if (error >= 0)
         {
@@ -1837,35 +1956,119 @@ bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
         {
             // Scene wrapping, if necessary
             if (wrap)
-                g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
+                WrapPosition(intPos[X], intPos[Y]);
 
-            // See if we found the looked-for pixel of the correct material
-            if (GetTerrMatter(intPos[X], intPos[Y]) == material)
-            {
-                // Save result and report success
-                foundPixel = true;
-                result.SetXY(intPos[X], intPos[Y]);
-                // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                break;
-            }
+            pixel.m_Step = domSteps;
+            pixel.m_PosX = intPos[X];
+            pixel.m_PosY = intPos[Y];
+            pixel.m_Material = GetTerrMatterFromBitmap(intPos[X], intPos[Y]);
+            pixel.m_MOID = ReadMOIDs ? GetMOIDPixelFromBitmap(intPos[X], intPos[Y]) : g_NoMOID;
+
+            if (visitPixel(pixel))
+                return true;
 
             skipped = 0;
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (debugColor >= 0 && m_pDebugLayer)
+                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], debugColor);
 #endif
         }
     }
 
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
+    return false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastUnseenRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and reveals or hides pixels on the unseen layer of a team
+//                  as long as the accumulated material strengths traced through the terrain
+//                  don't exceed a specific value.
+
+bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip, bool reveal)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastUnseenRay");
+
+    if (!m_pCurrentScene->GetUnseenLayer(team))
+        return false;
+
+    bool affectedAny = false;
+    int totalStrength = 0;
+    // Save the projected end of the ray pos
+    endPos = start + ray;
+
+    MarchRay<false>(start, ray, skip, true, 13, false, [&](const RayPixel &pixel) {
+        // Reveal if we can, save the result
+        if (reveal)
+            affectedAny = RevealUnseen(pixel.m_PosX, pixel.m_PosY, team) || affectedAny;
+        else
+            affectedAny = RestoreUnseen(pixel.m_PosX, pixel.m_PosY, team) || affectedAny;
+
+        // Add the encountered material's strength to the tally
+        totalStrength += GetMaterialFromID(pixel.m_Material)->strength;
+        // See if we have hit the limits of our ray's strength
+        if (totalStrength >= strengthLimit)
+        {
+            // Save the position of the end of the ray where blocked
+            endPos.SetXY(pixel.m_PosX, pixel.m_PosY);
+            return true;
+        }
+        return false;
+    });
+
+    return affectedAny;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastSeeRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and reveals pixels on the unseen layer of a team
+//                  as long as the accumulated material strengths traced through the terrain
+//                  don't exceed a specific value.
+
+bool SceneMan::CastSeeRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip)
+{
+	return CastUnseenRay(team, start, ray, endPos, strengthLimit, skip, true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastUnseeRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and hides pixels on the unseen layer of a team
+//                  as long as the accumulated material strengths traced through the terrain
+//                  don't exceed a specific value.
+
+bool SceneMan::CastUnseeRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip)
+{
+	return CastUnseenRay(team, start, ray, endPos, strengthLimit, skip, false);
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastMaterialRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and gets the location of the first encountered
+//                  pixel of a specific material in the terrain.
 
-    return foundPixel;
+bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool wrap)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastMaterialRay");
+
+    // Air tiles can be jumped over unless air is what's looked for
+    return MarchRay<false>(start, ray, skip, wrap, 13, material != g_MaterialAir, [&](const RayPixel &pixel) {
+        // See if we found the looked-for pixel of the correct material
+        if (pixel.m_Material != material)
+            return false;
+
+        // Save result and last ray pos
+        result.SetXY(pixel.m_PosX, pixel.m_PosY);
+        m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+        return true;
+    });
 }
 
 
@@ -1898,219 +2101,81 @@ float SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
 
 bool SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool checkMOs)
 {
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastNotMaterialRay");
 
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
+    auto visitPixel = [&](const RayPixel &pixel) {
+        // See if we found a pixel of another material, or an MO is blocking the way
+        if (pixel.m_Material == material && pixel.m_MOID == g_NoMOID)
+            return false;
 
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
+        // Save result and last ray pos
+        result.SetXY(pixel.m_PosX, pixel.m_PosY);
+        m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+        return true;
+    };
 
-    if (delta[X] == 0 &&  delta[Y] == 0)
-        return false;
+    // The MOID layer is only read when MOs are checked, otherwise every pixel has no MOID and air tiles can be jumped over when looking for anything but air
+    return checkMOs ? MarchRay<true>(start, ray, skip, true, 13, false, visitPixel) : MarchRay<false>(start, ray, skip, true, 13, material == g_MaterialAir, visitPixel);
+}
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
 
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastNotMaterialRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and returns how far along that ray there is an
+//                  encounter with a pixel of OTHER than a specific material in the terrain.
 
-    if (delta[Y] < 0)
+float SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsigned char material, int skip, bool checkMOs)
+{
+    Vector result;
+    if (CastNotMaterialRay(start, ray, material, result, skip, checkMOs))
     {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
+        // Calculate the length between the start and the found material pixel coords
+        result -= start;
+        return result.GetMagnitude();
     }
-    else
-        increment[Y] = 1;
 
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
+    // Signal that we didn't hit anything
+    return -1;
+}
 
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
 
-    error = delta2[sub] - delta[dom];
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastStrengthSumRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and returns how the sum of all encountered pixels'
+//                  material strength values. This will take wrapping into account.
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
+float SceneMan::CastStrengthSumRay(const Vector &start, const Vector &end, int skip, unsigned char ignoreMaterial)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastStrengthSumRay");
 
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
+    Vector ray = g_SceneMan.ShortestDistance(start, end);
+    float strengthSum = 0;
 
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            // See if we found the looked-for pixel of the correct material,
-            // Or an MO is blocking the way
-            if (GetTerrMatter(intPos[X], intPos[Y]) != material ||
-                (checkMOs && g_SceneMan.GetMOIDPixel(intPos[X], intPos[Y]) != g_NoMOID))
-            {
-                // Save result and report success
-                foundPixel = true;
-                result.SetXY(intPos[X], intPos[Y]);
-                // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                break;
-            }
-
-            skipped = 0;
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
-#endif
-        }
-    }
-
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
-
-    return foundPixel;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastNotMaterialRay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and returns how far along that ray there is an
-//                  encounter with a pixel of OTHER than a specific material in the terrain.
-
-float SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsigned char material, int skip, bool checkMOs)
-{
-    Vector result;
-    if (CastNotMaterialRay(start, ray, material, result, skip, checkMOs))
-    {
-        // Calculate the length between the start and the found material pixel coords
-        result -= start;
-        return result.GetMagnitude();
-    }
+    // Air adds nothing to the sum, so air tiles can be jumped over
+    MarchRay<false>(start, ray, skip, true, -1, true, [&](const RayPixel &pixel) {
+        // Sum all strengths
+        if (pixel.m_Material != g_MaterialAir && pixel.m_Material != ignoreMaterial)
+            strengthSum += GetMaterialFromID(pixel.m_Material)->strength;
+        return false;
+    });
 
-    // Signal that we didn't hit anything
-    return -1;
+    return strengthSum;
 }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastStrengthSumRay
+// Method:          CastMaxStrengthRay
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and returns how the sum of all encountered pixels'
-//                  material strength values. This will take wrapping into account.
+// Description:     Traces along a vector and returns the strongest of all encountered pixels'
+//                  material strength values exept doors.
+//                  This will take wrapping into account.
 
-float SceneMan::CastStrengthSumRay(const Vector &start, const Vector &end, int skip, unsigned char ignoreMaterial)
+float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int skip)
 {
-    Vector ray = g_SceneMan.ShortestDistance(start, end);
-    float strengthSum = 0;
-
-    int error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
-    unsigned char materialID;
-    Material foundMaterial;
-
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
-        return false;
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
-
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
-
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
-
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
-
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else
-    {
-        dom = Y;
-        sub = X;
-    }
-
-    error = delta2[sub] - delta[dom];
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
-
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
-
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            // Sum all strengths
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
-            if (materialID != g_MaterialAir && materialID != ignoreMaterial)
-                strengthSum += GetMaterialFromID(materialID)->strength;
-
-            skipped = 0;
-        }
-    }
-
-    return strengthSum;
+    static const std::vector<std::pair<Box, unsigned char>> noIgnoredMaterialAreas;
+    return CastMaxStrengthRay(start, end, skip, noIgnoredMaterialAreas);
 }
 
 
@@ -2118,92 +2183,27 @@ float SceneMan::CastStrengthSumRay(const Vector &start, const Vector &end, int s
 // Method:          CastMaxStrengthRay
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Traces along a vector and returns the strongest of all encountered pixels'
-//                  material strength values exept doors.
-//                  This will take wrapping into account.
+//                  material strength values exept doors and pixels of specific materials
+//                  within specific areas.
 
-float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int skip)
+float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int skip, const std::vector<std::pair<Box, unsigned char>> &ignoredMaterialAreas)
 {
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastMaxStrengthRay");
+
     Vector ray = g_SceneMan.ShortestDistance(start, end);
     float maxStrength = 0;
 
-    int error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
-    unsigned char materialID;
-    Material foundMaterial;
+    // Air tiles can be jumped over as long as air can't raise the max strength
+    MarchRay<false>(start, ray, skip, true, -1, GetMaterialFromID(g_MaterialAir)->strength <= 0, [&](const RayPixel &pixel) {
+        bool ignoredPixel = pixel.m_Material == g_MaterialDoor;
+        for (std::vector<std::pair<Box, unsigned char>>::const_iterator areaItr = ignoredMaterialAreas.begin(); !ignoredPixel && areaItr != ignoredMaterialAreas.end(); ++areaItr)
+            ignoredPixel = pixel.m_Material == areaItr->second && areaItr->first.IsWithinBox(Vector(pixel.m_PosX, pixel.m_PosY));
 
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
+        if (!ignoredPixel)
+            maxStrength = MAX(maxStrength, GetMaterialFromID(pixel.m_Material)->strength);
         return false;
+    });
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
-
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
-
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
-
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
-
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else
-    {
-        dom = Y;
-        sub = X;
-    }
-
-    error = delta2[sub] - delta[dom];
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
-
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
-
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            // Sum all strengths
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
-            if (materialID != g_MaterialDoor)
-                maxStrength = MAX(maxStrength, GetMaterialFromID(materialID)->strength);
-
-            skipped = 0;
-        }
-    }
-    
     return maxStrength;
 }
 
@@ -2215,507 +2215,131 @@ float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int s
 //                  encounter with a pixel of a material with strength more than or equal
 //                  to a specific value.
 
-
 bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, unsigned char ignoreMaterial, bool wrap)
 {
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
-    unsigned char materialID;
-    Material const * foundMaterial;
-
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
-        return false;
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastStrengthRay");
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
+    // Air tiles can be jumped over as long as air can't stop the ray. The last pixel is still checked, so the result is the same without a hit
+    return MarchRay<false>(start, ray, skip, wrap, 13, ignoreMaterial == g_MaterialAir || GetMaterialFromID(g_MaterialAir)->strength < strength, [&](const RayPixel &pixel) {
+        // Save every checked pixel as the result, so if none are strong enough the result is the last one tried
+        result.SetXY(pixel.m_PosX, pixel.m_PosY);
 
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
+        // See if we found the looked-for pixel of the correct material
+        if (pixel.m_Material == ignoreMaterial || GetMaterialFromID(pixel.m_Material)->strength < strength)
+            return false;
 
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
+        // Save last ray pos
+        m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+        return true;
+    });
+}
 
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
 
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastWeaknessRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and shows where along that ray there is an
+//                  encounter with a pixel of a material with strength less than or equal
+//                  to a specific value.
 
-    error = delta2[sub] - delta[dom];
+bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, bool wrap)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastWeaknessRay");
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
+    return MarchRay<false>(start, ray, skip, wrap, 13, false, [&](const RayPixel &pixel) {
+        // Save every checked pixel as the result, so if none are weak enough the result is the last one tried
+        result.SetXY(pixel.m_PosX, pixel.m_PosY);
 
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
+        // See if we found the looked-for pixel of the correct material
+        if (GetMaterialFromID(pixel.m_Material)->strength > strength)
+            return false;
 
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            if (wrap)
-                g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
-            // Ignore the ignore material
-            if (materialID != ignoreMaterial)
-            {
-                // Get the material object
-                foundMaterial = GetMaterialFromID(materialID);
-
-                // See if we found a pixel of equal or more strength than the threshold
-                if (foundMaterial->strength >= strength)
-                {
-                    // Save result and report success
-                    foundPixel = true;
-                    result.SetXY(intPos[X], intPos[Y]);
-                    // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                    break;
-                }
-            }
-            skipped = 0;
-
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
-#endif
-        }
-    }
-
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
-
-    // If no pixel of sufficient strength was found, set the result to the final tried position
-    if (!foundPixel)
-        result.SetXY(intPos[X], intPos[Y]);
-
-    return foundPixel;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastWeaknessRay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and shows where along that ray there is an
-//                  encounter with a pixel of a material with strength less than or equal
-//                  to a specific value.
-
-bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, bool wrap)
-{
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
-    unsigned char materialID;
-    Material const *foundMaterial;
-
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 &&  delta[Y] == 0)
-        return false;
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
-
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
-
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
-
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
-
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
-
-    error = delta2[sub] - delta[dom];
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
-
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
-
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            if (wrap)
-                g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
-            foundMaterial = GetMaterialFromID(materialID);
-
-            // See if we found a pixel of equal or less strength than the threshold
-            if (foundMaterial->strength <= strength)
-            {
-                // Save result and report success
-                foundPixel = true;
-                result.SetXY(intPos[X], intPos[Y]);
-                // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                break;
-            }
-
-            skipped = 0;
-
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
-#endif
-        }
-    }
-
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
-
-    // If no pixel of sufficient strength was found, set the result to the final tried position
-    if (!foundPixel)
-        result.SetXY(intPos[X], intPos[Y]);
-
-    return foundPixel;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastMORay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and returns MOID of the first non-ignored
-//                  non-NoMOID MO encountered. If a non-air terrain pixel is encountered
-//                  first, 0 will be returned.
-
-MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
-{
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    MOID hitMOID = g_NoMOID;
-    unsigned char hitTerrain = 0;
-
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 && delta[Y] == 0)
-        return g_NoMOID;
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
-
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
-
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
-
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
-
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
-
-    error = delta2[sub] - delta[dom];
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
-
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
-
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
-
-            // Detect MOIDs
-            hitMOID = GetMOIDPixel(intPos[X], intPos[Y]);
-            if (hitMOID != g_NoMOID && hitMOID != ignoreMOID && g_MovableMan.GetRootMOID(hitMOID) != ignoreMOID)
-            {
-                // Check if we're supposed to ignore the team of what we hit
-                if (ignoreTeam != Activity::NOTEAM)
-                {
-                    const MovableObject *pHitMO = g_MovableMan.GetMOFromID(hitMOID);
-                    pHitMO = pHitMO ? pHitMO->GetRootParent() : 0;
-                    // Yup, we are supposed to ignore this!
-                    if (pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam)
-                    {
-                        ;
-                    }
-                    else
-                    {
-                        // Save last ray pos
-                        m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                        return hitMOID;
-                    }
-                }
-                // Legit hit
-                else
-                {
-                    // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                    return hitMOID;
-                }
-            }
-
-            // Detect terrain hits
-            if (!ignoreAllTerrain)
-            {
-                hitTerrain = g_SceneMan.GetTerrMatter(intPos[X], intPos[Y]);
-                if (hitTerrain != g_MaterialAir && hitTerrain != ignoreMaterial)
-                {
-                    // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                    return g_NoMOID;
-                }
-            }
-
-            skipped = 0;
-
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
-#endif
-        }
-    }
-
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
-
-    // Didn't hit anything but air
-    return g_NoMOID;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CastFindMORay
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Traces along a vector and shows where a specific MOID has been found.
-
-bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID targetMOID, Vector &resultPos, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
-{
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    MOID hitMOID = g_NoMOID;
-    unsigned char hitTerrain = 0;
-
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
-    
-    if (delta[X] == 0 && delta[Y] == 0)
-        return g_NoMOID;
-
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
-
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
-
-    if (delta[Y] < 0)
-    {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
-    }
-    else
-        increment[Y] = 1;
-
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
-
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
+        // Save last ray pos
+        m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+        return true;
+    });
+}
 
-    error = delta2[sub] - delta[dom];
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastMORay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and returns MOID of the first non-ignored
+//                  non-NoMOID MO encountered. If a non-air terrain pixel is encountered
+//                  first, 0 will be returned.
 
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
-    {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
-        {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
-        }
-        error += delta2[sub];
+MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastMORay");
 
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
-        {
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
+    MOID hitMOID = g_NoMOID;
 
-            // Detect MOIDs
-            hitMOID = GetMOIDPixel(intPos[X], intPos[Y]);
-            if (hitMOID == targetMOID || g_MovableMan.GetRootMOID(hitMOID) == targetMOID)
+    MarchRay<true>(start, ray, skip, true, 120, false, [&](const RayPixel &pixel) {
+        // Detect MOIDs
+        if (pixel.m_MOID != g_NoMOID && pixel.m_MOID != ignoreMOID && g_MovableMan.GetRootMOID(pixel.m_MOID) != ignoreMOID)
+        {
+            // Check if we're supposed to ignore the team of what we hit
+            const MovableObject *pHitMO = (ignoreTeam != Activity::NOTEAM) ? g_MovableMan.GetMOFromID(pixel.m_MOID) : 0;
+            pHitMO = pHitMO ? pHitMO->GetRootParent() : 0;
+            // Legit hit, unless we are supposed to ignore it because it ignores hits from the team
+            if (!(pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam))
             {
-                // Found target MOID, so save result and report success
-                resultPos.SetXY(intPos[X], intPos[Y]);
+                hitMOID = pixel.m_MOID;
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
                 return true;
             }
+        }
 
-            // Detect terrain hits
-            if (!ignoreAllTerrain)
-            {
-                hitTerrain = g_SceneMan.GetTerrMatter(intPos[X], intPos[Y]);
-                if (hitTerrain != g_MaterialAir && hitTerrain != ignoreMaterial)
-                {
-                    // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                    return false;
-                }
-            }
+        // Detect terrain hits
+        if (!ignoreAllTerrain && pixel.m_Material != g_MaterialAir && pixel.m_Material != ignoreMaterial)
+        {
+            // Save last ray pos
+            m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+            return true;
+        }
+        return false;
+    });
 
-            skipped = 0;
+    // Didn't hit anything but air, or hit terrain
+    return hitMOID;
+}
 
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
-#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastFindMORay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and shows where a specific MOID has been found.
+
+bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID targetMOID, Vector &resultPos, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastFindMORay");
+
+    bool foundMOID = false;
+
+    MarchRay<true>(start, ray, skip, true, 120, false, [&](const RayPixel &pixel) {
+        // Detect MOIDs
+        if (pixel.m_MOID == targetMOID || g_MovableMan.GetRootMOID(pixel.m_MOID) == targetMOID)
+        {
+            // Found target MOID, so save result and report success
+            foundMOID = true;
+            resultPos.SetXY(pixel.m_PosX, pixel.m_PosY);
+            // Save last ray pos
+            m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+            return true;
         }
-    }
 
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
+        // Detect terrain hits
+        if (!ignoreAllTerrain && pixel.m_Material != g_MaterialAir && pixel.m_Material != ignoreMaterial)
+        {
+            // Save last ray pos
+            m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+            return true;
+        }
+        return false;
+    });
 
-    // Didn't hit the target
-    return false;
+    return foundMOID;
 }
 
 
@@ -2727,148 +2351,250 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
 
 float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &obstaclePos, Vector &freePos, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, int skip)
 {
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
-#endif
-
-    int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
-    int intPos[2], delta[2], delta2[2], increment[2];
-    bool hitObstacle = false;
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastObstacleRay");
 
-    intPos[X] = floorf(start.m_X);
-    intPos[Y] = floorf(start.m_Y);
-    delta[X] = floorf(start.m_X + ray.m_X) - intPos[X];
-    delta[Y] = floorf(start.m_Y + ray.m_Y) - intPos[Y];
     // The fraction of a pixel that we start from, to be added to the integer result positions for accuracy
-    Vector startFraction(start.m_X - intPos[X], start.m_Y - intPos[Y]);
+    Vector startFraction(start.m_X - floorf(start.m_X), start.m_Y - floorf(start.m_Y));
+    // How many steps were taken before the last checked pixel, which is the obstacle's if one was hit
+    int lastCheckedStep = -1;
 
-    if (delta[X] == 0 && delta[Y] == 0)
+    bool hitObstacle = MarchRay<true>(start, ray, skip, true, 13, false, [&](const RayPixel &pixel) {
+        lastCheckedStep = pixel.m_Step;
+        MOID checkMOID = pixel.m_MOID;
+
+        // Translate any found MOID into the root MOID of that hit MO
+        if (checkMOID != g_NoMOID)
+        {
+            MovableObject *pHitMO = g_MovableMan.GetMOFromID(checkMOID);
+            if (pHitMO)
+            {
+                checkMOID = pHitMO->GetRootID();
+                // Check if we're supposed to ignore the team of what we hit
+                if (ignoreTeam != Activity::NOTEAM)
+                {
+                    pHitMO = pHitMO->GetRootParent();
+                    // We are indeed supposed to ignore this object because of its ignoring of its specific team
+                    if (pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam)
+                        checkMOID = g_NoMOID;
+                }
+            }
+        }
+
+        // See if we found the looked-for pixel of the correct material,
+        // Or an MO is blocking the way
+        if ((pixel.m_Material != g_MaterialAir && pixel.m_Material != ignoreMaterial) || (checkMOID != g_NoMOID && checkMOID != ignoreMOID))
+        {
+            obstaclePos.SetXY(pixel.m_PosX, pixel.m_PosY);
+            // Save last ray pos
+            m_LastRayHitPos.SetIntXY(pixel.m_PosX, pixel.m_PosY);
+            // The last free position is the step before the obstacle, checked or skipped, if there was one
+            if (pixel.m_Step != 0)
+                freePos.SetXY(pixel.m_PrevPosX, pixel.m_PrevPosY);
+            return true;
+        }
+
+        freePos.SetXY(pixel.m_PosX, pixel.m_PosY);
         return false;
+    });
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm preparation
+    // A ray too short to leave its starting pixel has nothing to check, and counts as having an obstacle right at the start
+    if (lastCheckedStep < 0)
+        return 0;
 
-    if (delta[X] < 0)
-    {
-        increment[X] = -1;
-        delta[X] = -delta[X];
-    }
-    else
-        increment[X] = 1;
+    // Add the pixel fraction to the free position if there were any free pixels
+    if (!hitObstacle || lastCheckedStep != 0)
+        freePos += startFraction;
 
-    if (delta[Y] < 0)
+    if (hitObstacle)
     {
-        increment[Y] = -1;
-        delta[Y] = -delta[Y];
+        // Add the pixel fraction to the obstacle position, to acoid losing precision
+        obstaclePos += startFraction;
+        // If there was an obstacle on the start position, return 0 as the distance to obstacle
+        if (lastCheckedStep == 0)
+            return 0;
+        // Calculate the length between the start and the found material pixel coords
+        else
+            return g_SceneMan.ShortestDistance(obstaclePos, start).GetMagnitude();
     }
-    else
-        increment[Y] = 1;
 
-    // Scale by 2, for better accuracy of the error at the first pixel
-    delta2[X] = delta[X] << 1;
-    delta2[Y] = delta[Y] << 1;
+    // Didn't hit anything but air
+    return -1.0;
+}
 
-    // If X is dominant, Y is submissive, and vice versa.
-    if (delta[X] > delta[Y]) {
-        dom = X;
-        sub = Y;
-    }
-    else {
-        dom = Y;
-        sub = X;
-    }
 
-    error = delta2[sub] - delta[dom];
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BenchmarkRayCasts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the same set of random rays over the current scene with each of
+//                  the ray casting methods, once through the shared ray march kernel and
+//                  once through the reference loop, and prints how long each took.
 
-    /////////////////////////////////////////////////////
-    // Bresenham's line drawing algorithm execution
+int SceneMan::BenchmarkRayCasts(int rayCount)
+{
+    if (!m_pCurrentScene || rayCount <= 0)
+        return 0;
 
-    for (domSteps = 0; domSteps < delta[dom]; ++domSteps)
+    // A generator of its own keeps the benchmark from moving the sim's random number sequence along, and makes every run cast the same rays
+    std::mt19937 benchmarkRandom(0);
+    std::uniform_real_distribution<float> randomX(0, static_cast<float>(GetSceneWidth()));
+    std::uniform_real_distribution<float> randomY(0, static_cast<float>(GetSceneHeight()));
+    std::uniform_real_distribution<float> randomLength(5.0F, 800.0F);
+    std::uniform_real_distribution<float> randomAngle(-c_PI, c_PI);
+
+    // Rays start anywhere in the scene and go any direction for up to about a screen's width, to cover both short script rays and long AI look rays
+    std::vector<std::pair<Vector, Vector>> rays;
+    rays.reserve(rayCount);
+    for (int rayIndex = 0; rayIndex < rayCount; ++rayIndex)
     {
-        intPos[dom] += increment[dom];
-        if (error >= 0)
+        Vector rayStart(randomX(benchmarkRandom), randomY(benchmarkRandom));
+        Vector rayVector(randomLength(benchmarkRandom), 0);
+        rayVector.RadRotate(randomAngle(benchmarkRandom));
+        rays.push_back(std::make_pair(rayStart, rayVector));
+    }
+
+    // Each cast's result is boiled down to one number per ray, so the results of the two paths can be compared
+    std::vector<double> referenceResults(rayCount);
+    std::vector<double> kernelResults(rayCount);
+    int totalMismatches = 0;
+
+    g_ConsoleMan.PrintString("SYSTEM: Casting " + std::to_string(rayCount) + " rays per cast method on " + m_pCurrentScene->GetPresetName() + ", reference loop -> ray march kernel:");
+
+    // Times one cast method through both paths, then compares their results and prints how they did
+    auto benchmarkCast = [&](const char *castName, auto castRay) {
+        long long pathTimes[2];
+        for (int path = 0; path < 2; ++path)
         {
-            intPos[sub] += increment[sub];
-            error -= delta2[dom];
+            m_UseReferenceRayMarch = path == 0;
+            std::vector<double> &results = m_UseReferenceRayMarch ? referenceResults : kernelResults;
+            long long startTime = g_TimerMan.GetAbsoulteTime();
+            for (int rayIndex = 0; rayIndex < rayCount; ++rayIndex)
+                results[rayIndex] = castRay(rays[rayIndex].first, rays[rayIndex].second);
+            pathTimes[path] = g_TimerMan.GetAbsoulteTime() - startTime;
         }
-        error += delta2[sub];
+        m_UseReferenceRayMarch = false;
 
-        // Only check pixel if we're not due to skip any, or if this is the last pixel
-        if (++skipped > skip || domSteps + 1 == delta[dom])
+        int mismatches = 0;
+        for (int rayIndex = 0; rayIndex < rayCount; ++rayIndex)
         {
-            // Scene wrapping, if necessary
-            g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
+            if (referenceResults[rayIndex] != kernelResults[rayIndex])
+                ++mismatches;
+        }
+        totalMismatches += mismatches;
 
-            unsigned char checkMat = GetTerrMatter(intPos[X], intPos[Y]);
-            MOID checkMOID = GetMOIDPixel(intPos[X], intPos[Y]);
+        char str[256];
+        sprintf_s(str, sizeof(str), "%s: %lli us -> %lli us (x%.2f), %i mismatches", castName, pathTimes[0], pathTimes[1], pathTimes[1] > 0 ? static_cast<double>(pathTimes[0]) / static_cast<double>(pathTimes[1]) : 0.0, mismatches);
+        g_ConsoleMan.PrintString(str);
+    };
+
+    Vector resultPos;
+    Vector freePos;
+    const double sceneWidth = GetSceneWidth();
+    auto positionResult = [&](bool found) { return found ? resultPos.m_X + resultPos.m_Y * sceneWidth : -1.0; };
+
+    benchmarkCast("CastMaterialRay", [&](const Vector &start, const Vector &ray) { return positionResult(CastMaterialRay(start, ray, g_MaterialGold, resultPos)); });
+    benchmarkCast("CastNotMaterialRay", [&](const Vector &start, const Vector &ray) { return positionResult(CastNotMaterialRay(start, ray, g_MaterialAir, resultPos, 0, true)); });
+    benchmarkCast("CastStrengthSumRay", [&](const Vector &start, const Vector &ray) { return static_cast<double>(CastStrengthSumRay(start, start + ray)); });
+    benchmarkCast("CastMaxStrengthRay", [&](const Vector &start, const Vector &ray) { return static_cast<double>(CastMaxStrengthRay(start, start + ray, 0)); });
+    benchmarkCast("CastStrengthRay", [&](const Vector &start, const Vector &ray) { return positionResult(CastStrengthRay(start, ray, 50.0F, resultPos)); });
+    benchmarkCast("CastWeaknessRay", [&](const Vector &start, const Vector &ray) { return positionResult(CastWeaknessRay(start, ray, 5.0F, resultPos)); });
+    benchmarkCast("CastMORay", [&](const Vector &start, const Vector &ray) { return static_cast<double>(CastMORay(start, ray)); });
+    benchmarkCast("CastFindMORay", [&](const Vector &start, const Vector &ray) { return positionResult(CastFindMORay(start, ray, GetMOIDPixel((start + ray).GetFloorIntX(), (start + ray).GetFloorIntY()), resultPos)); });
+    benchmarkCast("CastObstacleRay", [&](const Vector &start, const Vector &ray) { return static_cast<double>(CastObstacleRay(start, ray, resultPos, freePos)); });
+
+    g_ConsoleMan.PrintString("SYSTEM: Ray cast benchmark done, " + std::to_string(totalMismatches) + " mismatches in total.");
+    return totalMismatches;
+}
 
-            // Translate any found MOID into the root MOID of that hit MO
-            if (checkMOID != g_NoMOID)
-            {
-                MovableObject *pHitMO = g_MovableMan.GetMOFromID(checkMOID);
-                if (pHitMO)
-                {
-                    checkMOID = pHitMO->GetRootID();
-                    // Check if we're supposed to ignore the team of what we hit
-                    if (ignoreTeam != Activity::NOTEAM)
-                    {
-                        pHitMO = pHitMO->GetRootParent();
-                        // We are indeed supposed to ignore this object because of its ignoring of its specific team
-                        if (pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam)
-                            checkMOID = g_NoMOID;
-                    }
-                }
-            }
 
-            // See if we found the looked-for pixel of the correct material,
-            // Or an MO is blocking the way
-            if ((checkMat != g_MaterialAir && checkMat != ignoreMaterial) || (checkMOID != g_NoMOID && checkMOID != ignoreMOID))
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastRays
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts a batch of rays in one go, locking the scene only once for all of
+//                  them. Can spread the rays across the worker threads.
+
+void SceneMan::CastRays(std::vector<RayQuery> &rayQueries, bool parallel)
+{
+    PerformanceMan::ProfileZone profileZone("SceneMan::CastRays");
+
+    bool lockedScene = !SceneIsLocked();
+    if (lockedScene)
+        LockScene();
+
+    if (parallel && g_ThreadMan.GetWorkerThreadCount() > 0)
+    {
+        // Hand the rays to the workers in runs, so each task is worth more than the overhead of handing it out
+        const size_t raysPerTask = 32;
+        g_ThreadMan.ParallelFor((rayQueries.size() + raysPerTask - 1) / raysPerTask, [&](size_t taskIndex) {
+            // The debug layer can only be drawn on from one thread at a time, so none of the parallel rays are drawn
+            m_SkipRayDebugDrawing = true;
+            size_t taskEnd = std::min((taskIndex + 1) * raysPerTask, rayQueries.size());
+            for (size_t queryIndex = taskIndex * raysPerTask; queryIndex < taskEnd; ++queryIndex)
             {
-                hitObstacle = true;
-                obstaclePos.SetXY(intPos[X], intPos[Y]);
-                // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
-                break;
+                if (rayQueries[queryIndex].m_Type != RayQuery::SEERAY)
+                    CastRayQuery(rayQueries[queryIndex]);
             }
-            else
-                freePos.SetXY(intPos[X], intPos[Y]);
-
-            skipped = 0;
+            m_SkipRayDebugDrawing = false;
+        });
 
-#ifdef DEBUG_BUILD
-            // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
-#endif
+        // See rays reveal unseen pixels and play the reveal sound, neither of which can be done from the workers
+        for (std::vector<RayQuery>::iterator queryItr = rayQueries.begin(); queryItr != rayQueries.end(); ++queryItr)
+        {
+            if (queryItr->m_Type == RayQuery::SEERAY)
+                CastRayQuery(*queryItr);
         }
-        else
-            freePos.SetXY(intPos[X], intPos[Y]);
+    }
+    else
+    {
+        for (std::vector<RayQuery>::iterator queryItr = rayQueries.begin(); queryItr != rayQueries.end(); ++queryItr)
+            CastRayQuery(*queryItr);
     }
 
-#ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
-#endif
+    if (lockedScene)
+        UnlockScene();
+}
 
-    // Add the pixel fraction to the free position if there were any free pixels
-    if (domSteps != 0)
-        freePos += startFraction;
 
-    if (hitObstacle)
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastRayQuery
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts one ray of a batch with the single ray casting method its type
+//                  calls for, and fills in its results.
+
+void SceneMan::CastRayQuery(RayQuery &rayQuery)
+{
+    rayQuery.m_Hit = false;
+    rayQuery.m_HitPos = rayQuery.m_Start + rayQuery.m_Ray;
+    rayQuery.m_HitMOID = g_NoMOID;
+    rayQuery.m_HitDistance = -1;
+    rayQuery.m_FreePos = rayQuery.m_HitPos;
+
+    switch (rayQuery.m_Type)
     {
-        // Add the pixel fraction to the obstacle position, to acoid losing precision
-        obstaclePos += startFraction;
-        // If there was an obstacle on the start position, return 0 as the distance to obstacle
-        if (domSteps == 0)
-            return 0;
-        // Calculate the length between the start and the found material pixel coords
-        else
-            return g_SceneMan.ShortestDistance(obstaclePos, start).GetMagnitude();
+        case RayQuery::MORAY:
+            rayQuery.m_HitMOID = CastMORay(rayQuery.m_Start, rayQuery.m_Ray, rayQuery.m_IgnoreMOID, rayQuery.m_Team, rayQuery.m_Material, false, rayQuery.m_Skip);
+            rayQuery.m_Hit = rayQuery.m_HitMOID != g_NoMOID;
+            if (rayQuery.m_Hit)
+                rayQuery.m_HitPos = m_LastRayHitPos;
+            break;
+        case RayQuery::OBSTACLERAY:
+            rayQuery.m_HitDistance = CastObstacleRay(rayQuery.m_Start, rayQuery.m_Ray, rayQuery.m_HitPos, rayQuery.m_FreePos, rayQuery.m_IgnoreMOID, rayQuery.m_Team, rayQuery.m_Material, rayQuery.m_Skip);
+            rayQuery.m_Hit = rayQuery.m_HitDistance >= 0;
+            break;
+        case RayQuery::SEERAY:
+            // Teams out of range have no unseen layer to reveal
+            if (rayQuery.m_Team >= Activity::TEAM_1 && rayQuery.m_Team < Activity::MAXTEAMCOUNT)
+                rayQuery.m_Hit = CastSeeRay(rayQuery.m_Team, rayQuery.m_Start, rayQuery.m_Ray, rayQuery.m_HitPos, static_cast<int>(rayQuery.m_Strength), rayQuery.m_Skip);
+            break;
+        case RayQuery::MATERIALRAY:
+            rayQuery.m_Hit = CastMaterialRay(rayQuery.m_Start, rayQuery.m_Ray, rayQuery.m_Material, rayQuery.m_HitPos, rayQuery.m_Skip);
+            break;
+        case RayQuery::STRENGTHRAY:
+            rayQuery.m_Hit = CastStrengthRay(rayQuery.m_Start, rayQuery.m_Ray, rayQuery.m_Strength, rayQuery.m_HitPos, rayQuery.m_Skip, rayQuery.m_Material);
+            break;
+        default:
+            // Rays of unknown types find nothing
+            break;
     }
-
-    // Didn't hit anything but air
-    return -1.0;
 }
 
 
@@ -3585,18 +3311,7 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
     SceneLayer *pUnseenLayer = team != Activity::NOTEAM ? m_pCurrentScene->GetUnseenLayer(team) : 0;
 
     // Set up the target box to draw to on the target bitmap, if it is larger than the scene in either dimension
-    Box targetBox(Vector(0, 0), pTargetBitmap->w, pTargetBitmap->h);
-
-    if (!pTerrain->WrapsX() && pTargetBitmap->w > GetSceneWidth())
-    {
-        targetBox.m_Corner.m_X = (pTargetBitmap->w - GetSceneWidth()) / 2;
-        targetBox.m_Width = GetSceneWidth();
-    }
-    if (!pTerrain->WrapsY() && pTargetBitmap->h > GetSceneHeight())
-    {
-        targetBox.m_Corner.m_Y = (pTargetBitmap->h - GetSceneHeight()) / 2;
-        targetBox.m_Height = GetSceneHeight();
-    }
+    Box targetBox = GetDrawTargetBox(pTargetBitmap);
 
     switch (m_LayerDrawMode)
     {
@@ -3638,10 +3353,7 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
             }
 
             // Actor and gameplay HUDs and GUIs
-            g_MovableMan.DrawHUD(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
-			g_PrimitiveMan.DrawPrimitives(m_LastUpdatedScreen, pTargetGUIBitmap, targetPos);
-//            g_ActivityMan.GetActivity()->Draw(pTargetBitmap, targetPos, m_LastUpdatedScreen);
-            g_ActivityMan.GetActivity()->DrawGUI(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
+            DrawHUD(pTargetGUIBitmap, targetPos);
 
 //            sprintf_s(str, sizeof(str), "Normal Layer Draw Mode\nHit M to cycle modes");
 
@@ -3652,6 +3364,64 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawMOColorLayer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws only the MO color layer as seen from a specific screen.
+
+void SceneMan::DrawMOColorLayer(BITMAP *pTargetBitmap, int screen) const
+{
+    if (m_pCurrentScene == nullptr) {
+        return;
+    }
+    // The layer offsets only hold the last updated screen's, so draw with the screen's own offset instead
+    Box targetBox = GetDrawTargetBox(pTargetBitmap);
+    m_pMOColorLayer->DrawWithOffset(pTargetBitmap, targetBox, m_Offset[screen]);
+
+#ifdef DEBUG_BUILD
+    Box debugBox;
+    m_pDebugLayer->DrawWithOffset(pTargetBitmap, debugBox, m_Offset[screen]);
+#endif
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawHUD
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws the actor and gameplay HUDs and GUIs of the last updated screen.
+
+void SceneMan::DrawHUD(BITMAP *pTargetGUIBitmap, const Vector &targetPos)
+{
+    g_MovableMan.DrawHUD(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
+    g_PrimitiveMan.DrawPrimitives(m_LastUpdatedScreen, pTargetGUIBitmap, targetPos);
+//    g_ActivityMan.GetActivity()->Draw(pTargetBitmap, targetPos, m_LastUpdatedScreen);
+    g_ActivityMan.GetActivity()->DrawGUI(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDrawTargetBox
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the box on a target bitmap the scene should be drawn in.
+
+Box SceneMan::GetDrawTargetBox(const BITMAP *pTargetBitmap) const
+{
+    Box targetBox(Vector(0, 0), pTargetBitmap->w, pTargetBitmap->h);
+
+    if (!SceneWrapsX() && pTargetBitmap->w > GetSceneWidth())
+    {
+        targetBox.m_Corner.m_X = (pTargetBitmap->w - GetSceneWidth()) / 2;
+        targetBox.m_Width = GetSceneWidth();
+    }
+    if (!SceneWrapsY() && pTargetBitmap->h > GetSceneHeight())
+    {
+        targetBox.m_Corner.m_Y = (pTargetBitmap->h - GetSceneHeight()) / 2;
+        targetBox.m_Height = GetSceneHeight();
+    }
+    return targetBox;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearMOColorLayer
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -103,6 +103,62 @@ struct IntRect
 };
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Struct:          RayQuery
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     One ray of a batch cast with SceneMan::CastRays. Says what the ray
+//                  looks for, and gets the result filled in once the ray is cast.
+// Parent(s):       None.
+
+struct RayQuery
+{
+    // What a ray looks for. Each type is cast like the single ray casting method it's named after
+    enum RayType
+    {
+        // CastMORay: Finds the first MO that isn't m_IgnoreMOID or one of its children, and isn't ignoring hits from m_Team. Stops at any terrain that isn't air or m_Material
+        MORAY = 0,
+        // CastObstacleRay: Finds the first terrain or MO like MORAY does, but doesn't tell which MO was hit
+        OBSTACLERAY,
+        // CastSeeRay: Reveals the unseen layer of m_Team until m_Strength worth of material strength has been passed through
+        SEERAY,
+        // CastMaterialRay: Finds the first pixel of m_Material
+        MATERIALRAY,
+        // CastStrengthRay: Finds the first pixel with at least m_Strength material strength that isn't m_Material
+        STRENGTHRAY
+    };
+
+    // The RayType of the ray
+    int m_Type;
+    // The starting position of the ray
+    Vector m_Start;
+    // The vector to trace along
+    Vector m_Ray;
+    // For every pixel checked along the ray, how many to skip between them
+    int m_Skip;
+    // The team the ray is cast for, see RayType for what it's used for
+    int m_Team;
+    // The MOID MO and obstacle rays ignore, along with its children
+    MOID m_IgnoreMOID;
+    // The material the ray looks for or ignores, see RayType
+    unsigned char m_Material;
+    // The strength the ray looks for or can pass through, see RayType
+    float m_Strength;
+
+    // Whether the ray found what it looks for. For see rays, whether it revealed anything
+    bool m_Hit;
+    // Where the ray found what it looks for, or where it ended if it found nothing
+    Vector m_HitPos;
+    // The MOID an MO ray hit, or g_NoMOID
+    MOID m_HitMOID;
+    // How far an obstacle ray got before the obstacle, or < 0 if there was none
+    float m_HitDistance;
+    // The last free position before the obstacle an obstacle ray hit, or its end if there was none
+    Vector m_FreePos;
+
+    RayQuery() { m_Type = MORAY; m_Skip = 0; m_Team = Activity::NOTEAM; m_IgnoreMOID = g_NoMOID; m_Material = g_MaterialAir; m_Strength = 0; m_Hit = false; m_HitMOID = g_NoMOID; m_HitDistance = -1; }
+};
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Class:           SceneMan
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -553,21 +609,50 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Gets a specific pixel from the total material representation of
 //                  this Scene. LockScene() must be called before using this method.
+//                  While the scene is locked, the pixel is read straight from the rows of
+//                  the material bitmap cached by LockScene().
 // Arguments:       The X and Y coordinates of screen material pixel to get.
 // Return value:    An unsigned char specifying the requested pixel's material index.
 
-    unsigned char GetTerrMatter(int pixelX, int pixelY);
+    unsigned char GetTerrMatter(int pixelX, int pixelY)
+    {
+        if (m_ppLockedMaterialRows)
+        {
+            bool withinX = WrapLockedCoordinate(pixelX, m_LockedSceneWidth, m_LockedWrapsX);
+            bool withinY = WrapLockedCoordinate(pixelY, m_LockedSceneHeight, m_LockedWrapsY);
+            if (withinX && withinY)
+                return m_ppLockedMaterialRows[pixelY][pixelX];
+            // Outside on an axis that doesn't wrap is air. Only positions more than a scene away on a wrapping axis are left to be wrapped all the way below
+            if ((!withinX && !m_LockedWrapsX) || (!withinY && !m_LockedWrapsY))
+                return g_MaterialAir;
+        }
+        return GetTerrMatterFromBitmap(pixelX, pixelY);
+    }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetMOIDPixel
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Gets a MOID from pixel coordinates in the Scene. LockScene() must be
-//                  called before using this method.
+//                  called before using this method. While the scene is locked, the pixel
+//                  is read straight from the rows of the MOID layer cached by LockScene().
 // Arguments:       The X and Y coordinates of screen Scene pixel to get the MO from.
 // Return value:    The MOID currently at the specified pixel location.
 
-    MOID GetMOIDPixel(int pixelX, int pixelY);
+    MOID GetMOIDPixel(int pixelX, int pixelY)
+    {
+        if (m_ppLockedMOIDRows)
+        {
+            bool withinX = WrapLockedCoordinate(pixelX, m_LockedSceneWidth, m_LockedWrapsX);
+            bool withinY = WrapLockedCoordinate(pixelY, m_LockedSceneHeight, m_LockedWrapsY);
+            if (withinX && withinY)
+                return reinterpret_cast<const unsigned short *>(m_ppLockedMOIDRows[pixelY])[pixelX];
+            // Outside on an axis that doesn't wrap has no MOID. Only positions more than a scene away on a wrapping axis are left to be wrapped all the way below
+            if ((!withinX && !m_LockedWrapsX) || (!withinY && !m_LockedWrapsY))
+                return g_NoMOID;
+        }
+        return GetMOIDPixelFromBitmap(pixelX, pixelY);
+    }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -846,6 +931,18 @@ public:
     void ClearAllMOIDDrawings();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TakeMOIDDrawings
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Moves all registered drawn areas of the MOID layer over to a list,
+//                  so they're no longer cleared by ClearAllMOIDDrawings. For whoever
+//                  wants to keep track of what's on the MOID layer themselves.
+// Arguments:       The list to add the registered areas to.
+// Return value:    None.
+
+    void TakeMOIDDrawings(std::list<IntRect> &drawings) { drawings.splice(drawings.end(), m_MOIDDrawings); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearMOIDRect
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1241,6 +1338,25 @@ public:
     float CastMaxStrengthRay(const Vector &start, const Vector &end, int skip);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastMaxStrengthRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Traces along a vector and returns the strongest of all encountered pixels'
+//                  material strength values exept doors, and except pixels of specific
+//                  materials within specific areas. Used to see through things that are
+//                  only solid to some, like the doors of a team.
+//                  This will take wrapping into account.
+// Arguments:       The starting position.
+//                  The ending position.
+//                  For every pixel checked along the line, how many to skip between them
+//                  for optimization reasons. 0 = every pixel is checked.
+//                  The areas within which pixels of the paired material ID are ignored.
+// Return value:    The max of all encountered pixels' material strength vales. So if it was
+//                  all Air, then 0 is returned (Air's strength value is 0).
+
+    float CastMaxStrengthRay(const Vector &start, const Vector &end, int skip, const std::vector<std::pair<Box, unsigned char>> &ignoredMaterialAreas);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CastStrengthRay
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1348,6 +1464,38 @@ public:
     float CastObstacleRay(const Vector &start, const Vector &ray, Vector &obstaclePos, Vector &freePos, MOID ignoreMOID = g_NoMOID, int ignoreTeam = Activity::NOTEAM, unsigned char ignoreMaterial = 0, int skip = 0);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BenchmarkRayCasts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the same set of random rays over the current scene with each of
+//                  the ray casting methods, once through the shared ray march kernel and
+//                  once through the reference loop that reads every pixel through
+//                  WrapPosition and getpixel like the casts used to, and prints how
+//                  long each took to the console. Unseen rays are left out, since they
+//                  change the unseen layers.
+// Arguments:       How many rays to cast with each of the ray casting methods.
+// Return value:    How many of the casts had different results between the two paths.
+//                  Anything but 0 means the kernel doesn't match the reference.
+
+    int BenchmarkRayCasts(int rayCount);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastRays
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts a batch of rays in one go, locking the scene only once for all of
+//                  them. Can spread the rays across the worker threads, except for see
+//                  rays, which are always cast on the calling thread since they change the
+//                  unseen layers. GetLastRayHitPos isn't meaningful after a batch, the hit
+//                  positions are in the queries instead.
+// Arguments:       The rays to cast. Each one gets its results filled in.
+//                  Whether to spread the rays across the worker threads. Only worth it for
+//                  batches of more than a few dozen rays.
+// Return value:    None.
+
+    void CastRays(std::vector<RayQuery> &rayQueries, bool parallel = false);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetLastRayHitPos
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1650,6 +1798,33 @@ public:
     void Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap,  const Vector &targetPos = Vector(), bool skipSkybox = false, bool skipTerrain = false);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawMOColorLayer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws only the MO color layer as seen from a specific screen. Unlike
+//                  Draw, this doesn't depend on which screen was updated last, so it
+//                  can be done for several screens at once after they were all updated.
+// Arguments:       A pointer to a BITMAP to draw on, appropriately sized for the split
+//                  screen segment.
+//                  Which screen to draw for.
+// Return value:    None.
+
+    void DrawMOColorLayer(BITMAP *pTargetBitmap, int screen) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawHUD
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws the actor and gameplay HUDs and GUIs of the last updated screen.
+//                  Draw already does this in the normal layer draw mode.
+// Arguments:       A pointer to a BITMAP to draw the HUDs on.
+//                  The offset into the scene where the target bitmap's upper left corner
+//                  is located.
+// Return value:    None.
+
+    void DrawHUD(BITMAP *pTargetGUIBitmap, const Vector &targetPos);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearMOColorLayer
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1744,11 +1919,21 @@ protected:
     SceneLayer *m_pMOIDLayer;
     // All the areas drawn within on the MOID layer since last Update
     std::list<IntRect> m_MOIDDrawings;
+    // The rows of the terrain material and MOID layer bitmaps, cached by LockScene() and cleared by UnlockScene(), so GetTerrMatter() and GetMOIDPixel() can read pixels directly while the scene is locked
+    unsigned char **m_ppLockedMaterialRows;
+    unsigned char **m_ppLockedMOIDRows;
+    // The size of both bitmaps and whether the scene wraps on each axis, cached along with the rows
+    int m_LockedSceneWidth;
+    int m_LockedSceneHeight;
+    bool m_LockedWrapsX;
+    bool m_LockedWrapsY;
 
     // Debug layer for seeing cast rays etc
     SceneLayer *m_pDebugLayer;
-    // The absolute end position of the last ray cast
-    Vector m_LastRayHitPos;
+    // Whether the rays cast on each thread leave the debug layer alone, which they have to while cast from the worker threads
+    static thread_local bool m_SkipRayDebugDrawing;
+    // The absolute end position of the last ray cast on each thread, so rays can be cast from several threads at once
+    static thread_local Vector m_LastRayHitPos;
     // The mode we're drawing layers in to the screen
     int m_LayerDrawMode;
 
@@ -1803,6 +1988,9 @@ protected:
 	// Bitmap to look for orphaned regions
 	BITMAP * m_pOrphanSearchBitmap;
 
+    // Whether the ray casts go through the reference loop instead of the ray march kernel, only set while benchmarking the two against each other
+    bool m_UseReferenceRayMarch;
+
 
 // TODO TEMP REMOVE
     // Debug deque with integers showing how many sim
@@ -1825,6 +2013,155 @@ private:
 
     void Clear();
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDrawTargetBox
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the box on a target bitmap the scene should be drawn in, which is
+//                  centered and smaller than the bitmap if the bitmap is larger than the
+//                  scene in a non-wrapping dimension.
+// Arguments:       The bitmap that will be drawn on.
+// Return value:    The box on the target bitmap to draw the scene in.
+
+    Box GetDrawTargetBox(const BITMAP *pTargetBitmap) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WrapLockedCoordinate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Wraps a pixel coordinate less than a scene away from the scene back
+//                  into it on an axis that wraps, for the cached pixel accessors.
+// Arguments:       The coordinate to wrap. Left as it is if it's further away or the axis
+//                  doesn't wrap.
+//                  The size of the scene along the axis.
+//                  Whether the scene wraps along the axis.
+// Return value:    Whether the coordinate is within the scene now.
+
+    static bool WrapLockedCoordinate(int &coordinate, int sceneSize, bool wraps)
+    {
+        if (wraps)
+        {
+            if (coordinate < 0 && coordinate >= -sceneSize)
+                coordinate += sceneSize;
+            else if (coordinate >= sceneSize && coordinate < sceneSize * 2)
+                coordinate -= sceneSize;
+        }
+        return static_cast<unsigned int>(coordinate) < static_cast<unsigned int>(sceneSize);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTerrMatterFromBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a specific pixel from the total material representation of
+//                  this Scene through WrapPosition and the material bitmap, for when the
+//                  rows aren't cached or the position is too far off to wrap cheaply.
+// Arguments:       The X and Y coordinates of screen material pixel to get.
+// Return value:    An unsigned char specifying the requested pixel's material index.
+
+    unsigned char GetTerrMatterFromBitmap(int pixelX, int pixelY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMOIDPixelFromBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a MOID from pixel coordinates in the Scene through WrapPosition
+//                  and the MOID layer bitmap, for when the rows aren't cached or the
+//                  position is too far off to wrap cheaply.
+// Arguments:       The X and Y coordinates of screen Scene pixel to get the MO from.
+// Return value:    The MOID currently at the specified pixel location.
+
+    MOID GetMOIDPixelFromBitmap(int pixelX, int pixelY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Struct:          RayPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     A pixel a ray cast checks, as handed to the cast's pixel visitor by
+//                  MarchRay.
+
+    struct RayPixel
+    {
+        // How many steps along the ray were taken before reaching this pixel
+        int m_Step;
+        // The position of the pixel, wrapped if the cast wraps
+        int m_PosX;
+        int m_PosY;
+        // The position of the step before this pixel, whether it was checked or skipped
+        int m_PrevPosX;
+        int m_PrevPosY;
+        // The terrain material of the pixel, air if it's out of the scene's bounds
+        unsigned char m_Material;
+        // The MOID on the pixel, g_NoMOID if it's out of the scene's bounds or the cast doesn't read MOIDs
+        MOID m_MOID;
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarchRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Steps along a ray with Bresenham's line algorithm and hands every
+//                  checked pixel to a visitor, which decides whether the ray stops there.
+//                  This is the traversal all the ray casting methods share.
+// Arguments:       Whether the MOID layer is read, as a template argument.
+//                  The starting position.
+//                  The vector to trace along.
+//                  For every pixel checked along the line, how many to skip between them
+//                  for optimization reasons. 0 = every pixel is checked. The last pixel
+//                  of the ray is always checked.
+//                  Whether the pixel positions handed to the visitor are wrapped. Pixels
+//                  are read from the wrapped position either way.
+//                  The debug layer color to draw the checked pixels the ray passed with,
+//                  or -1 to not draw them. Only used in debug builds.
+//                  Whether the ray may jump over tiles of the terrain that are all air
+//                  without checking their pixels. Only allowed if the visitor never stops
+//                  the ray at air pixels nor needs to see them, and the MOID layer isn't
+//                  read. The last pixel of the ray is checked either way.
+//                  The visitor, called with a const RayPixel & for every checked pixel.
+//                  Returns true to stop the ray at that pixel.
+// Return value:    Whether the visitor stopped the ray.
+
+    template <bool ReadMOIDs, typename PixelVisitor>
+    bool MarchRay(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, bool skipAirTiles, PixelVisitor &&visitPixel);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarchRaySteps
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The ray march kernel behind MarchRay, specialized on which axes the
+//                  scene wraps, so the wrapping is only done where it's needed and reads
+//                  the terrain material and MOID layer rows directly.
+// Arguments:       See MarchRay. Whether the scene wraps on X and Y are template arguments.
+// Return value:    Whether the visitor stopped the ray.
+
+    template <bool ReadMOIDs, bool WrapX, bool WrapY, typename PixelVisitor>
+    bool MarchRaySteps(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, bool skipAirTiles, PixelVisitor &visitPixel);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarchRayReference
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The per-pixel loop the ray casts used before MarchRaySteps, which wraps
+//                  and reads every checked pixel through WrapPosition and getpixel, like
+//                  GetTerrMatter and GetMOIDPixel did before they cached the bitmap rows.
+//                  Only kept for BenchmarkRayCasts to compare against.
+// Arguments:       See MarchRay, except for the skipping of air tiles, which this never does.
+// Return value:    Whether the visitor stopped the ray.
+
+    template <bool ReadMOIDs, typename PixelVisitor>
+    bool MarchRayReference(const Vector &start, const Vector &ray, int skip, bool wrap, int debugColor, PixelVisitor &visitPixel);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastRayQuery
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts one ray of a batch with the single ray casting method its type
+//                  calls for, and fills in its results.
+// Arguments:       The ray to cast.
+// Return value:    None.
+
+    void CastRayQuery(RayQuery &rayQuery);
+
     
     // Disallow the use of some implicit methods.
     SceneMan(const SceneMan &reference);
@@ -17,6 +17,7 @@ namespace RTE {
 		m_ForceVirtualFullScreenGfxDriver = false;
 		m_ForceOverlayedWindowGfxDriver = false;
 		m_ForceNonOverlayedWindowGfxDriver = false;
+		m_RotatedPostEffectCacheSizeMB = 16;
 
 		m_SoundPanningEffectStrength = 0.6F;
 		//////////////////////////////////////////////////
@@ -45,6 +46,8 @@ namespace RTE {
 		m_ServerHighCompressionLevel = 10;
 		m_ServerFastAccelerationFactor = 1;
 		m_ServerUseInterlacing = false;
+		m_ServerUseDeltaCompression = true;
+		m_ServerDeltaKeyFrameInterval = 30;
 		m_ServerEncodingFps = 30;
 		m_ServerSleepWhenIdle = false;
 		m_ServerSimSleepWhenIdle = false;
@@ -103,6 +106,8 @@ namespace RTE {
 			reader >> m_ForceOverlayedWindowGfxDriver;
 		} else if (propName == "ForceNonOverlayedWindowGfxDriver") {
 			reader >> m_ForceNonOverlayedWindowGfxDriver;
+		} else if (propName == "RotatedPostEffectCacheSizeMB") {
+			reader >> m_RotatedPostEffectCacheSizeMB;
 		} else if (propName == "SoundVolume") {
 			g_AudioMan.SetSoundsVolume(std::stod(reader.ReadPropValue()) / 100.0);
 		} else if (propName == "MusicVolume") {
@@ -155,6 +160,14 @@ namespace RTE {
 			g_MovableMan.ReadProperty(propName, reader);
 		} else if (propName == "EnableMOSubtraction") {
 			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "MultithreadedParticleTravel") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "IncrementalMOIDs") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "ValidateMOIDs") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "MultithreadedScreenDrawing") {
+			g_FrameMan.ReadProperty(propName, reader);
 		} else if (propName == "DeltaTime") {
 			g_TimerMan.SetDeltaTimeSecs(std::stof(reader.ReadPropValue()));
 		} else if (propName == "RealToSimCap") {
@@ -209,6 +222,10 @@ namespace RTE {
 			reader >> m_ServerFastAccelerationFactor;
 		} else if (propName == "ServerUseInterlacing") {
 			reader >> m_ServerUseInterlacing;
+		} else if (propName == "ServerUseDeltaCompression") {
+			reader >> m_ServerUseDeltaCompression;
+		} else if (propName == "ServerDeltaKeyFrameInterval") {
+			reader >> m_ServerDeltaKeyFrameInterval;
 		} else if (propName == "ServerEncodingFps") {
 			reader >> m_ServerEncodingFps;
 		} else if (propName == "ServerSleepWhenIdle") {
@@ -258,6 +275,8 @@ namespace RTE {
 		writer << m_ForceOverlayedWindowGfxDriver;
 		writer.NewProperty("ForceNonOverlayedWindowGfxDriver");
 		writer << m_ForceNonOverlayedWindowGfxDriver;
+		writer.NewProperty("RotatedPostEffectCacheSizeMB");
+		writer << m_RotatedPostEffectCacheSizeMB;
 
 		writer.NewLine(false, 2);
 		writer.NewDivider(false);
@@ -328,6 +347,14 @@ namespace RTE {
 		writer << g_MovableMan.IsParticleSettlingEnabled();
 		writer.NewProperty("EnableMOSubtraction");
 		writer << g_MovableMan.IsMOSubtractionEnabled();
+		writer.NewProperty("MultithreadedParticleTravel");
+		writer << g_MovableMan.IsMultithreadedParticleTravelEnabled();
+		writer.NewProperty("IncrementalMOIDs");
+		writer << g_MovableMan.IsIncrementalMOIDsEnabled();
+		writer.NewProperty("ValidateMOIDs");
+		writer << g_MovableMan.IsMOIDValidationEnabled();
+		writer.NewProperty("MultithreadedScreenDrawing");
+		writer << g_FrameMan.IsMultithreadedScreenDrawingEnabled();
 		writer.NewProperty("DeltaTime");
 		writer << g_TimerMan.GetDeltaTimeSecs();
 		writer.NewProperty("RealToSimCap");
@@ -402,6 +429,10 @@ namespace RTE {
 		writer << m_ServerFastAccelerationFactor;
 		writer.NewProperty("ServerUseInterlacing");
 		writer << m_ServerUseInterlacing;
+		writer.NewProperty("ServerUseDeltaCompression");
+		writer << m_ServerUseDeltaCompression;
+		writer.NewProperty("ServerDeltaKeyFrameInterval");
+		writer << m_ServerDeltaKeyFrameInterval;
 		writer.NewProperty("ServerEncodingFps");
 		writer << m_ServerEncodingFps;
 		writer.NewProperty("ServerSleepWhenIdle");
@@ -121,6 +121,12 @@ namespace RTE {
 		/// </summary>
 		/// <returns>True if forced to use software driver.</returns>
 		bool ForceNonOverlayedWindowGfxDriver() const { return m_ForceNonOverlayedWindowGfxDriver; }
+
+		/// <summary>
+		/// Gets how much memory the cache of rotated post effect bitmaps may use.
+		/// </summary>
+		/// <returns>The size of the rotated post effect cache in megabytes. 0 means rotated post effects aren't cached.</returns>
+		int GetRotatedPostEffectCacheSizeMB() const { return m_RotatedPostEffectCacheSizeMB; }
 #pragma endregion
 
 #pragma region Audio Settings
@@ -278,6 +284,18 @@ namespace RTE {
 		/// <returns>Whether server uses interlacing or not.</returns>
 		bool GetServerUseInterlacing() const { return m_ServerUseInterlacing; }
 
+		/// <summary>
+		/// Gets whether the server only transmits the parts of a frame that changed since they were last sent.
+		/// </summary>
+		/// <returns>Whether server uses delta compression or not.</returns>
+		bool GetServerUseDeltaCompression() const { return m_ServerUseDeltaCompression; }
+
+		/// <summary>
+		/// Gets how many frames the server sends between full frames when using delta compression.
+		/// </summary>
+		/// <returns>The number of frames between full frames.</returns>
+		unsigned short GetServerDeltaKeyFrameInterval() const { return m_ServerDeltaKeyFrameInterval; }
+
 		/// <summary>
 		/// Gets the server frame transmission rate.
 		/// </summary>
@@ -474,6 +492,7 @@ namespace RTE {
 		bool m_ForceVirtualFullScreenGfxDriver; //!< Whether we should try using fullscreen mode.
 		bool m_ForceOverlayedWindowGfxDriver; //!< Whether we should try using overlayed window driver.
 		bool m_ForceNonOverlayedWindowGfxDriver; //!< Whether we should try using non-overlayed window driver.
+		int m_RotatedPostEffectCacheSizeMB; //!< How much memory the cache of rotated post effect bitmaps may use, in megabytes.
 
 		float m_SoundPanningEffectStrength; //!< The strength of the sound panning effect, 0 (no panning) - 1 (full panning).
 
@@ -500,6 +519,8 @@ namespace RTE {
 		bool m_ServerUseFastCompression; //!< Whether to use faster compression methods and conserve CPU.
 		int m_ServerHighCompressionLevel; //!< Compression level. 10 is optimal, 12 is highest.
 		bool m_ServerUseInterlacing; //!< Use interlacing to heavily reduce bandwidth usage at the cost of visual degradation (unusable at 30 fps, but may be suitable at 60 fps).
+		bool m_ServerUseDeltaCompression; //!< Only transmit the blocks of a frame that changed since they were last sent. Only applies when transmitting frames as blocks.
+		unsigned short m_ServerDeltaKeyFrameInterval; //!< How many frames to send between full frames when using delta compression. Full frames repair any blocks the client didn't receive.
 		unsigned short m_ServerEncodingFps; //!< Frame transmission rate. Higher value equals more CPU and bandwidth consumption.
 		bool m_ServerSleepWhenIdle; //!< If true puts thread to sleep if it didn't receive anything for 10 seconds to avoid melting the CPU at 100% even if there are no connections.
 		bool m_ServerSimSleepWhenIdle; //!< If true the server will try to put the thread to sleep to reduce CPU load if the sim frame took less time to complete than it should at 30 fps.
@@ -1,62 +1,140 @@
-//////////////////////////////////////////////////////////////////////////////////////////
-// File:            ThreadMan.cpp
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Source file for the ThreadMan class.
-// Project:         Retro Terrain Engine
-// Author(s):       
-//                  
-//                  
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Inclusions of header files
-
-
 #include "ThreadMan.h"
-
-using namespace std;
-
-namespace RTE
-{
-
-#define DELTABUFFERSIZE 30
-
-const string ThreadMan::m_ClassName = "ThreadMan";
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Clear
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Clears all the member variables of this ThreadMan, effectively
-//                  resetting the members of this abstraction level only.
-
-void ThreadMan::Clear()
-{
+#include "PerformanceMan.h"
+
+namespace RTE {
+
+	const std::string ThreadMan::c_ClassName = "ThreadMan";
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ThreadMan::Clear() {
+		m_WorkerThreads.clear();
+		m_TaskQueue.clear();
+		m_StopWorkers = false;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int ThreadMan::Create(unsigned short workerThreadCount) {
+		if (workerThreadCount == 0) {
+			unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+			workerThreadCount = (hardwareThreadCount > 1) ? static_cast<unsigned short>(hardwareThreadCount - 1) : 0;
+		}
+		m_StopWorkers = false;
+		m_WorkerThreads.reserve(workerThreadCount);
+		for (unsigned short i = 0; i < workerThreadCount; ++i) {
+			m_WorkerThreads.emplace_back(&ThreadMan::WorkerThreadFunction, this);
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ThreadMan::Destroy() {
+		{
+			std::lock_guard<std::mutex> queueLock(m_TaskQueueMutex);
+			m_StopWorkers = true;
+		}
+		m_TaskQueuedCondition.notify_all();
+		for (std::thread &workerThread : m_WorkerThreads) {
+			if (workerThread.joinable()) { workerThread.join(); }
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ThreadMan::WorkerThreadFunction() {
+		g_PerformanceMan.SetTraceThreadName("Worker Thread");
+
+		while (true) {
+			std::packaged_task<void()> task;
+			{
+				std::unique_lock<std::mutex> queueLock(m_TaskQueueMutex);
+				m_TaskQueuedCondition.wait(queueLock, [this]() { return m_StopWorkers || !m_TaskQueue.empty(); });
+				if (m_TaskQueue.empty()) {
+					return;
+				}
+				task = std::move(m_TaskQueue.front());
+				m_TaskQueue.pop_front();
+			}
+			task();
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::future<void> ThreadMan::QueueTask(std::function<void()> task) {
+		std::packaged_task<void()> packagedTask(std::move(task));
+		std::future<void> taskFuture = packagedTask.get_future();
+
+		if (m_WorkerThreads.empty()) {
+			packagedTask();
+			return taskFuture;
+		}
+		{
+			std::lock_guard<std::mutex> queueLock(m_TaskQueueMutex);
+			m_TaskQueue.push_back(std::move(packagedTask));
+		}
+		m_TaskQueuedCondition.notify_one();
+		return taskFuture;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ThreadMan::ParallelFor(size_t taskCount, const std::function<void(size_t)> &task) {
+		if (taskCount == 0) {
+			return;
+		}
+		if (taskCount == 1 || m_WorkerThreads.empty()) {
+			for (size_t index = 0; index < taskCount; ++index) {
+				task(index);
+			}
+			return;
+		}
+
+		// The shared state outlives this call because helpers that only get picked up after all indices are done still need to look at it.
+		// Waiting for indices instead of helper futures also means a ParallelFor called from inside a worker can't deadlock on helpers stuck behind it in the queue.
+		struct ParallelForState {
+			std::atomic<size_t> NextIndex;
+			std::atomic<size_t> FinishedCount;
+			std::mutex FinishedMutex;
+			std::condition_variable FinishedCondition;
+			std::exception_ptr FirstException;
+		};
+		std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+		state->NextIndex = 0;
+		state->FinishedCount = 0;
+
+		auto runIndices = [state, taskCount, &task]() {
+			size_t index;
+			while ((index = state->NextIndex++) < taskCount) {
+				try {
+					task(index);
+				} catch (...) {
+					std::lock_guard<std::mutex> finishedLock(state->FinishedMutex);
+					if (!state->FirstException) { state->FirstException = std::current_exception(); }
+				}
+				if (++state->FinishedCount == taskCount) {
+					std::lock_guard<std::mutex> finishedLock(state->FinishedMutex);
+					state->FinishedCondition.notify_all();
+				}
+			}
+		};
+		size_t helperCount = std::min(taskCount - 1, m_WorkerThreads.size());
+		{
+			std::lock_guard<std::mutex> queueLock(m_TaskQueueMutex);
+			for (size_t helper = 0; helper < helperCount; ++helper) {
+				// Helpers only touch the task reference while there are indices left, which can't outlive this call.
+				m_TaskQueue.emplace_back(runIndices);
+			}
+		}
+		m_TaskQueuedCondition.notify_all();
+
+		runIndices();
+
+		std::unique_lock<std::mutex> finishedLock(state->FinishedMutex);
+		state->FinishedCondition.wait(finishedLock, [&state, taskCount]() { return state->FinishedCount == taskCount; });
+		if (state->FirstException) { std::rethrow_exception(state->FirstException); }
+	}
 }
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Create
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Makes the ThreadMan object ready for use.
-
-int ThreadMan::Create()
-{
-
-	return 0;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Destroy
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Destroys and resets (through Clear()) the ThreadMan object.
-
-void ThreadMan::Destroy()
-{
-
-
-    Clear();
-}
-
-} // namespace RTE
\ No newline at end of file
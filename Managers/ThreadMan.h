@@ -1,144 +1,107 @@
-#ifndef _RTEThreadMan_
-#define _RTEThreadMan_
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// File:            ThreadMan.h
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Header file for the ThreadMan class.
-// Project:         Retro Terrain Engine
-// Author(s):       
-//                  
-//                  
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Inclusions of header files
-
-#include "global_types.h"
-
-
-#include <string>
-#include <deque>
-
-//#include <boost/thread.hpp>
+#ifndef _RTETHREADMAN_
+#define _RTETHREADMAN_
 
 #include "Singleton.h"
-#define g_ThreadMan ThreadMan::Instance()
-
-namespace RTE
-{
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Class:           ThreadMan
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     The centralized singleton manager of all threads.
-// Parent(s):       Singleton
-// Class history:   03/29/2014  ThreadMan created.
-
-
-class ThreadMan:
-    public Singleton<ThreadMan>
-{
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Public member variable, method and friend function declarations
-
-public:
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Constructor:     ThreadMan
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Constructor method used to instantiate a ThreadMan object in system
-//                  memory. Create() should be called before using the object.
-// Arguments:       None.
-
-    ThreadMan() { Clear(); Create(); }
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Destructor:      ~ThreadMan
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Destructor method used to clean up a ThreadMan object before deletion
-//                  from system memory.
-// Arguments:       None.
-
-    virtual ~ThreadMan() { Destroy(); }
-
 
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Create
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Makes the ThreadMan object ready for use.
-// Arguments:       None.
-// Return value:    An error return value signaling sucess or any particular failure.
-//                  Anything below 0 is an error signal.
+#include <condition_variable>
+#include <future>
+#include <atomic>
 
-    virtual int Create();
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Virtual method:  Reset
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Resets the entire ThreadMan, including its inherited members, to
-//                  their default settings or values.
-// Arguments:       None.
-// Return value:    None.
-
-    virtual void Reset() { Clear(); }
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Destroy
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Destroys and resets (through Clear()) the ThreadMan object.
-// Arguments:       None.
-// Return value:    None.
-
-    void Destroy();
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Virtual method:  GetClassName
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Gets the class name of this Entity.
-// Arguments:       None.
-// Return value:    A string with the friendly-formatted type name of this object.
-
-    virtual const std::string & GetClassName() const { return m_ClassName; }
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Protected member variable and method declarations
-
-protected:
-
-    // Member variables
-    static const std::string m_ClassName;
-
-
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Private member variable and method declarations
-
-private:
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Clear
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Clears all the member variables of this ThreadMan, effectively
-//                  resetting the members of this abstraction level only.
-// Arguments:       None.
-// Return value:    None.
-
-    void Clear();
-
-    // Disallow the use of some implicit methods.
-    ThreadMan(const ThreadMan &reference);
-    ThreadMan & operator=(const ThreadMan &rhs);
-
-};
-
-} // namespace RTE
+#define g_ThreadMan ThreadMan::Instance()
 
-#endif // File
\ No newline at end of file
+namespace RTE {
+
+	/// <summary>
+	/// The centralized singleton manager of all worker threads, used to spread independent chunks of work across the available cores.
+	/// </summary>
+	class ThreadMan : public Singleton<ThreadMan> {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a ThreadMan object in system memory. Create() should be called before using the object.
+		/// </summary>
+		ThreadMan() { Clear(); }
+
+		/// <summary>
+		/// Makes the ThreadMan object ready for use and starts the worker threads.
+		/// </summary>
+		/// <param name="workerThreadCount">How many worker threads to start. 0 means one less than the number of hardware threads, so the main thread keeps a core to itself.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		virtual int Create(unsigned short workerThreadCount = 0);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a ThreadMan object before deletion from system memory.
+		/// </summary>
+		virtual ~ThreadMan() { Destroy(); }
+
+		/// <summary>
+		/// Stops and joins all worker threads and resets (through Clear()) the ThreadMan object.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets the number of worker threads that are available to run tasks.
+		/// </summary>
+		/// <returns>The number of running worker threads.</returns>
+		unsigned short GetWorkerThreadCount() const { return static_cast<unsigned short>(m_WorkerThreads.size()); }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Queues a task to be run on one of the worker threads. If there are no worker threads the task is run immediately on the calling thread.
+		/// </summary>
+		/// <param name="task">The task to run.</param>
+		/// <returns>A future that becomes ready once the task has been run. Any exception thrown by the task is rethrown from the future's get().</returns>
+		std::future<void> QueueTask(std::function<void()> task);
+
+		/// <summary>
+		/// Runs a task once for every index in [0, taskCount), spread across the worker threads and the calling thread. Blocks until all of them are done.
+		/// Indices are handed out dynamically, so callers that need deterministic results should write each index's output to its own slot and merge them in index order afterwards.
+		/// </summary>
+		/// <param name="taskCount">The number of indices to run the task for.</param>
+		/// <param name="task">The task to run. Is passed the index it should process.</param>
+		void ParallelFor(size_t taskCount, const std::function<void(size_t)> &task);
+#pragma endregion
+
+#pragma region Class Info
+		/// <summary>
+		/// Gets the class name of this Entity.
+		/// </summary>
+		/// <returns>A string with the friendly-formatted type name of this object.</returns>
+		virtual const std::string & GetClassName() const { return c_ClassName; }
+#pragma endregion
+
+	protected:
+
+		static const std::string c_ClassName; //!< A string with the friendly-formatted type name of this object.
+
+		std::vector<std::thread> m_WorkerThreads; //!< The worker threads that run queued tasks.
+		std::deque<std::packaged_task<void()>> m_TaskQueue; //!< Tasks waiting to be picked up by a worker thread.
+		std::mutex m_TaskQueueMutex; //!< Mutex guarding the task queue and the stop flag.
+		std::condition_variable m_TaskQueuedCondition; //!< Signaled whenever a task is queued or the workers are told to stop.
+		bool m_StopWorkers; //!< Whether the worker threads should exit once the task queue is empty.
+
+	private:
+
+		/// <summary>
+		/// The function each worker thread runs. Waits for queued tasks and runs them until told to stop.
+		/// </summary>
+		void WorkerThreadFunction();
+
+		/// <summary>
+		/// Clears all the member variables of this ThreadMan, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		ThreadMan(const ThreadMan &reference) {}
+		ThreadMan & operator=(const ThreadMan &rhs) {}
+	};
+}
+#endif
@@ -263,6 +263,21 @@ void TimerMan::Update()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateFixedStep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the real time ticks, and makes the accumulator hold exactly
+//                  one DeltaTime so the sim steps once regardless of real time passed.
+
+void TimerMan::UpdateFixedStep()
+{
+    Update();
+
+    m_SimAccumulator = m_SimPaused ? 0 : m_DeltaTime;
+    m_SimUpdatesSinceDrawn = -1;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          UpdateSim
 //////////////////////////////////////////////////////////////////////////////////////////
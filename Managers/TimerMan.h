@@ -403,6 +403,20 @@ public:
     void Update();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateFixedStep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Updates the real time ticks like Update, but then puts exactly one
+//                  DeltaTime in the accumulator no matter how much real time passed, so
+//                  the sim steps once per call and as fast as the machine can go.
+//                  Used for benchmarking, where the sim has to advance the same way on
+//                  every run.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateFixedStep();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          UpdateSim
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,7 @@
 #include "SettingsMan.h"
 #include "PresetMan.h"
 #include "FrameMan.h"
+#include "PostProcessMan.h"
 #include "UInputMan.h"
 
 #include "GUI/GUI.h"
@@ -154,6 +155,8 @@ namespace RTE {
 		// Clear out the PresetMan and all its DataModules
 		g_PresetMan.Destroy();
 		g_PresetMan.Create();
+		// The reloaded presets may have different effect bitmaps, so none of the rotated ones made of the old ones can be used anymore
+		g_PostProcessMan.ClearRotatedEffectCache();
 
 		// Unpack any ".rte.zip" files
 		ExtractArchivedModules();
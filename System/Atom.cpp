@@ -11,6 +11,7 @@ namespace RTE {
 	std::vector<void *> Atom::s_AllocatedPool;
 	int Atom::s_PoolAllocBlockCount = 200;
 	int Atom::s_InstancesInUse = 0;
+	thread_local SpeculativeTravelContext *Atom::s_SpeculativeTravelContext = nullptr;
 
 	// This forms a circle around the Atom's offset center, to check for mask color pixels in order to determine the normal at the Atom's position.
 	const int Atom::s_NormalChecks[c_NormalCheckCount][2] = { {0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0}, {3, 1}, {2, 2}, {1, 3}, {0, 3}, {-1, 3}, {-2, 2}, {-3, 1}, {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3} };
@@ -638,6 +639,12 @@ namespace RTE {
 		int removeOrphansMaxArea = m_OwnerMO->m_RemoveOrphanTerrainMaxArea;
 		float removeOrphansRate = m_OwnerMO->m_RemoveOrphanTerrainRate;
 
+		// When traveling speculatively, keep what's needed to undo the changes to this Atom's own state if the travel has to be aborted.
+		SpeculativeTravelContext *speculativeContext = s_SpeculativeTravelContext;
+		int prevNumPenetrations = m_NumPenetrations;
+		bool prevChangedDir = m_ChangedDir;
+		int prevPrevError = m_PrevError;
+
 		// Bake in the Atom offset.
 		position += m_Offset;
 
@@ -713,6 +720,10 @@ namespace RTE {
 			for (domSteps = 0; domSteps < delta[dom] && !(hit[X] || hit[Y]); ++domSteps) {
 				// Check for the special case if the Atom is starting out embedded in terrain. This can happen if something large gets copied to the terrain and embeds some Atoms.
 				if (domSteps == 0 && g_SceneMan.GetTerrMatter(intPos[X], intPos[Y]) != g_MaterialAir) {
+					if (speculativeContext) {
+						speculativeContext->Aborted = true;
+						break;
+					}
 					++hitCount;
 					hit[X] = hit[Y] = true;
 					if (g_SceneMan.TryPenetrate(intPos[X], intPos[Y], velocity * mass * sharpness, velocity, retardation, 0.5F, m_NumPenetrations, removeOrphansRadius, removeOrphansMaxArea, removeOrphansRate)) {
@@ -747,6 +758,11 @@ namespace RTE {
 				m_MOIDHit = g_SceneMan.GetMOIDPixel(intPos[X], intPos[Y]);
 
 				if (m_OwnerMO->m_HitsMOs && m_MOIDHit != g_NoMOID && !IsIgnoringMOID(m_MOIDHit)) {
+					// Hit responses change the hit MO, which may be traveling on another thread. Leave them to the serial pass.
+					if (speculativeContext) {
+						speculativeContext->Aborted = true;
+						break;
+					}
 					m_OwnerMO->SetHitWhatMOID(m_MOIDHit);
 
 					++hitCount;
@@ -850,8 +866,13 @@ namespace RTE {
 					++hitCount;
 
 #ifdef DEBUG_BUILD
-					if (m_TrailLength) { putpixel(trailBitmap, intPos[X], intPos[Y], 199); }
+					if (m_TrailLength && !speculativeContext) { putpixel(trailBitmap, intPos[X], intPos[Y], 199); }
 #endif
+					// A successful penetration digs into the terrain, so when traveling speculatively only check whether it would happen and leave the digging to the serial pass.
+					if (speculativeContext && hitMaterial->id != g_MaterialOutOfBounds && (velocity * mass * sharpness).GetMagnitude() >= hitMaterial->strength) {
+						speculativeContext->Aborted = true;
+						break;
+					}
 					// Try penetration of the terrain.
 					if (hitMaterial->id != g_MaterialOutOfBounds && g_SceneMan.TryPenetrate(intPos[X], intPos[Y], velocity * mass * sharpness, velocity, retardation, 0.65F, m_NumPenetrations, removeOrphansRadius, removeOrphansMaxArea, removeOrphansRate)) {
 						hit[dom] = hit[sub] = sinkHit = true;
@@ -876,7 +897,11 @@ namespace RTE {
 
 						// TODO: improve sticky logic!
 						// Check if particle is sticky and should adhere to where it collided
-						if (m_Material->stickiness >= PosRand() && velocity.GetLargest() > 0.5F) {
+						if (m_Material->stickiness >= (speculativeContext ? speculativeContext->PosRand() : PosRand()) && velocity.GetLargest() > 0.5F) {
+							if (speculativeContext) {
+								speculativeContext->Aborted = true;
+								break;
+							}
 							// SPLAT, so update position, apply to terrain and delete, and stop traveling
 							m_OwnerMO->SetPos(Vector(intPos[X], intPos[Y]));
 							g_SceneMan.GetTerrain()->ApplyMovableObject(m_OwnerMO);
@@ -955,15 +980,21 @@ namespace RTE {
 					velocity += hitAccel;
 				}
 			}
-		} while ((hit[X] || hit[Y]) && /* !segTraj.GetFloored().IsZero() && */ hitCount < 100 && !m_LastHit.Terminate[HITOR]);
+		} while ((hit[X] || hit[Y]) && /* !segTraj.GetFloored().IsZero() && */ hitCount < 100 && !m_LastHit.Terminate[HITOR] && !(speculativeContext && speculativeContext->Aborted));
 
 		//RTEAssert(hitCount < 100, "Atom travel resulted in more than 100 segments!!");
 
-		// Draw the trail
-		if (g_TimerMan.DrawnSimUpdate() && m_TrailLength) {
+		bool speculativeTravelAborted = speculativeContext && speculativeContext->Aborted;
+
+		// Draw the trail. Speculative travels queue it up instead, so overlapping trails from different threads end up drawn in a deterministic order.
+		if (g_TimerMan.DrawnSimUpdate() && m_TrailLength && !speculativeTravelAborted) {
 			int length = m_TrailLength /* + 3 * PosRand()*/;
 			for (int i = trailPoints.size() - MIN(length, trailPoints.size()); i < trailPoints.size(); ++i) {
-				putpixel(trailBitmap, trailPoints[i].first, trailPoints[i].second, m_TrailColor.GetIndex());
+				if (speculativeContext) {
+					speculativeContext->QueuedTrailPixels.push_back({ trailPoints[i].first, trailPoints[i].second, m_TrailColor.GetIndex() });
+				} else {
+					putpixel(trailBitmap, trailPoints[i].first, trailPoints[i].second, m_TrailColor.GetIndex());
+				}
 			}
 		}
 
@@ -971,6 +1002,17 @@ namespace RTE {
 		//if (m_TrailLength) { trailBitmap->UnLock(); }
 		if (!scenePreLocked) { g_SceneMan.UnlockScene(); }
 
+		if (speculativeTravelAborted) {
+			// The owner MO rolls back its own state, only what belongs to this Atom needs to be undone here.
+			m_NumPenetrations = prevNumPenetrations;
+			m_ChangedDir = prevChangedDir;
+			m_PrevError = prevPrevError;
+			m_LastHit.Reset();
+			position -= m_Offset;
+			ClearMOIDIgnoreList();
+			return hitCount;
+		}
+
 		// Extract Atom offset.
 		position -= m_Offset;
 
@@ -984,6 +1026,16 @@ namespace RTE {
 		return hitCount;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void Atom::DrawQueuedTrails(SpeculativeTravelContext &context) {
+		BITMAP *trailBitmap = g_SceneMan.GetMOColorBitmap();
+		for (const SpeculativeTravelContext::TrailPixel &trailPixel : context.QueuedTrailPixels) {
+			putpixel(trailBitmap, trailPixel.X, trailPixel.Y, trailPixel.Color);
+		}
+		context.QueuedTrailPixels.clear();
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void HitData::Clear() {
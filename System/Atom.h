@@ -65,6 +65,60 @@ namespace RTE {
 	};
 #pragma endregion
 
+#pragma region SpeculativeTravelContext
+	/// <summary>
+	/// Per-task state for Atoms that are traveled speculatively on a worker thread during a multithreaded particle travel pass.
+	/// While traveling under a context an Atom only reads the terrain and MOID layers. Anything that would write to shared state (terrain penetration, sticking, MO hits) aborts the travel instead, so the owner can be rolled back and traveled again serially.
+	/// </summary>
+	struct SpeculativeTravelContext {
+
+		/// <summary>
+		/// A trail pixel queued up to be drawn to the MO color layer once the parallel pass is done.
+		/// </summary>
+		struct TrailPixel { int X; int Y; int Color; };
+
+		bool Aborted; //!< Whether the travel currently being done under this context needed to write to shared state and has to be redone serially.
+		unsigned long RandomState; //!< State of the random generator used in place of the global one, so results don't depend on which thread traveled what.
+		std::vector<TrailPixel> QueuedTrailPixels; //!< Trail pixels queued up by Atoms that finished traveling under this context.
+
+		/// <summary>
+		/// Constructor method used to instantiate a SpeculativeTravelContext object in system memory.
+		/// </summary>
+		SpeculativeTravelContext() { Clear(); }
+
+		/// <summary>
+		/// Clears the queued trail pixels and the abort flag so this context can be reused for a new pass.
+		/// </summary>
+		void Clear() { Aborted = false; RandomState = 1; QueuedTrailPixels.clear(); }
+
+		/// <summary>
+		/// Prepares this context for traveling a single MovableObject. Seeds the random generator from the object's unique ID and the current sim frame so the result is deterministic.
+		/// </summary>
+		/// <param name="uniqueID">The unique ID of the MovableObject about to travel.</param>
+		/// <param name="simFrameNumber">The current sim update frame number.</param>
+		void BeginTravel(unsigned long uniqueID, unsigned int simFrameNumber) { Aborted = false; RandomState = ((uniqueID * 2654435761UL) ^ (simFrameNumber * 40503UL)) | 1; }
+
+		/// <summary>
+		/// Deterministic replacement for PosRand() to be used while traveling speculatively.
+		/// </summary>
+		/// <returns>Random number between 0 and 1, the min being inclusive, but the max not.</returns>
+		double PosRand() {
+			// xorshift32, kept to 32 bits so it behaves the same regardless of the size of unsigned long.
+			RandomState &= 0xFFFFFFFFUL;
+			RandomState ^= (RandomState << 13) & 0xFFFFFFFFUL;
+			RandomState ^= RandomState >> 17;
+			RandomState ^= (RandomState << 5) & 0xFFFFFFFFUL;
+			return static_cast<double>(RandomState % 1000) / 1000.0;
+		}
+
+		/// <summary>
+		/// Deterministic replacement for NormalRand() to be used while traveling speculatively.
+		/// </summary>
+		/// <returns>Random number between -1.0 and 1.0.</returns>
+		double NormalRand() { return PosRand() * 2.0 - 1.0; }
+	};
+#pragma endregion
+
 	/// <summary>
 	/// A point (pixel) that tests for collisions with a BITMAP's drawn pixels, ie not the mask color. Owned and operated by other objects.
 	/// </summary>
@@ -451,6 +505,24 @@ namespace RTE {
 		/// <param name="scenePreLocked">Whether the Scene has been pre-locked or not.</param>
 		/// <returns>The number of hits against terrain that were made during the travel.</returns>
 		int Travel(float travelTime, bool autoTravel = true, bool scenePreLocked = false);
+
+		/// <summary>
+		/// Gets the SpeculativeTravelContext Atoms traveled on the calling thread are currently using, if any.
+		/// </summary>
+		/// <returns>The context in use on the calling thread, or nullptr if Atoms travel normally. Ownership is NOT transferred!</returns>
+		static SpeculativeTravelContext * GetSpeculativeTravelContext() { return s_SpeculativeTravelContext; }
+
+		/// <summary>
+		/// Sets the SpeculativeTravelContext Atoms traveled on the calling thread should use. Only affects the calling thread.
+		/// </summary>
+		/// <param name="context">The context to travel under, or nullptr to go back to normal travel. Ownership is NOT transferred!</param>
+		static void SetSpeculativeTravelContext(SpeculativeTravelContext *context) { s_SpeculativeTravelContext = context; }
+
+		/// <summary>
+		/// Draws all trail pixels queued up in a SpeculativeTravelContext to the MO color layer and clears them from the context.
+		/// </summary>
+		/// <param name="context">The context to draw the queued trails of.</param>
+		static void DrawQueuedTrails(SpeculativeTravelContext &context);
 #pragma endregion
 
 #pragma region Operator Overloads
@@ -492,6 +564,7 @@ namespace RTE {
 		static int s_PoolAllocBlockCount; //!< The number of instances to fill up the pool of Atoms with each time it runs dry.
 		static int s_InstancesInUse; //!< The number of allocated instances passed out from the pool.
 		static const int s_NormalChecks[c_NormalCheckCount][2]; //!< This forms a circle around the Atom's offset center, to check for key color pixels in order to determine the normal at the Atom's position.
+		static thread_local SpeculativeTravelContext *s_SpeculativeTravelContext; //!< The context Atoms traveled on this thread are using, if traveling speculatively. Not owned.
 
 		Vector m_Offset; //!< The offset of this Atom for collision calculations.
 		Vector m_OriginalOffset; //!< This offset is before altering the m_Offset for use in composite groups.
@@ -0,0 +1,28 @@
+#include "CustomValueTable.h"
+
+namespace RTE {
+
+	std::unordered_map<std::string, unsigned int> CustomValueKeys::s_KeyIDs;
+	std::mutex CustomValueKeys::s_KeyIDsMutex;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned int CustomValueKeys::GetKeyID(const std::string &keyName) {
+		std::lock_guard<std::mutex> keyIDsLock(s_KeyIDsMutex);
+		std::unordered_map<std::string, unsigned int>::const_iterator keyIDEntry = s_KeyIDs.find(keyName);
+		if (keyIDEntry != s_KeyIDs.end()) {
+			return keyIDEntry->second;
+		}
+		unsigned int newKeyID = static_cast<unsigned int>(s_KeyIDs.size()) + 1;
+		s_KeyIDs.emplace(keyName, newKeyID);
+		return newKeyID;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned int CustomValueKeys::FindKeyID(const std::string &keyName) {
+		std::lock_guard<std::mutex> keyIDsLock(s_KeyIDsMutex);
+		std::unordered_map<std::string, unsigned int>::const_iterator keyIDEntry = s_KeyIDs.find(keyName);
+		return (keyIDEntry != s_KeyIDs.end()) ? keyIDEntry->second : c_NoKeyID;
+	}
+}
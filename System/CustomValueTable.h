@@ -0,0 +1,182 @@
+#ifndef _RTECUSTOMVALUETABLE_
+#define _RTECUSTOMVALUETABLE_
+
+namespace RTE {
+
+	/// <summary>
+	/// Hands out a small unique number for each custom value key name, so custom value tables can look keys up by number instead of comparing strings.
+	/// </summary>
+	class CustomValueKeys {
+
+	public:
+
+		static constexpr unsigned int c_NoKeyID = 0; //!< The key ID no key name ever gets. Custom value tables use it to mark empty slots.
+
+		/// <summary>
+		/// Gets the key ID of a key name, handing out a new one if the name never had one.
+		/// </summary>
+		/// <param name="keyName">The key name to get the ID of.</param>
+		/// <returns>The key ID of the name. Never c_NoKeyID.</returns>
+		static unsigned int GetKeyID(const std::string &keyName);
+
+		/// <summary>
+		/// Gets the key ID of a key name without handing out a new one, for lookups that can't succeed for a name no value was ever set with.
+		/// </summary>
+		/// <param name="keyName">The key name to get the ID of.</param>
+		/// <returns>The key ID of the name, or c_NoKeyID if the name never had one.</returns>
+		static unsigned int FindKeyID(const std::string &keyName);
+
+	private:
+
+		static std::unordered_map<std::string, unsigned int> s_KeyIDs; //!< The key IDs handed out so far, by key name.
+		static std::mutex s_KeyIDsMutex; //!< Mutex guarding the key IDs, since presets can be read while scripts run.
+	};
+
+	/// <summary>
+	/// A compact hash table of custom values keyed by the IDs from CustomValueKeys. The slots are kept in one flat array and collisions are resolved by probing the following slots,
+	/// so a lookup usually touches a single cache line and an empty table takes up no memory besides itself.
+	/// </summary>
+	template <typename Type>
+	class CustomValueTable {
+
+	public:
+
+		/// <summary>
+		/// Constructor method used to instantiate an empty CustomValueTable object in system memory.
+		/// </summary>
+		CustomValueTable() : m_ValueCount(0) {}
+
+		/// <summary>
+		/// Gets how many values are in this table.
+		/// </summary>
+		/// <returns>The number of values in this table.</returns>
+		size_t GetCount() const { return m_ValueCount; }
+
+		/// <summary>
+		/// Finds the value stored under a key.
+		/// </summary>
+		/// <param name="keyID">The ID of the key to look up.</param>
+		/// <returns>The value stored under the key, or nullptr if there is none. Only valid until the table is changed.</returns>
+		const Type * Find(unsigned int keyID) const {
+			if (m_ValueCount == 0 || keyID == CustomValueKeys::c_NoKeyID) {
+				return nullptr;
+			}
+			size_t slotMask = m_Slots.size() - 1;
+			for (size_t slotIndex = GetHomeSlot(keyID); ; slotIndex = (slotIndex + 1) & slotMask) {
+				if (m_Slots[slotIndex].m_KeyID == keyID) {
+					return &m_Slots[slotIndex].m_Value;
+				} else if (m_Slots[slotIndex].m_KeyID == CustomValueKeys::c_NoKeyID) {
+					return nullptr;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Stores a value under a key, replacing any value already stored under it.
+		/// </summary>
+		/// <param name="keyID">The ID of the key to store the value under.</param>
+		/// <param name="value">The value to store.</param>
+		void Set(unsigned int keyID, const Type &value) {
+			if (keyID == CustomValueKeys::c_NoKeyID) {
+				return;
+			}
+			// Keep at least a quarter of the slots empty so probe runs stay short.
+			if ((m_ValueCount + 1) * 4 > m_Slots.size() * 3) { Rehash(m_Slots.empty() ? c_MinSlotCount : m_Slots.size() * 2); }
+
+			size_t slotMask = m_Slots.size() - 1;
+			size_t slotIndex = GetHomeSlot(keyID);
+			while (m_Slots[slotIndex].m_KeyID != keyID && m_Slots[slotIndex].m_KeyID != CustomValueKeys::c_NoKeyID) {
+				slotIndex = (slotIndex + 1) & slotMask;
+			}
+			if (m_Slots[slotIndex].m_KeyID == CustomValueKeys::c_NoKeyID) {
+				m_Slots[slotIndex].m_KeyID = keyID;
+				m_ValueCount++;
+			}
+			m_Slots[slotIndex].m_Value = value;
+		}
+
+		/// <summary>
+		/// Removes the value stored under a key, if there is one.
+		/// </summary>
+		/// <param name="keyID">The ID of the key to remove the value of.</param>
+		void Remove(unsigned int keyID) {
+			if (m_ValueCount == 0 || keyID == CustomValueKeys::c_NoKeyID) {
+				return;
+			}
+			size_t slotMask = m_Slots.size() - 1;
+			size_t slotIndex = GetHomeSlot(keyID);
+			while (m_Slots[slotIndex].m_KeyID != keyID) {
+				if (m_Slots[slotIndex].m_KeyID == CustomValueKeys::c_NoKeyID) {
+					return;
+				}
+				slotIndex = (slotIndex + 1) & slotMask;
+			}
+			// Instead of leaving a marker in the emptied slot, move back any later values in the same probe run that could sit in it, so lookups never have to skip over removed values.
+			size_t emptySlotIndex = slotIndex;
+			for (size_t nextSlotIndex = (emptySlotIndex + 1) & slotMask; m_Slots[nextSlotIndex].m_KeyID != CustomValueKeys::c_NoKeyID; nextSlotIndex = (nextSlotIndex + 1) & slotMask) {
+				size_t nextHomeSlot = GetHomeSlot(m_Slots[nextSlotIndex].m_KeyID);
+				if (((nextSlotIndex - nextHomeSlot) & slotMask) >= ((nextSlotIndex - emptySlotIndex) & slotMask)) {
+					m_Slots[emptySlotIndex] = std::move(m_Slots[nextSlotIndex]);
+					emptySlotIndex = nextSlotIndex;
+				}
+			}
+			m_Slots[emptySlotIndex].m_KeyID = CustomValueKeys::c_NoKeyID;
+			m_Slots[emptySlotIndex].m_Value = Type();
+			m_ValueCount--;
+		}
+
+		/// <summary>
+		/// Removes all values from this table and frees its slots.
+		/// </summary>
+		void Clear() {
+			m_Slots.clear();
+			m_Slots.shrink_to_fit();
+			m_ValueCount = 0;
+		}
+
+	private:
+
+		static constexpr size_t c_MinSlotCount = 4; //!< How many slots a table gets when the first value is stored in it. Always a power of two.
+
+		/// <summary>
+		/// A slot of the table, holding a value and the ID of the key it's stored under, or no key ID if the slot is empty.
+		/// </summary>
+		struct Slot {
+			unsigned int m_KeyID = CustomValueKeys::c_NoKeyID; //!< The ID of the key the value is stored under.
+			Type m_Value = Type(); //!< The stored value.
+		};
+
+		std::vector<Slot> m_Slots; //!< The slots of the table. Its size is always zero or a power of two.
+		size_t m_ValueCount; //!< How many of the slots hold a value.
+
+		/// <summary>
+		/// Gets the slot a key's value goes in if no other value is in the way.
+		/// </summary>
+		/// <param name="keyID">The ID of the key.</param>
+		/// <returns>The index of the key's home slot.</returns>
+		size_t GetHomeSlot(unsigned int keyID) const {
+			// Key IDs are handed out in order, so they're scattered with a multiplicative hash to keep neighbouring IDs out of each other's probe runs.
+			return static_cast<size_t>((keyID * 2654435761U) >> 16) & (m_Slots.size() - 1);
+		}
+
+		/// <summary>
+		/// Moves all values into a new set of slots.
+		/// </summary>
+		/// <param name="slotCount">How many slots to have. Must be a power of two larger than the number of values.</param>
+		void Rehash(size_t slotCount) {
+			std::vector<Slot> oldSlots(slotCount);
+			oldSlots.swap(m_Slots);
+			size_t slotMask = m_Slots.size() - 1;
+			for (Slot &oldSlot : oldSlots) {
+				if (oldSlot.m_KeyID != CustomValueKeys::c_NoKeyID) {
+					size_t slotIndex = GetHomeSlot(oldSlot.m_KeyID);
+					while (m_Slots[slotIndex].m_KeyID != CustomValueKeys::c_NoKeyID) {
+						slotIndex = (slotIndex + 1) & slotMask;
+					}
+					m_Slots[slotIndex] = std::move(oldSlot);
+				}
+			}
+		}
+	};
+}
+#endif
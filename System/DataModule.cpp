@@ -373,6 +373,7 @@ namespace RTE {
 			(*itr).m_EntityPreset->ReloadScripts();
 		}
 		LoadScripts();
+		g_LuaMan.IncrementScriptPresetGeneration();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
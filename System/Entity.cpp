@@ -7,6 +7,8 @@ namespace RTE {
 
 	Entity::ClassInfo Entity::m_sClass("Entity");
 	Entity::ClassInfo * Entity::ClassInfo::s_ClassHead = 0;
+	int Entity::ClassInfo::s_ClassCount = 0;
+	thread_local Entity::ClassInfo::ThreadPoolCache Entity::ClassInfo::s_ThreadPoolCache;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -231,19 +233,37 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	Entity::ClassInfo::ClassInfo(const std::string &name, ClassInfo *parentInfo, MemoryAllocate allocFunc, MemoryDeallocate deallocFunc, Entity * (*newFunc)(), int allocBlockCount) :
+	Entity::ClassInfo::ClassInfo(const std::string &name, ClassInfo *parentInfo, MemoryAllocate allocFunc, MemoryDeallocate deallocFunc, Entity * (*newFunc)(), int allocBlockCount, size_t instanceSize) :
 		m_Name(name),
 		m_ParentInfo(parentInfo),
 		m_Allocate(allocFunc),
 		m_Deallocate(deallocFunc),
 		m_NewInstance(newFunc),
-		m_NextClass(s_ClassHead) {
+		m_NextClass(s_ClassHead),
+		m_InstancesInUse(0),
+		m_InstancesInUseHighWaterMark(0) {
 			s_ClassHead = this;
+			m_PoolIndex = s_ClassCount++;
 
 			m_AllocatedPool.clear();
 			m_PoolAllocBlockCount = (allocBlockCount > 0) ? allocBlockCount : 10;
+
+			// Round the size up so every instance carved out of a slab is as aligned as malloc would have made it
+			const size_t alignment = alignof(std::max_align_t);
+			m_InstanceSize = (instanceSize + alignment - 1) / alignment * alignment;
 		}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Entity::ClassInfo::ThreadPoolCache::~ThreadPoolCache() {
+		for (ClassInfo *itr = s_ClassHead; itr != 0; itr = itr->m_NextClass) {
+			if (itr->m_PoolIndex < static_cast<int>(FreeChunks.size()) && !FreeChunks[itr->m_PoolIndex].empty()) {
+				std::lock_guard<std::mutex> poolLock(itr->m_PoolMutex);
+				itr->m_AllocatedPool.insert(itr->m_AllocatedPool.end(), FreeChunks[itr->m_PoolIndex].begin(), FreeChunks[itr->m_PoolIndex].end());
+			}
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	std::list<std::string> Entity::ClassInfo::GetClassNames() {
@@ -282,30 +302,68 @@ namespace RTE {
 		// Default to the set block allocation size if fillAmount is 0
 		if (fillAmount <= 0) { fillAmount = m_PoolAllocBlockCount; }
 
+		std::lock_guard<std::mutex> poolLock(m_PoolMutex);
+		FillPoolLocked(fillAmount);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void Entity::ClassInfo::FillPoolLocked(int fillAmount) {
 		// If concrete class, fill up the pool with pre-allocated memory blocks the size of the type
-		if (m_Allocate && fillAmount > 0) {
+		if (!m_Allocate || fillAmount <= 0) {
+			return;
+		}
+		if (m_InstanceSize == 0) {
 			for (int i = 0; i < fillAmount; ++i) {
 				m_AllocatedPool.push_back(m_Allocate());
 			}
+			return;
+		}
+		// Carve all the instances out of one contiguous slab instead of allocating each one separately, so they're near each other in memory and it only takes one trip to the heap
+		m_Slabs.emplace_back(new char[m_InstanceSize * static_cast<size_t>(fillAmount)]);
+		char *slab = m_Slabs.back().get();
+
+		m_AllocatedPool.reserve(m_AllocatedPool.size() + fillAmount);
+		// Pushed in reverse so the pool hands the slab out front to back
+		for (int i = fillAmount - 1; i >= 0; --i) {
+			m_AllocatedPool.push_back(slab + m_InstanceSize * static_cast<size_t>(i));
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::vector<void *> & Entity::ClassInfo::GetThreadCache() {
+		std::vector<std::vector<void *>> &threadFreeChunks = s_ThreadPoolCache.FreeChunks;
+		if (m_PoolIndex >= static_cast<int>(threadFreeChunks.size())) { threadFreeChunks.resize(s_ClassCount); }
+		return threadFreeChunks[m_PoolIndex];
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void * Entity::ClassInfo::GetPoolMemory() {
 		RTEAssert(IsConcrete(), "Trying to get pool memory of an abstract Entity class!");
 
-		// If the pool is empty, then fill it up again with as many instances as we are set to
-		if (m_AllocatedPool.empty()) { FillPool((m_PoolAllocBlockCount > 0) ? m_PoolAllocBlockCount : 10); }
+		std::vector<void *> &threadCache = GetThreadCache();
+
+		// If this thread has nothing cached, take a batch from the shared pool, filling it up again with as many instances as we are set to if it's empty too
+		if (threadCache.empty()) {
+			std::lock_guard<std::mutex> poolLock(m_PoolMutex);
+			if (m_AllocatedPool.empty()) { FillPoolLocked(m_PoolAllocBlockCount); }
 
-		// Get the instance in the top of the pool and pop it off
-		void *foundMemory = m_AllocatedPool.back();
-		m_AllocatedPool.pop_back();
+			size_t batchSize = std::min(m_AllocatedPool.size(), static_cast<size_t>(std::max(m_PoolAllocBlockCount / 2, 1)));
+			threadCache.insert(threadCache.end(), m_AllocatedPool.end() - batchSize, m_AllocatedPool.end());
+			m_AllocatedPool.resize(m_AllocatedPool.size() - batchSize);
+		}
+		RTEAssert(!threadCache.empty(), "Could not find an available instance in the pool, even after increasing its size!");
 
-		RTEAssert(foundMemory, "Could not find an available instance in the pool, even after increasing its size!");
+		// Get the instance in the top of the cache and pop it off
+		void *foundMemory = threadCache.back();
+		threadCache.pop_back();
 
-		// Keep track of the number of instances passed out
-		m_InstancesInUse++;
+		// Keep track of the number of instances passed out, and the most there ever were
+		int instancesInUse = ++m_InstancesInUse;
+		int highWaterMark = m_InstancesInUseHighWaterMark.load(std::memory_order_relaxed);
+		while (instancesInUse > highWaterMark && !m_InstancesInUseHighWaterMark.compare_exchange_weak(highWaterMark, instancesInUse, std::memory_order_relaxed)) {}
 
 		return foundMemory;
 	}
@@ -316,19 +374,26 @@ namespace RTE {
 		if (!returnedMemory) {
 			return 0;
 		}
-		m_AllocatedPool.push_back(returnedMemory);
+		std::vector<void *> &threadCache = GetThreadCache();
+		threadCache.push_back(returnedMemory);
+
+		// Don't let a thread that frees more than it gets hoard memory, give half of the cache back to the shared pool when it grows too big
+		if (threadCache.size() > static_cast<size_t>(m_PoolAllocBlockCount)) {
+			size_t batchSize = threadCache.size() / 2;
+			std::lock_guard<std::mutex> poolLock(m_PoolMutex);
+			m_AllocatedPool.insert(m_AllocatedPool.end(), threadCache.end() - batchSize, threadCache.end());
+			threadCache.resize(threadCache.size() - batchSize);
+		}
 
 		// Keep track of the number of instances passed in
-		m_InstancesInUse--;
-
-		return m_InstancesInUse;
+		return --m_InstancesInUse;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void Entity::ClassInfo::DumpPoolMemoryInfo(Writer &fileWriter) {
 		for (const ClassInfo *itr = s_ClassHead; itr != 0; itr = itr->m_NextClass) {
-			if (itr->IsConcrete()) { fileWriter << itr->GetName() << ": " << itr->m_InstancesInUse << "\n"; }
+			if (itr->IsConcrete()) { fileWriter << itr->GetName() << ": " << itr->m_InstancesInUse.load() << " (high-water mark: " << itr->GetPoolHighWaterMark() << ", slabs: " << itr->GetPoolSlabCount() << " of " << itr->m_PoolAllocBlockCount << ")\n"; }
 		}
 	}
-}
\ No newline at end of file
+}
@@ -4,6 +4,9 @@
 #include "Serializable.h"
 #include "RTEError.h"
 
+#include <atomic>
+#include <memory>
+
 namespace RTE {
 
 	typedef std::function<void*()> MemoryAllocate; //!< Convenient name definition for the memory allocation callback function.
@@ -14,10 +17,10 @@ namespace RTE {
 		Entity::ClassInfo TYPE::m_sClass(#TYPE, &PARENT::m_sClass);
 
 	#define ConcreteClassInfo(TYPE, PARENT, BLOCKCOUNT) \
-		Entity::ClassInfo TYPE::m_sClass(#TYPE, &PARENT::m_sClass, TYPE::Allocate, TYPE::Deallocate, TYPE::NewInstance, BLOCKCOUNT);
+		Entity::ClassInfo TYPE::m_sClass(#TYPE, &PARENT::m_sClass, TYPE::Allocate, TYPE::Deallocate, TYPE::NewInstance, BLOCKCOUNT, sizeof(TYPE));
 
 	#define ConcreteSubClassInfo(TYPE, SUPER, PARENT, BLOCKCOUNT) \
-		Entity::ClassInfo SUPER::TYPE::m_sClass(#TYPE, &PARENT::m_sClass, SUPER::TYPE::Allocate, SUPER::TYPE::Deallocate, SUPER::TYPE::NewInstance, BLOCKCOUNT);
+		Entity::ClassInfo SUPER::TYPE::m_sClass(#TYPE, &PARENT::m_sClass, SUPER::TYPE::Allocate, SUPER::TYPE::Deallocate, SUPER::TYPE::NewInstance, BLOCKCOUNT, sizeof(SUPER::TYPE));
 
 	/// <summary>
 	/// Convenience macro to cut down on duplicate ClassInfo methods in classes that extend Entity.
@@ -94,7 +97,8 @@ namespace RTE {
 			/// <param name="deallocFunc">Function pointer to the raw deallocation function of memory. If the represented Entity subclass isn't concrete, pass in 0.</param>
 			/// <param name="newFunc">Function pointer to the new instance factory. If the represented Entity subclass isn't concrete, pass in 0.</param>
 			/// <param name="allocBlockCount">The number of new instances to fill the pre-allocated pool with when it runs out.</param>
-			ClassInfo(const std::string &name, ClassInfo *parentInfo = 0, MemoryAllocate allocFunc = 0, MemoryDeallocate deallocFunc = 0, Entity * (*newFunc)() = 0, int allocBlockCount = 10);
+			/// <param name="instanceSize">The size of the represented Entity subclass. If 0, the pool is filled one allocFunc call at a time instead of carving instances out of slabs.</param>
+			ClassInfo(const std::string &name, ClassInfo *parentInfo = 0, MemoryAllocate allocFunc = 0, MemoryDeallocate deallocFunc = 0, Entity * (*newFunc)() = 0, int allocBlockCount = 10, size_t instanceSize = 0);
 #pragma endregion
 
 #pragma region Getters
@@ -122,24 +126,37 @@ namespace RTE {
 			/// </summary>
 			/// <returns>A pointer to the parent ClassInfo. 0 if this is a root class.</returns>
 			const ClassInfo * GetParent() const { return m_ParentInfo; }
+
+			/// <summary>
+			/// Gets the largest number of instances of this type that were passed out from the pool at the same time.
+			/// </summary>
+			/// <returns>The high-water mark of instances in use.</returns>
+			int GetPoolHighWaterMark() const { return m_InstancesInUseHighWaterMark.load(std::memory_order_relaxed); }
+
+			/// <summary>
+			/// Gets the number of slabs the pool of this type has allocated so far.
+			/// </summary>
+			/// <returns>The number of slabs.</returns>
+			int GetPoolSlabCount() const { std::lock_guard<std::mutex> poolLock(m_PoolMutex); return static_cast<int>(m_Slabs.size()); }
 #pragma endregion
 
 #pragma region Memory Management
 			/// <summary>
 			/// Grabs from the pre-allocated pool, an available chunk of memory the exact size of the Entity this ClassInfo represents. OWNERSHIP IS TRANSFERRED!
+			/// Safe to call from any thread. Each thread keeps a small cache of free chunks so it only needs to lock the shared pool once in a while.
 			/// </summary>
 			/// <returns>A pointer to the pre-allocated pool memory. OWNERSHIP IS TRANSFERRED!</returns>
 			virtual void * GetPoolMemory();
 
 			/// <summary>
-			/// Returns a raw chunk of memory back to the pre-allocated available pool.
+			/// Returns a raw chunk of memory back to the pre-allocated available pool. Safe to call from any thread, not just the one that got the chunk.
 			/// </summary>
 			/// <param name="returnedMemory">The raw chunk of memory that is being returned. Needs to be the same size as the type this ClassInfo describes. OWNERSHIP IS TRANSFERRED!</param>
 			/// <returns>The count of outstanding memory chunks after this was returned.</returns>
 			virtual int ReturnPoolMemory(void *returnedMemory);
 
 			/// <summary>
-			/// Writes a bunch of useful debug info about the memory pools to a file.
+			/// Writes a bunch of useful debug info about the memory pools to a file. For every concrete type this is the number of instances in use, the high-water mark and how many slabs were allocated.
 			/// </summary>
 			/// <param name="fileWriter">The writer to write info to.</param>
 			static void DumpPoolMemoryInfo(Writer &fileWriter);
@@ -173,7 +190,21 @@ namespace RTE {
 
 		protected:
 
+			/// <summary>
+			/// Free chunks of pool memory kept by a single thread, so getting and returning memory doesn't need to lock the shared pools every time.
+			/// </summary>
+			struct ThreadPoolCache {
+				std::vector<std::vector<void *>> FreeChunks; //!< The cached free chunks of each pool, indexed by the ClassInfo's pool index.
+
+				/// <summary>
+				/// Destructor method used to hand all cached chunks back to their shared pools when the thread ends.
+				/// </summary>
+				~ThreadPoolCache();
+			};
+
 			static ClassInfo *s_ClassHead; //!< Head of unordered linked list of ClassInfos in existence.
+			static int s_ClassCount; //!< The number of ClassInfos in existence. Used to give each a unique pool index.
+			static thread_local ThreadPoolCache s_ThreadPoolCache; //!< The calling thread's cache of free chunks.
 
 			const std::string m_Name; //!< A string with the friendly - formatted name of this ClassInfo.
 			const ClassInfo *m_ParentInfo; //!< A pointer to the parent ClassInfo.
@@ -186,8 +217,25 @@ namespace RTE {
 			ClassInfo *m_NextClass; //!< Next ClassInfo after this one on aforementioned unordered linked list.
 
 			std::vector<void *> m_AllocatedPool; //!< Pool of pre-allocated objects of the type described by this ClassInfo.
-			int m_PoolAllocBlockCount; //!< The number of instances to fill up the pool of this type with each time it runs dry.
-			int m_InstancesInUse; //!< The number of allocated instances passed out from the pool.
+			std::vector<std::unique_ptr<char[]>> m_Slabs; //!< The contiguous blocks of memory the pool instances were carved out of. Owned by this and freed along with it.
+			mutable std::mutex m_PoolMutex; //!< Guards the shared pool and slabs against being used from multiple threads at once.
+			int m_PoolIndex; //!< The index of this ClassInfo's cache in each thread's ThreadPoolCache.
+			int m_PoolAllocBlockCount; //!< The number of instances to fill up the pool of this type with each time it runs dry. Also the number of instances in each slab.
+			size_t m_InstanceSize; //!< The size of each instance in the slabs, rounded up to keep every instance aligned. 0 if slabs aren't used.
+			std::atomic<int> m_InstancesInUse; //!< The number of allocated instances passed out from the pool.
+			std::atomic<int> m_InstancesInUseHighWaterMark; //!< The largest number of allocated instances passed out from the pool at the same time.
+
+			/// <summary>
+			/// Adds a certain number of newly allocated instances to this' pool. The pool mutex must already be locked.
+			/// </summary>
+			/// <param name="fillAmount">The number of instances to fill the pool with.</param>
+			void FillPoolLocked(int fillAmount);
+
+			/// <summary>
+			/// Gets the calling thread's cache of free chunks for this' pool.
+			/// </summary>
+			/// <returns>The calling thread's free chunks for this' pool.</returns>
+			std::vector<void *> & GetThreadCache();
 
 
 			// Forbidding copying
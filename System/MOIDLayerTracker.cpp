@@ -0,0 +1,448 @@
+#include "MOIDLayerTracker.h"
+#include "MovableObject.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::Clear() {
+		m_MOIDLayer = nullptr;
+		m_WrapsX = false;
+		m_WrapsY = false;
+		m_TrackedObjects.clear();
+		m_ObjectsByFirstID.clear();
+		m_TakenIDCount = 0;
+		m_ErasedAreas.clear();
+		m_UpdateCount = 0;
+		m_RoundCount = 0;
+		m_QueryCount = 0;
+		m_CellCountX = 0;
+		m_CellCountY = 0;
+		m_Cells.clear();
+		m_OccupiedCells.clear();
+		m_ScratchIndex.clear();
+		m_TakenDrawings.clear();
+		m_CellsOfArea.clear();
+		m_ValidationLayer = nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::Reset() {
+		if (m_ValidationLayer) { destroy_bitmap(m_ValidationLayer); }
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::ForgetTrackedObjects() {
+		m_TrackedObjects.clear();
+		m_ObjectsByFirstID.clear();
+		m_TakenIDCount = 0;
+		m_ErasedAreas.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::Update(BITMAP *moidLayer, const std::vector<MovableObject *> &rootObjects, std::vector<MovableObject *> &moidIndex, bool objectsRedrawThemselves) {
+		if (!moidLayer) {
+			return;
+		}
+		if (moidLayer != m_MOIDLayer) {
+			// A different layer has none of the tracked drawings on it, so everything is drawn anew without erasing anything.
+			ForgetTrackedObjects();
+			m_MOIDLayer = moidLayer;
+			m_WrapsX = g_SceneMan.SceneWrapsX();
+			m_WrapsY = g_SceneMan.SceneWrapsY();
+			m_CellCountX = (m_MOIDLayer->w + c_CellSize - 1) / c_CellSize;
+			m_CellCountY = (m_MOIDLayer->h + c_CellSize - 1) / c_CellSize;
+			m_Cells.clear();
+			m_Cells.resize(m_CellCountX * m_CellCountY);
+			m_OccupiedCells.clear();
+		} else if (moidIndex.size() > c_MinIndexSizeToCompact && moidIndex.size() > static_cast<size_t>(m_TakenIDCount) * 2) {
+			// Removed objects left too much of the index unused, so start over with all objects packed at the start of it.
+			EraseAll();
+		}
+		m_UpdateCount++;
+
+		// Pick up whatever was drawn onto the layer since the last update, like the MOID drawings made during travel, before anything more is drawn.
+		m_TakenDrawings.clear();
+		g_SceneMan.TakeMOIDDrawings(m_TakenDrawings);
+
+		std::vector<TrackedObject *> newObjects;
+		for (int drawOrder = 0; drawOrder < static_cast<int>(rootObjects.size()); ++drawOrder) {
+			std::pair<std::unordered_map<const MovableObject *, TrackedObject>::iterator, bool> trackedEntry = m_TrackedObjects.emplace(rootObjects[drawOrder], TrackedObject());
+			TrackedObject &trackedObject = trackedEntry.first->second;
+			if (trackedEntry.second) {
+				trackedObject.m_Object = rootObjects[drawOrder];
+				newObjects.push_back(&trackedObject);
+			}
+			trackedObject.m_DrawOrder = drawOrder;
+			trackedObject.m_SeenUpdate = m_UpdateCount;
+		}
+		for (std::unordered_map<const MovableObject *, TrackedObject>::iterator trackedEntry = m_TrackedObjects.begin(); trackedEntry != m_TrackedObjects.end();) {
+			if (trackedEntry->second.m_SeenUpdate != m_UpdateCount) {
+				EraseDrawings(trackedEntry->second);
+				if (trackedEntry->second.m_IDCount > 0) { m_ObjectsByFirstID.erase(trackedEntry->second.m_FirstID); }
+				trackedEntry = m_TrackedObjects.erase(trackedEntry);
+			} else {
+				++trackedEntry;
+			}
+		}
+		PlaceNewObjects(newObjects);
+
+		// Register every object in its own range of the index. The ranges are gone through in order, so everything before a range is already in place when the index is cut to its start.
+		moidIndex.clear();
+		// Keep MOID 0 free, like a full redraw does.
+		moidIndex.push_back(nullptr);
+		m_TakenIDCount = 0;
+		std::vector<TrackedObject *> outgrownObjects;
+		for (std::map<MOID, TrackedObject *>::iterator rangeEntry = m_ObjectsByFirstID.begin(); rangeEntry != m_ObjectsByFirstID.end();) {
+			TrackedObject &trackedObject = *rangeEntry->second;
+			std::map<MOID, TrackedObject *>::iterator nextRangeEntry = std::next(rangeEntry);
+			moidIndex.resize(trackedObject.m_FirstID, nullptr);
+			trackedObject.m_Object->UpdateMOID(moidIndex);
+			if (nextRangeEntry != m_ObjectsByFirstID.end() && moidIndex.size() > static_cast<size_t>(nextRangeEntry->first)) {
+				// The object now has more MOIDs than fit before the next range, so it gets a new range at the end of the index once everything else is in place.
+				moidIndex.resize(trackedObject.m_FirstID);
+				outgrownObjects.push_back(&trackedObject);
+				m_ObjectsByFirstID.erase(rangeEntry);
+			} else {
+				UpdateDrawState(trackedObject, moidIndex);
+			}
+			rangeEntry = nextRangeEntry;
+		}
+		for (TrackedObject *outgrownObject : outgrownObjects) {
+			outgrownObject->m_FirstID = static_cast<MOID>(moidIndex.size());
+			outgrownObject->m_Object->UpdateMOID(moidIndex);
+			m_ObjectsByFirstID.emplace(outgrownObject->m_FirstID, outgrownObject);
+			UpdateDrawState(*outgrownObject, moidIndex);
+		}
+
+		// The objects that didn't change are sorted into the grid, so the ones overlapping anything erased or drawn over can be found.
+		for (int cellIndex : m_OccupiedCells) {
+			m_Cells[cellIndex].clear();
+		}
+		m_OccupiedCells.clear();
+		for (std::pair<const MovableObject * const, TrackedObject> &trackedEntry : m_TrackedObjects) {
+			if (!trackedEntry.second.m_NeedsRedraw) { AddToGrid(trackedEntry.second); }
+		}
+
+		// Drawings made since the last update that match where an unchanged object was drawn are that object being drawn over itself, which only matters where it overlaps objects later in the draw order.
+		// Anything else was drawn by objects that have changed or are gone since, so it's erased.
+		std::vector<TrackedObject *> restampedObjects;
+		for (const IntRect &drawing : m_TakenDrawings) {
+			TrackedObject *drawingObject = FindObjectDrawnTo(drawing);
+			if (drawingObject) {
+				if (!drawingObject->m_Restamped) {
+					drawingObject->m_Restamped = true;
+					restampedObjects.push_back(drawingObject);
+				}
+			} else {
+				g_SceneMan.ClearMOIDRect(drawing.m_Left, drawing.m_Top, drawing.m_Right, drawing.m_Bottom);
+				m_ErasedAreas.push_back(drawing);
+			}
+		}
+
+		// The first round draws the changed objects and everything overlapping the erased areas, along with the unchanged objects that erased themselves but didn't draw themselves again where they were. Each following round draws the objects later in the draw order that overlap something drawn in the round before,
+		// since that was drawn over them when a full redraw would have drawn them on top. Every round only picks objects later than the earliest one drawn in the round before, so this always comes to an end.
+		std::vector<TrackedObject *> objectsToDraw;
+		unsigned int drawRound = ++m_RoundCount;
+		for (std::pair<const MovableObject * const, TrackedObject> &trackedEntry : m_TrackedObjects) {
+			if (trackedEntry.second.m_NeedsRedraw || (objectsRedrawThemselves && !trackedEntry.second.m_Restamped)) {
+				trackedEntry.second.m_ScheduledRound = drawRound;
+				objectsToDraw.push_back(&trackedEntry.second);
+			}
+		}
+		for (const IntRect &erasedArea : m_ErasedAreas) {
+			PickOverlappingObjects(erasedArea, -1, 0, drawRound, objectsToDraw);
+		}
+		for (TrackedObject *restampedObject : restampedObjects) {
+			for (const IntRect &drawing : restampedObject->m_Drawings) {
+				PickOverlappingObjects(drawing, restampedObject->m_DrawOrder, 0, drawRound, objectsToDraw);
+			}
+			restampedObject->m_Restamped = false;
+		}
+		m_ErasedAreas.clear();
+
+		std::vector<TrackedObject *> drawnObjects;
+		while (!objectsToDraw.empty()) {
+			std::sort(objectsToDraw.begin(), objectsToDraw.end(), [](const TrackedObject *lhs, const TrackedObject *rhs) { return lhs->m_DrawOrder < rhs->m_DrawOrder; });
+			drawnObjects.swap(objectsToDraw);
+			objectsToDraw.clear();
+			for (TrackedObject *drawnObject : drawnObjects) {
+				DrawObject(*drawnObject);
+				drawnObject->m_DrawnRound = drawRound;
+			}
+			unsigned int nextDrawRound = ++m_RoundCount;
+			for (const TrackedObject *drawnObject : drawnObjects) {
+				for (const IntRect &drawing : drawnObject->m_Drawings) {
+					PickOverlappingObjects(drawing, drawnObject->m_DrawOrder, drawRound, nextDrawRound, objectsToDraw);
+				}
+			}
+			drawRound = nextDrawRound;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::PlaceNewObjects(const std::vector<TrackedObject *> &newObjects) {
+		if (newObjects.empty()) {
+			return;
+		}
+		// A range spanning g_NoMOID needs one MOID more, since RegMOID skips it.
+		auto neededIDCount = [](MOID firstID, int idCount) { return (firstID <= g_NoMOID && firstID + idCount > g_NoMOID) ? idCount + 1 : idCount; };
+
+		std::vector<std::pair<MOID, MOID>> gaps;
+		MOID endOfRanges = 1;
+		for (const std::pair<const MOID, TrackedObject *> &rangeEntry : m_ObjectsByFirstID) {
+			if (rangeEntry.first > endOfRanges) { gaps.emplace_back(endOfRanges, rangeEntry.first); }
+			endOfRanges = rangeEntry.first + rangeEntry.second->m_IDCount;
+		}
+		for (TrackedObject *newObject : newObjects) {
+			// The footprint is measured on the side. If it turns out different once the object is registered in its range, it's handled like any other object whose footprint changed.
+			m_ScratchIndex.clear();
+			newObject->m_Object->UpdateMOID(m_ScratchIndex);
+			int idCount = static_cast<int>(m_ScratchIndex.size());
+
+			bool placedInGap = false;
+			for (std::pair<MOID, MOID> &gap : gaps) {
+				int gapIDCount = neededIDCount(gap.first, idCount);
+				if (gap.second - gap.first >= gapIDCount) {
+					newObject->m_FirstID = gap.first;
+					newObject->m_IDCount = gapIDCount;
+					gap.first += gapIDCount;
+					placedInGap = true;
+					break;
+				}
+			}
+			if (!placedInGap) {
+				newObject->m_FirstID = endOfRanges;
+				newObject->m_IDCount = neededIDCount(endOfRanges, idCount);
+				endOfRanges += newObject->m_IDCount;
+			}
+			m_ObjectsByFirstID.emplace(newObject->m_FirstID, newObject);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::UpdateDrawState(TrackedObject &trackedObject, const std::vector<MovableObject *> &moidIndex) {
+		trackedObject.m_IDCount = static_cast<int>(moidIndex.size()) - trackedObject.m_FirstID;
+		m_TakenIDCount += trackedObject.m_IDCount;
+
+		// Each object in the range is hashed in the order of the index along with its own draw state, so the state also changes whenever any MOID does.
+		size_t drawState = std::hash<MOID>()(trackedObject.m_FirstID);
+		for (size_t moid = trackedObject.m_FirstID; moid < moidIndex.size(); ++moid) {
+			if (const MovableObject *rangeObject = moidIndex[moid]) {
+				drawState = drawState * 31 + (std::hash<const MovableObject *>()(rangeObject) ^ rangeObject->GetMOIDDrawState());
+			}
+		}
+		if (trackedObject.m_NeedsRedraw || drawState != trackedObject.m_DrawState) {
+			trackedObject.m_DrawState = drawState;
+			trackedObject.m_NeedsRedraw = true;
+			EraseDrawings(trackedObject);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::DrawObject(TrackedObject &trackedObject) {
+		trackedObject.m_Object->Draw(m_MOIDLayer, Vector(), g_DrawMOID, true);
+		m_TakenDrawings.clear();
+		g_SceneMan.TakeMOIDDrawings(m_TakenDrawings);
+		trackedObject.m_Drawings.assign(m_TakenDrawings.begin(), m_TakenDrawings.end());
+		trackedObject.m_NeedsRedraw = false;
+
+		// Unchanged objects are drawn to the same areas as before, which are in the grid already.
+		if (trackedObject.m_GridUpdate != m_UpdateCount) { AddToGrid(trackedObject); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::EraseDrawings(TrackedObject &trackedObject) {
+		for (const IntRect &drawing : trackedObject.m_Drawings) {
+			g_SceneMan.ClearMOIDRect(drawing.m_Left, drawing.m_Top, drawing.m_Right, drawing.m_Bottom);
+			m_ErasedAreas.push_back(drawing);
+		}
+		trackedObject.m_Drawings.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::EraseObject(const MovableObject *object) {
+		std::unordered_map<const MovableObject *, TrackedObject>::iterator trackedEntry = m_TrackedObjects.find(object);
+		if (trackedEntry != m_TrackedObjects.end()) {
+			EraseDrawings(trackedEntry->second);
+			trackedEntry->second.m_NeedsRedraw = true;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::EraseAll() {
+		if (m_TrackedObjects.empty()) {
+			return;
+		}
+		for (std::pair<const MovableObject * const, TrackedObject> &trackedEntry : m_TrackedObjects) {
+			for (const IntRect &drawing : trackedEntry.second.m_Drawings) {
+				g_SceneMan.ClearMOIDRect(drawing.m_Left, drawing.m_Top, drawing.m_Right, drawing.m_Bottom);
+			}
+		}
+		ForgetTrackedObjects();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int MOIDLayerTracker::Validate(const std::vector<MovableObject *> &rootObjects) {
+		if (!m_MOIDLayer || bitmap_color_depth(m_MOIDLayer) != c_MOIDLayerBitDepth) {
+			return 0;
+		}
+		if (m_ValidationLayer && (m_ValidationLayer->w != m_MOIDLayer->w || m_ValidationLayer->h != m_MOIDLayer->h)) {
+			destroy_bitmap(m_ValidationLayer);
+			m_ValidationLayer = nullptr;
+		}
+		if (!m_ValidationLayer) { m_ValidationLayer = create_bitmap_ex(c_MOIDLayerBitDepth, m_MOIDLayer->w, m_MOIDLayer->h); }
+
+		clear_to_color(m_ValidationLayer, g_NoMOID);
+		for (MovableObject *rootObject : rootObjects) {
+			rootObject->Draw(m_ValidationLayer, Vector(), g_DrawMOID, true);
+		}
+		// The areas registered by drawing onto the validation layer aren't on the MOID layer, so they mustn't get cleared from it.
+		m_TakenDrawings.clear();
+		g_SceneMan.TakeMOIDDrawings(m_TakenDrawings);
+		m_TakenDrawings.clear();
+
+		int differingPixelCount = 0;
+		for (int posY = 0; posY < m_MOIDLayer->h; ++posY) {
+			const unsigned short *layerRow = reinterpret_cast<const unsigned short *>(m_MOIDLayer->line[posY]);
+			const unsigned short *validationRow = reinterpret_cast<const unsigned short *>(m_ValidationLayer->line[posY]);
+			if (std::memcmp(layerRow, validationRow, m_MOIDLayer->w * sizeof(unsigned short)) != 0) {
+				for (int posX = 0; posX < m_MOIDLayer->w; ++posX) {
+					if (layerRow[posX] != validationRow[posX]) { differingPixelCount++; }
+				}
+			}
+		}
+		if (differingPixelCount > 0) { blit(m_ValidationLayer, m_MOIDLayer, 0, 0, 0, 0, m_MOIDLayer->w, m_MOIDLayer->h); }
+		return differingPixelCount;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::AddToGrid(TrackedObject &trackedObject) {
+		trackedObject.m_GridUpdate = m_UpdateCount;
+		for (const IntRect &drawing : trackedObject.m_Drawings) {
+			GetCellsOfArea(drawing, m_CellsOfArea);
+			for (int cellIndex : m_CellsOfArea) {
+				std::vector<TrackedObject *> &cell = m_Cells[cellIndex];
+				if (cell.empty()) {
+					m_OccupiedCells.push_back(cellIndex);
+				} else if (cell.back() == &trackedObject) {
+					continue;
+				}
+				cell.push_back(&trackedObject);
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	MOIDLayerTracker::TrackedObject * MOIDLayerTracker::FindObjectDrawnTo(const IntRect &area) {
+		GetCellsOfArea(area, m_CellsOfArea);
+		if (m_CellsOfArea.empty()) {
+			return nullptr;
+		}
+		// An object drawn to exactly this area is in every cell the area covers, so looking through one of them is enough.
+		for (TrackedObject *cellObject : m_Cells[m_CellsOfArea.front()]) {
+			for (const IntRect &drawing : cellObject->m_Drawings) {
+				if (drawing.m_Left == area.m_Left && drawing.m_Top == area.m_Top && drawing.m_Right == area.m_Right && drawing.m_Bottom == area.m_Bottom) {
+					return cellObject;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::PickOverlappingObjects(const IntRect &area, int afterDrawOrder, unsigned int skippedRound, unsigned int scheduledRound, std::vector<TrackedObject *> &pickedObjects) {
+		m_QueryCount++;
+		GetCellsOfArea(area, m_CellsOfArea);
+		for (int cellIndex : m_CellsOfArea) {
+			for (TrackedObject *cellObject : m_Cells[cellIndex]) {
+				if (cellObject->m_QueryStamp == m_QueryCount) {
+					continue;
+				}
+				cellObject->m_QueryStamp = m_QueryCount;
+				if (cellObject->m_DrawOrder <= afterDrawOrder || cellObject->m_DrawnRound == skippedRound || cellObject->m_ScheduledRound == scheduledRound) {
+					continue;
+				}
+				for (const IntRect &drawing : cellObject->m_Drawings) {
+					if (AreasOverlap(area, drawing)) {
+						cellObject->m_ScheduledRound = scheduledRound;
+						pickedObjects.push_back(cellObject);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MOIDLayerTracker::GetCellsOfArea(const IntRect &area, std::vector<int> &cells) const {
+		cells.clear();
+		int cellSpansX[2][2];
+		int cellSpansY[2][2];
+		int cellSpanCountX = GetCellSpans(area.m_Left, area.m_Right, m_MOIDLayer->w, m_WrapsX, cellSpansX);
+		int cellSpanCountY = GetCellSpans(area.m_Top, area.m_Bottom, m_MOIDLayer->h, m_WrapsY, cellSpansY);
+
+		for (int spanY = 0; spanY < cellSpanCountY; ++spanY) {
+			for (int cellY = cellSpansY[spanY][0]; cellY <= cellSpansY[spanY][1]; ++cellY) {
+				for (int spanX = 0; spanX < cellSpanCountX; ++spanX) {
+					for (int cellX = cellSpansX[spanX][0]; cellX <= cellSpansX[spanX][1]; ++cellX) {
+						cells.push_back(cellY * m_CellCountX + cellX);
+					}
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int MOIDLayerTracker::GetCellSpans(int first, int last, int size, bool wraps, int cellSpans[2][2]) const {
+		if (!wraps || last - first + 1 >= size) {
+			first = std::max(first, 0);
+			last = std::min(last, size - 1);
+			if (first > last) {
+				return 0;
+			}
+			cellSpans[0][0] = first / c_CellSize;
+			cellSpans[0][1] = last / c_CellSize;
+			return 1;
+		}
+		int wrappedFirst = ((first % size) + size) % size;
+		int wrappedLast = wrappedFirst + (last - first);
+		cellSpans[0][0] = wrappedFirst / c_CellSize;
+		cellSpans[0][1] = std::min(wrappedLast, size - 1) / c_CellSize;
+		if (wrappedLast < size) {
+			return 1;
+		}
+		cellSpans[1][0] = 0;
+		cellSpans[1][1] = (wrappedLast - size) / c_CellSize;
+		return 2;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool MOIDLayerTracker::AreasOverlap(const IntRect &area, const IntRect &otherArea) const {
+		// The areas are unwrapped, but never more than a layer's size away from it, so moving the other area over by one layer's size in each direction is enough to catch overlaps across the seams.
+		auto spansOverlap = [](int first, int last, int otherFirst, int otherLast, int size, bool wraps) {
+			if (first <= otherLast && last >= otherFirst) {
+				return true;
+			}
+			return wraps && ((first <= otherLast + size && last >= otherFirst + size) || (first <= otherLast - size && last >= otherFirst - size));
+		};
+		return spansOverlap(area.m_Left, area.m_Right, otherArea.m_Left, otherArea.m_Right, m_MOIDLayer->w, m_WrapsX) && spansOverlap(area.m_Top, area.m_Bottom, otherArea.m_Top, otherArea.m_Bottom, m_MOIDLayer->h, m_WrapsY);
+	}
+}
@@ -0,0 +1,203 @@
+#ifndef _RTEMOIDLAYERTRACKER_
+#define _RTEMOIDLAYERTRACKER_
+
+#include "SceneMan.h"
+
+namespace RTE {
+
+	class MovableObject;
+
+	/// <summary>
+	/// Keeps track of which MOIDs each root MovableObject was given and where it was drawn on the MOID layer, so the layer can be brought up to date by only erasing and redrawing the objects that changed since the last update.
+	/// Objects keep their range of MOIDs for as long as they're around and their MOID footprint still fits in it, so objects coming and going don't change the MOIDs of everything after them in the MOID index.
+	/// Objects overlapping anything that was erased or redrawn are redrawn as well, in the same order a full redraw would draw them in, so the layer ends up the same as if it was drawn anew.
+	/// </summary>
+	class MOIDLayerTracker {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a MOIDLayerTracker object in system memory.
+		/// </summary>
+		MOIDLayerTracker() { Clear(); }
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a MOIDLayerTracker object before deletion from system memory.
+		/// </summary>
+		~MOIDLayerTracker() { Reset(); }
+
+		/// <summary>
+		/// Forgets all tracked objects and frees the validation layer, without touching the MOID layer.
+		/// </summary>
+		void Reset();
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Brings the MOID layer up to date with the current state of the root objects and fills the MOID index with them and their children.
+		/// Objects that are new, changed or no longer among the root objects are erased from where they were last drawn, and only they and whatever overlaps them are drawn anew.
+		/// </summary>
+		/// <param name="moidLayer">The MOID layer to update. If this isn't the layer of the last update, everything is drawn onto it anew. Ownership is NOT transferred!</param>
+		/// <param name="rootObjects">All the root objects that should be on the MOID layer, in the order they're drawn in. Ownership is NOT transferred!</param>
+		/// <param name="moidIndex">The MOID index to fill. MOIDs no object has are left null. Ownership is NOT transferred!</param>
+		/// <param name="objectsRedrawThemselves">Whether the root objects erase themselves from the layer before travelling and draw themselves again after, like they do with precise collisions. If so, unchanged objects that weren't drawn again where they were are drawn anew.</param>
+		void Update(BITMAP *moidLayer, const std::vector<MovableObject *> &rootObjects, std::vector<MovableObject *> &moidIndex, bool objectsRedrawThemselves);
+
+		/// <summary>
+		/// Erases an object from the MOID layer right away, e.g. because it's about to be deleted. It's drawn anew in the next update if it's still around by then.
+		/// </summary>
+		/// <param name="object">The root object to erase. Nothing happens if it isn't tracked. Ownership is NOT transferred!</param>
+		void EraseObject(const MovableObject *object);
+
+		/// <summary>
+		/// Erases all tracked objects from the MOID layer and forgets them, so the next update draws everything anew.
+		/// </summary>
+		void EraseAll();
+
+		/// <summary>
+		/// Compares the MOID layer against a full redraw of the root objects with their current MOIDs, and replaces it with the full redraw if they differ. Only meant for testing, as it's as slow as a full redraw.
+		/// </summary>
+		/// <param name="rootObjects">The same root objects as passed to the last update. Ownership is NOT transferred!</param>
+		/// <returns>The number of pixels of the MOID layer that differed from the full redraw.</returns>
+		int Validate(const std::vector<MovableObject *> &rootObjects);
+#pragma endregion
+
+	protected:
+
+		static constexpr int c_CellSize = 64; //!< The width and height of the cells the tracked drawings are sorted into to find overlapping ones, in pixels.
+		static constexpr size_t c_MinIndexSizeToCompact = 512; //!< How large the MOID index has to get before it's packed anew once removed objects leave more than half of it unused.
+
+		/// <summary>
+		/// What's known about a root object on the MOID layer.
+		/// </summary>
+		struct TrackedObject {
+			MovableObject *m_Object = nullptr; //!< The root object. Only looked at while it's among the root objects of the current update. Ownership is NOT transferred!
+			MOID m_FirstID = 0; //!< The first MOID of the object's range in the MOID index.
+			int m_IDCount = 0; //!< How many MOIDs the object's range takes up, including g_NoMOID if the range spans it. 0 until the object is given a range.
+			size_t m_DrawState = 0; //!< The combined MOID draw states of the object and its children, along with their MOIDs, as of the last update.
+			bool m_NeedsRedraw = true; //!< Whether the object has to be drawn anew because it's new, changed or was erased.
+			bool m_Restamped = false; //!< Whether the object was drawn onto the layer as it was, by someone else since the last update.
+			std::vector<IntRect> m_Drawings; //!< The areas of the MOID layer the object was last drawn to, as registered by its Draw.
+			int m_DrawOrder = 0; //!< The position of the object among the root objects of the current update. Objects later in the order are drawn over earlier ones.
+			unsigned int m_SeenUpdate = 0; //!< The last update the object was among the root objects of.
+			unsigned int m_GridUpdate = 0; //!< The last update the object's drawings were sorted into the grid cells in.
+			unsigned int m_ScheduledRound = 0; //!< The last redraw round the object was picked to be drawn in.
+			unsigned int m_DrawnRound = 0; //!< The last redraw round the object was drawn in.
+			unsigned int m_QueryStamp = 0; //!< The last overlap search the object was looked at in, so objects found in several cells are only looked at once.
+		};
+
+		BITMAP *m_MOIDLayer; //!< The MOID layer the tracked objects are drawn on. Ownership is NOT transferred!
+		bool m_WrapsX; //!< Whether the MOID layer wraps horizontally.
+		bool m_WrapsY; //!< Whether the MOID layer wraps vertically.
+
+		std::unordered_map<const MovableObject *, TrackedObject> m_TrackedObjects; //!< All tracked objects, by root object.
+		std::map<MOID, TrackedObject *> m_ObjectsByFirstID; //!< The tracked objects that have a range of MOIDs, by the first MOID of their range.
+		int m_TakenIDCount; //!< How many MOIDs are taken up by the ranges of the tracked objects.
+		std::vector<IntRect> m_ErasedAreas; //!< The areas of the MOID layer erased since the last update. Whatever overlaps them has to be drawn anew.
+
+		unsigned int m_UpdateCount; //!< How many updates were made, used to stamp the tracked objects.
+		unsigned int m_RoundCount; //!< How many redraw rounds were made, used to stamp the tracked objects.
+		unsigned int m_QueryCount; //!< How many overlap searches were made, used to stamp the tracked objects.
+
+		int m_CellCountX; //!< The number of grid cells horizontally.
+		int m_CellCountY; //!< The number of grid cells vertically.
+		std::vector<std::vector<TrackedObject *>> m_Cells; //!< The tracked objects with drawings in each grid cell, row by row. Filled anew each update.
+		std::vector<int> m_OccupiedCells; //!< The indices of the cells that have any objects in them, so they can be emptied without going through all of them.
+
+		std::vector<MovableObject *> m_ScratchIndex; //!< MOID index the footprints of new objects are measured with before they're given a range.
+		std::list<IntRect> m_TakenDrawings; //!< The drawings taken from SceneMan after drawing something.
+		std::vector<int> m_CellsOfArea; //!< The cells found for an area, kept around so it doesn't need to be allocated for every area.
+
+		BITMAP *m_ValidationLayer; //!< The layer full redraws are made on by Validate. Owned by this.
+
+	private:
+
+		/// <summary>
+		/// Gives the new objects a range of MOIDs each, in the first gap between the ranges of the other objects that's large enough, or at the end of the MOID index.
+		/// </summary>
+		/// <param name="newObjects">The new objects, in the order they should get their ranges in.</param>
+		void PlaceNewObjects(const std::vector<TrackedObject *> &newObjects);
+
+		/// <summary>
+		/// Updates the MOID range and draw state of a tracked object that was just registered in the MOID index, erasing it and marking it to be drawn anew if it changed.
+		/// </summary>
+		/// <param name="trackedObject">The tracked object.</param>
+		/// <param name="moidIndex">The MOID index the object's range ends at the end of.</param>
+		void UpdateDrawState(TrackedObject &trackedObject, const std::vector<MovableObject *> &moidIndex);
+
+		/// <summary>
+		/// Draws a tracked object onto the MOID layer and takes over the areas its Draw registered.
+		/// </summary>
+		/// <param name="trackedObject">The tracked object to draw.</param>
+		void DrawObject(TrackedObject &trackedObject);
+
+		/// <summary>
+		/// Clears the areas of the MOID layer a tracked object was last drawn to and notes them as erased.
+		/// </summary>
+		/// <param name="trackedObject">The tracked object to erase.</param>
+		void EraseDrawings(TrackedObject &trackedObject);
+
+		/// <summary>
+		/// Sorts the drawings of a tracked object into the grid cells they cover.
+		/// </summary>
+		/// <param name="trackedObject">The tracked object.</param>
+		void AddToGrid(TrackedObject &trackedObject);
+
+		/// <summary>
+		/// Finds the tracked object in the grid that was last drawn to exactly the specified area.
+		/// </summary>
+		/// <param name="area">The area to look for.</param>
+		/// <returns>The tracked object drawn to the area, or nullptr if there's none.</returns>
+		TrackedObject * FindObjectDrawnTo(const IntRect &area);
+
+		/// <summary>
+		/// Picks all tracked objects in the grid that have drawings overlapping an area to be drawn in a redraw round, if they're later in the draw order than specified and weren't already picked.
+		/// </summary>
+		/// <param name="area">The area to look for overlapping objects in.</param>
+		/// <param name="afterDrawOrder">Only objects later than this in the draw order are picked.</param>
+		/// <param name="skippedRound">Objects drawn in this redraw round aren't picked.</param>
+		/// <param name="scheduledRound">The redraw round to pick the objects for.</param>
+		/// <param name="pickedObjects">The vector to add the picked objects to.</param>
+		void PickOverlappingObjects(const IntRect &area, int afterDrawOrder, unsigned int skippedRound, unsigned int scheduledRound, std::vector<TrackedObject *> &pickedObjects);
+
+		/// <summary>
+		/// Finds the grid cells an area of the MOID layer covers, wrapping it if the layer wraps.
+		/// </summary>
+		/// <param name="area">The area. Can be unwrapped and out of bounds.</param>
+		/// <param name="cells">Filled with the indices of the covered cells.</param>
+		void GetCellsOfArea(const IntRect &area, std::vector<int> &cells) const;
+
+		/// <summary>
+		/// Splits an unwrapped range of pixels along one axis into the at most two ranges of grid cells it covers.
+		/// </summary>
+		/// <param name="first">The first pixel of the range.</param>
+		/// <param name="last">The last pixel of the range.</param>
+		/// <param name="size">The size of the MOID layer along the axis.</param>
+		/// <param name="wraps">Whether the MOID layer wraps along the axis.</param>
+		/// <param name="cellSpans">Filled with the first and last cells of each range.</param>
+		/// <returns>The number of ranges of cells, 0 to 2.</returns>
+		int GetCellSpans(int first, int last, int size, bool wraps, int cellSpans[2][2]) const;
+
+		/// <summary>
+		/// Gets whether two areas of the MOID layer overlap, also across the wrapping seams if the layer wraps.
+		/// </summary>
+		/// <param name="area">The first area. Can be unwrapped and out of bounds.</param>
+		/// <param name="otherArea">The second area. Can be unwrapped and out of bounds.</param>
+		/// <returns>Whether the areas overlap.</returns>
+		bool AreasOverlap(const IntRect &area, const IntRect &otherArea) const;
+
+		/// <summary>
+		/// Forgets all tracked objects without touching the MOID layer.
+		/// </summary>
+		void ForgetTrackedObjects();
+
+		/// <summary>
+		/// Clears all the member variables of this MOIDLayerTracker, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
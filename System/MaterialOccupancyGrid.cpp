@@ -0,0 +1,166 @@
+#include "MaterialOccupancyGrid.h"
+#include "SceneMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MaterialOccupancyGrid::Clear() {
+		m_Width = 0;
+		m_Height = 0;
+		m_WrapsX = false;
+		m_WrapsY = false;
+		m_FineTileCountX = 0;
+		m_FineTileCountY = 0;
+		m_FineTiles.clear();
+		m_CoarseTileCountX = 0;
+		m_CoarseTileCountY = 0;
+		m_CoarseTiles.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int MaterialOccupancyGrid::Create(const BITMAP *materialBitmap, bool wrapsX, bool wrapsY) {
+		if (!materialBitmap || materialBitmap->w <= 0 || materialBitmap->h <= 0) {
+			return -1;
+		}
+		Clear();
+		m_Width = materialBitmap->w;
+		m_Height = materialBitmap->h;
+		m_WrapsX = wrapsX;
+		m_WrapsY = wrapsY;
+		m_FineTileCountX = (m_Width + c_FineTileSize - 1) / c_FineTileSize;
+		m_FineTileCountY = (m_Height + c_FineTileSize - 1) / c_FineTileSize;
+		m_FineTiles.resize(m_FineTileCountX * m_FineTileCountY, MixedTile);
+		m_CoarseTileCountX = (m_Width + c_CoarseTileSize - 1) / c_CoarseTileSize;
+		m_CoarseTileCountY = (m_Height + c_CoarseTileSize - 1) / c_CoarseTileSize;
+		m_CoarseTiles.resize(m_CoarseTileCountX * m_CoarseTileCountY, MixedTile);
+
+		for (int tileY = 0; tileY < m_FineTileCountY; ++tileY) {
+			for (int tileX = 0; tileX < m_FineTileCountX; ++tileX) {
+				SummarizeFineTile(materialBitmap, tileX, tileY);
+			}
+		}
+		for (int tileY = 0; tileY < m_CoarseTileCountY; ++tileY) {
+			for (int tileX = 0; tileX < m_CoarseTileCountX; ++tileX) {
+				SummarizeCoarseTile(tileX, tileY);
+			}
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MaterialOccupancyGrid::UpdatePixel(int posX, int posY, unsigned char material) {
+		if (posX < 0 || posX >= m_Width || posY < 0 || posY >= m_Height) {
+			return;
+		}
+		TileState pixelState = (material == g_MaterialAir) ? AirTile : SolidTile;
+
+		TileState &fineTile = m_FineTiles[(posY / c_FineTileSize) * m_FineTileCountX + (posX / c_FineTileSize)];
+		if (fineTile != pixelState) { fineTile = MixedTile; }
+		TileState &coarseTile = m_CoarseTiles[(posY / c_CoarseTileSize) * m_CoarseTileCountX + (posX / c_CoarseTileSize)];
+		if (coarseTile != pixelState) { coarseTile = MixedTile; }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MaterialOccupancyGrid::UpdateArea(const BITMAP *materialBitmap, int left, int top, int width, int height) {
+		if (!materialBitmap || !Covers(materialBitmap->w, materialBitmap->h) || width <= 0 || height <= 0) {
+			return;
+		}
+		int spansX[2][2];
+		int spansY[2][2];
+		int spanCountX = GetWrappedSpans(left, left + width - 1, m_Width, m_WrapsX, spansX);
+		int spanCountY = GetWrappedSpans(top, top + height - 1, m_Height, m_WrapsY, spansY);
+
+		for (int spanY = 0; spanY < spanCountY; ++spanY) {
+			for (int spanX = 0; spanX < spanCountX; ++spanX) {
+				for (int tileY = spansY[spanY][0] / c_FineTileSize; tileY <= spansY[spanY][1] / c_FineTileSize; ++tileY) {
+					for (int tileX = spansX[spanX][0] / c_FineTileSize; tileX <= spansX[spanX][1] / c_FineTileSize; ++tileX) {
+						SummarizeFineTile(materialBitmap, tileX, tileY);
+					}
+				}
+				for (int tileY = spansY[spanY][0] / c_CoarseTileSize; tileY <= spansY[spanY][1] / c_CoarseTileSize; ++tileY) {
+					for (int tileX = spansX[spanX][0] / c_CoarseTileSize; tileX <= spansX[spanX][1] / c_CoarseTileSize; ++tileX) {
+						SummarizeCoarseTile(tileX, tileY);
+					}
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MaterialOccupancyGrid::SummarizeFineTile(const BITMAP *materialBitmap, int tileX, int tileY) {
+		int left = tileX * c_FineTileSize;
+		int top = tileY * c_FineTileSize;
+		int right = std::min(left + c_FineTileSize, m_Width);
+		int bottom = std::min(top + c_FineTileSize, m_Height);
+
+		bool foundAir = false;
+		bool foundMaterial = false;
+		for (int posY = top; posY < bottom && !(foundAir && foundMaterial); ++posY) {
+			const unsigned char *materialRow = materialBitmap->line[posY];
+			for (int posX = left; posX < right; ++posX) {
+				if (materialRow[posX] == g_MaterialAir) {
+					foundAir = true;
+				} else {
+					foundMaterial = true;
+				}
+			}
+		}
+		m_FineTiles[tileY * m_FineTileCountX + tileX] = foundMaterial ? (foundAir ? MixedTile : SolidTile) : AirTile;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void MaterialOccupancyGrid::SummarizeCoarseTile(int tileX, int tileY) {
+		const int fineTilesPerCoarseTile = c_CoarseTileSize / c_FineTileSize;
+		int firstFineTileX = tileX * fineTilesPerCoarseTile;
+		int firstFineTileY = tileY * fineTilesPerCoarseTile;
+		int lastFineTileX = std::min(firstFineTileX + fineTilesPerCoarseTile, m_FineTileCountX) - 1;
+		int lastFineTileY = std::min(firstFineTileY + fineTilesPerCoarseTile, m_FineTileCountY) - 1;
+
+		TileState coarseState = m_FineTiles[firstFineTileY * m_FineTileCountX + firstFineTileX];
+		for (int fineTileY = firstFineTileY; fineTileY <= lastFineTileY && coarseState != MixedTile; ++fineTileY) {
+			for (int fineTileX = firstFineTileX; fineTileX <= lastFineTileX; ++fineTileX) {
+				if (m_FineTiles[fineTileY * m_FineTileCountX + fineTileX] != coarseState) {
+					coarseState = MixedTile;
+					break;
+				}
+			}
+		}
+		m_CoarseTiles[tileY * m_CoarseTileCountX + tileX] = coarseState;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int MaterialOccupancyGrid::GetWrappedSpans(int first, int last, int size, bool wraps, int spans[2][2]) const {
+		if (!wraps) {
+			first = std::max(first, 0);
+			last = std::min(last, size - 1);
+			if (first > last) {
+				return 0;
+			}
+			spans[0][0] = first;
+			spans[0][1] = last;
+			return 1;
+		}
+		if (last - first + 1 >= size) {
+			spans[0][0] = 0;
+			spans[0][1] = size - 1;
+			return 1;
+		}
+		int wrappedFirst = ((first % size) + size) % size;
+		int wrappedLast = wrappedFirst + (last - first);
+		spans[0][0] = wrappedFirst;
+		spans[0][1] = std::min(wrappedLast, size - 1);
+		if (wrappedLast < size) {
+			return 1;
+		}
+		spans[1][0] = 0;
+		spans[1][1] = wrappedLast - size;
+		return 2;
+	}
+}
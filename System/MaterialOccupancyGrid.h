@@ -0,0 +1,156 @@
+#ifndef _RTEMATERIALOCCUPANCYGRID_
+#define _RTEMATERIALOCCUPANCYGRID_
+
+struct BITMAP;
+
+namespace RTE {
+
+	/// <summary>
+	/// A coarse two level summary of a terrain material bitmap, telling for each 16x16 and 64x64 pixel tile whether it's all air, all material or a mix of both.
+	/// Lets anything stepping through the terrain pixel by pixel, like ray casts, jump over whole tiles of open air at once.
+	/// Air tiles are always exact. Tiles that had single pixels changed are only marked as mixed until their area is updated, so a tile may be mixed when it's actually all air or all material.
+	/// </summary>
+	class MaterialOccupancyGrid {
+
+	public:
+
+		/// <summary>
+		/// What a tile of the material bitmap holds.
+		/// </summary>
+		enum TileState : unsigned char { AirTile = 0, SolidTile, MixedTile };
+
+		static constexpr int c_FineTileSize = 16; //!< The width and height of the fine tiles, in pixels.
+		static constexpr int c_CoarseTileSize = 64; //!< The width and height of the coarse tiles, in pixels. Each covers 4x4 fine tiles.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a MaterialOccupancyGrid object in system memory. Create() should be called before using the object.
+		/// </summary>
+		MaterialOccupancyGrid() { Clear(); }
+
+		/// <summary>
+		/// Makes the MaterialOccupancyGrid object ready for use, summarizing the whole of a material bitmap.
+		/// </summary>
+		/// <param name="materialBitmap">The 8 bit material bitmap to summarize. Ownership is NOT transferred!</param>
+		/// <param name="wrapsX">Whether the material bitmap wraps horizontally.</param>
+		/// <param name="wrapsY">Whether the material bitmap wraps vertically.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int Create(const BITMAP *materialBitmap, bool wrapsX, bool wrapsY);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Removes all tiles, so the grid doesn't cover any bitmap until it's created again.
+		/// </summary>
+		void Reset() { Clear(); }
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets whether this grid was made for a bitmap of the specified size, so its tiles can be used for it.
+		/// </summary>
+		/// <param name="width">The width of the bitmap, in pixels.</param>
+		/// <param name="height">The height of the bitmap, in pixels.</param>
+		/// <returns>Whether this grid covers a bitmap of that size.</returns>
+		bool Covers(int width, int height) const { return m_Width > 0 && m_Width == width && m_Height == height; }
+
+		/// <summary>
+		/// Gets the state of the fine tile a pixel is in.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel. Must be within the covered bitmap.</param>
+		/// <param name="posY">The Y position of the pixel. Must be within the covered bitmap.</param>
+		/// <returns>The TileState of the fine tile the pixel is in.</returns>
+		TileState GetFineTileState(int posX, int posY) const { return m_FineTiles[(posY / c_FineTileSize) * m_FineTileCountX + (posX / c_FineTileSize)]; }
+
+		/// <summary>
+		/// Gets the state of the coarse tile a pixel is in.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel. Must be within the covered bitmap.</param>
+		/// <param name="posY">The Y position of the pixel. Must be within the covered bitmap.</param>
+		/// <returns>The TileState of the coarse tile the pixel is in.</returns>
+		TileState GetCoarseTileState(int posX, int posY) const { return m_CoarseTiles[(posY / c_CoarseTileSize) * m_CoarseTileCountX + (posX / c_CoarseTileSize)]; }
+
+		/// <summary>
+		/// Gets the size of the largest all air tile a pixel is in.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel. Must be within the covered bitmap.</param>
+		/// <param name="posY">The Y position of the pixel. Must be within the covered bitmap.</param>
+		/// <returns>The width and height of the largest all air tile the pixel is in, or 0 if neither of its tiles are all air.</returns>
+		int GetAirTileSize(int posX, int posY) const {
+			if (GetCoarseTileState(posX, posY) == AirTile) {
+				return c_CoarseTileSize;
+			}
+			return (GetFineTileState(posX, posY) == AirTile) ? c_FineTileSize : 0;
+		}
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Notes that a single pixel of the material bitmap was set to a material. The tiles it's in are marked as mixed if they no longer hold only that kind of pixel.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel. Pixels outside the covered bitmap are ignored.</param>
+		/// <param name="posY">The Y position of the pixel. Pixels outside the covered bitmap are ignored.</param>
+		/// <param name="material">The material the pixel was set to.</param>
+		void UpdatePixel(int posX, int posY, unsigned char material);
+
+		/// <summary>
+		/// Summarizes all tiles touching an area of the material bitmap anew.
+		/// </summary>
+		/// <param name="materialBitmap">The material bitmap the grid was created for. Ownership is NOT transferred!</param>
+		/// <param name="left">The left edge of the area. Can be unwrapped and out of bounds.</param>
+		/// <param name="top">The top edge of the area. Can be unwrapped and out of bounds.</param>
+		/// <param name="width">The width of the area, in pixels.</param>
+		/// <param name="height">The height of the area, in pixels.</param>
+		void UpdateArea(const BITMAP *materialBitmap, int left, int top, int width, int height);
+#pragma endregion
+
+	protected:
+
+		int m_Width; //!< The width of the covered bitmap, in pixels.
+		int m_Height; //!< The height of the covered bitmap, in pixels.
+		bool m_WrapsX; //!< Whether the covered bitmap wraps horizontally.
+		bool m_WrapsY; //!< Whether the covered bitmap wraps vertically.
+
+		int m_FineTileCountX; //!< The number of fine tiles horizontally.
+		int m_FineTileCountY; //!< The number of fine tiles vertically.
+		std::vector<TileState> m_FineTiles; //!< The states of the fine tiles, row by row. Tiles at the right and bottom edges only cover the part of them that's within the bitmap.
+
+		int m_CoarseTileCountX; //!< The number of coarse tiles horizontally.
+		int m_CoarseTileCountY; //!< The number of coarse tiles vertically.
+		std::vector<TileState> m_CoarseTiles; //!< The states of the coarse tiles, row by row, as summed up from the fine tiles they cover.
+
+	private:
+
+		/// <summary>
+		/// Looks through the pixels of a fine tile and updates its state.
+		/// </summary>
+		/// <param name="materialBitmap">The material bitmap the grid was created for. Ownership is NOT transferred!</param>
+		/// <param name="tileX">The column of the fine tile.</param>
+		/// <param name="tileY">The row of the fine tile.</param>
+		void SummarizeFineTile(const BITMAP *materialBitmap, int tileX, int tileY);
+
+		/// <summary>
+		/// Updates the state of a coarse tile from the fine tiles it covers.
+		/// </summary>
+		/// <param name="tileX">The column of the coarse tile.</param>
+		/// <param name="tileY">The row of the coarse tile.</param>
+		void SummarizeCoarseTile(int tileX, int tileY);
+
+		/// <summary>
+		/// Splits an unwrapped range of pixels along one axis into the at most two ranges it covers within the bitmap.
+		/// </summary>
+		/// <param name="first">The first pixel of the range.</param>
+		/// <param name="last">The last pixel of the range.</param>
+		/// <param name="size">The size of the bitmap along the axis.</param>
+		/// <param name="wraps">Whether the bitmap wraps along the axis.</param>
+		/// <param name="spans">Filled with the first and last pixels of each range within the bitmap.</param>
+		/// <returns>The number of ranges within the bitmap, 0 to 2.</returns>
+		int GetWrappedSpans(int first, int last, int size, bool wraps, int spans[2][2]) const;
+
+		/// <summary>
+		/// Clears all the member variables of this MaterialOccupancyGrid, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
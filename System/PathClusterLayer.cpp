@@ -0,0 +1,294 @@
+#include "PathClusterLayer.h"
+#include "ThreadMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathClusterLayer::PathClusterLayer(const PathFinder *pathFinder, int team, float digStrength) {
+		m_PathFinder = pathFinder;
+		m_Team = team;
+		m_DigStrength = digStrength;
+		m_ChangeStamp = 0;
+		m_NodeXCount = 0;
+		m_NodeYCount = 0;
+		m_ClusterXCount = 0;
+		m_ClusterYCount = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterLayer::Create(const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const PathClusterLayer *previousLayer, const std::vector<unsigned int> &clusterChangeStamps, unsigned int changeStamp) {
+		m_CostSnapshot = costSnapshot;
+		m_ChangeStamp = changeStamp;
+		m_NodeXCount = m_PathFinder->m_NodeXCount;
+		m_NodeYCount = m_PathFinder->m_NodeYCount;
+		m_ClusterXCount = m_PathFinder->m_ClusterXCount;
+		m_ClusterYCount = m_PathFinder->m_ClusterYCount;
+
+		int clusterCount = m_ClusterXCount * m_ClusterYCount;
+		m_Portals.clear();
+		m_ClusterPortals.assign(clusterCount, std::vector<int>());
+
+		// Where the borders can be crossed depends on the costs, so the portals are all found anew every time. That's cheap compared to finding the paths between them
+		std::vector<PathNode *> crossings;
+		int borderXCount = (m_ClusterXCount > 1 && g_SceneMan.SceneWrapsX()) ? m_ClusterXCount : m_ClusterXCount - 1;
+		for (int borderX = 0; borderX < borderXCount; ++borderX) {
+			int nodeX = std::min((borderX + 1) * c_ClusterNodeSize, m_NodeXCount) - 1;
+			for (int clusterY = 0; clusterY < m_ClusterYCount; ++clusterY) {
+				crossings.clear();
+				for (int nodeY = clusterY * c_ClusterNodeSize; nodeY < std::min((clusterY + 1) * c_ClusterNodeSize, m_NodeYCount); ++nodeY) {
+					PathNode *node = m_PathFinder->GetNode(nodeX, nodeY);
+					if (node->Right) { crossings.push_back(node); }
+				}
+				AddBorderEntrances(crossings, 1);
+			}
+		}
+		int borderYCount = (m_ClusterYCount > 1 && g_SceneMan.SceneWrapsY()) ? m_ClusterYCount : m_ClusterYCount - 1;
+		for (int borderY = 0; borderY < borderYCount; ++borderY) {
+			int nodeY = std::min((borderY + 1) * c_ClusterNodeSize, m_NodeYCount) - 1;
+			for (int clusterX = 0; clusterX < m_ClusterXCount; ++clusterX) {
+				crossings.clear();
+				for (int nodeX = clusterX * c_ClusterNodeSize; nodeX < std::min((clusterX + 1) * c_ClusterNodeSize, m_NodeXCount); ++nodeX) {
+					PathNode *node = m_PathFinder->GetNode(nodeX, nodeY);
+					if (node->Down) { crossings.push_back(node); }
+				}
+				AddBorderEntrances(crossings, 2);
+			}
+		}
+
+		// Reuse the paths of every cluster whose costs haven't changed and whose portals are still in the same places
+		m_ClusterPaths.assign(clusterCount, nullptr);
+		std::vector<int> clustersToSolve;
+		for (int cluster = 0; cluster < clusterCount; ++cluster) {
+			bool canReuse = previousLayer && clusterChangeStamps[cluster] <= previousLayer->m_ChangeStamp && m_ClusterPortals[cluster].size() == previousLayer->m_ClusterPortals[cluster].size();
+			for (size_t clusterPortal = 0; canReuse && clusterPortal < m_ClusterPortals[cluster].size(); ++clusterPortal) {
+				canReuse = m_Portals[m_ClusterPortals[cluster][clusterPortal]].LocalNode == previousLayer->m_Portals[previousLayer->m_ClusterPortals[cluster][clusterPortal]].LocalNode;
+			}
+			if (canReuse) {
+				m_ClusterPaths[cluster] = previousLayer->m_ClusterPaths[cluster];
+			} else {
+				clustersToSolve.push_back(cluster);
+			}
+		}
+		g_ThreadMan.ParallelFor(clustersToSolve.size(), [this, &clustersToSolve](size_t index) {
+			int cluster = clustersToSolve[index];
+			std::shared_ptr<PathClusterPaths> clusterPaths = std::make_shared<PathClusterPaths>();
+			clusterPaths->Costs.resize(m_ClusterPortals[cluster].size() * c_ClusterNodeCount);
+			clusterPaths->Parents.resize(m_ClusterPortals[cluster].size() * c_ClusterNodeCount);
+			for (size_t clusterPortal = 0; clusterPortal < m_ClusterPortals[cluster].size(); ++clusterPortal) {
+				SolveWithinCluster(m_Portals[m_ClusterPortals[cluster][clusterPortal]].Node, &clusterPaths->Costs[clusterPortal * c_ClusterNodeCount], &clusterPaths->Parents[clusterPortal * c_ClusterNodeCount]);
+			}
+			m_ClusterPaths[cluster] = clusterPaths;
+		});
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathNode * PathClusterLayer::GetClusterNode(int cluster, int localNode) const {
+		int nodeX = (cluster / m_ClusterYCount) * c_ClusterNodeSize + localNode / c_ClusterNodeSize;
+		int nodeY = (cluster % m_ClusterYCount) * c_ClusterNodeSize + localNode % c_ClusterNodeSize;
+		return (nodeX < m_NodeXCount && nodeY < m_NodeYCount) ? m_PathFinder->GetNode(nodeX, nodeY) : nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterLayer::SolveWithinCluster(const PathNode *sourceNode, float *costs, unsigned char *parents) const {
+		int cluster = GetNodeCluster(sourceNode);
+		int sourceLocalNode = GetLocalNode(sourceNode);
+		std::fill(costs, costs + c_ClusterNodeCount, FLT_MAX);
+		std::fill(parents, parents + c_ClusterNodeCount, c_NoParent);
+		costs[sourceLocalNode] = 0;
+
+		// Plain Dijkstra, since all paths out of the source are wanted and clusters are small
+		typedef std::pair<float, int> OpenNode;
+		std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> openNodes;
+		openNodes.emplace(0.0F, sourceLocalNode);
+		while (!openNodes.empty()) {
+			OpenNode openNode = openNodes.top();
+			openNodes.pop();
+			if (openNode.first > costs[openNode.second]) {
+				continue;
+			}
+			const PathNode *node = GetClusterNode(cluster, openNode.second);
+			for (int edge = 0; edge < PathFinder::c_NodeEdgeCount; ++edge) {
+				const PathNode *adjacentNode = node->GetAdjacentNode(edge);
+				if (!adjacentNode || GetNodeCluster(adjacentNode) != cluster) {
+					continue;
+				}
+				int adjacentLocalNode = GetLocalNode(adjacentNode);
+				float cost = openNode.first + GetEdgeCost(node, edge);
+				if (cost < costs[adjacentLocalNode]) {
+					costs[adjacentLocalNode] = cost;
+					parents[adjacentLocalNode] = static_cast<unsigned char>(openNode.second);
+					openNodes.emplace(cost, adjacentLocalNode);
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterLayer::AddBorderEntrances(const std::vector<PathNode *> &crossings, int edge) {
+		// Stretches at least this long get an entrance at both ends, so paths hugging either side don't have to detour through the middle
+		const int longStretchLength = 6;
+		int oppositeEdge = (edge + 2) % 4;
+
+		int stretchStart = -1;
+		int cheapestCrossing = -1;
+		float cheapestStrength = FLT_MAX;
+		bool anyOpenCrossing = false;
+		for (int crossing = 0; crossing <= static_cast<int>(crossings.size()); ++crossing) {
+			bool isOpen = false;
+			if (crossing < static_cast<int>(crossings.size())) {
+				float strength = std::max(GetEdgeStrength(crossings[crossing], edge), GetEdgeStrength(crossings[crossing]->GetAdjacentNode(edge), oppositeEdge));
+				isOpen = strength <= m_DigStrength;
+				if (strength < cheapestStrength) {
+					cheapestStrength = strength;
+					cheapestCrossing = crossing;
+				}
+			}
+			if (isOpen && stretchStart < 0) {
+				stretchStart = crossing;
+			} else if (!isOpen && stretchStart >= 0) {
+				int stretchLength = crossing - stretchStart;
+				if (stretchLength >= longStretchLength) {
+					AddEntrance(crossings[stretchStart], edge);
+					AddEntrance(crossings[crossing - 1], edge);
+				} else {
+					AddEntrance(crossings[stretchStart + (stretchLength - 1) / 2], edge);
+				}
+				stretchStart = -1;
+				anyOpenCrossing = true;
+			}
+		}
+		// The node grid itself is fully connected, so the clusters are kept connected too, even if it takes digging
+		if (!anyOpenCrossing && cheapestCrossing >= 0) { AddEntrance(crossings[cheapestCrossing], edge); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterLayer::AddEntrance(PathNode *node, int edge) {
+		PathNode *otherNode = node->GetAdjacentNode(edge);
+		int portalIndex = m_Portals.size();
+
+		PathPortal portal;
+		portal.Node = node;
+		portal.Cluster = GetNodeCluster(node);
+		portal.LocalNode = GetLocalNode(node);
+		portal.ClusterPortal = m_ClusterPortals[portal.Cluster].size();
+		portal.Partner = portalIndex + 1;
+		portal.CrossingCost = GetEdgeCost(node, edge);
+		m_ClusterPortals[portal.Cluster].push_back(portalIndex);
+		m_Portals.push_back(portal);
+
+		PathPortal otherPortal;
+		otherPortal.Node = otherNode;
+		otherPortal.Cluster = GetNodeCluster(otherNode);
+		otherPortal.LocalNode = GetLocalNode(otherNode);
+		otherPortal.ClusterPortal = m_ClusterPortals[otherPortal.Cluster].size();
+		otherPortal.Partner = portalIndex;
+		otherPortal.CrossingCost = GetEdgeCost(otherNode, (edge + 2) % 4);
+		m_ClusterPortals[otherPortal.Cluster].push_back(portalIndex + 1);
+		m_Portals.push_back(otherPortal);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathClusterLayer::GetEdgeCost(const PathNode *node, int edge) const {
+		return PathFinder::GetAdjacentCost(edge, GetEdgeStrength(node, edge), m_DigStrength);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathClusterSearch::PathClusterSearch() {
+		// The edges out of the start and into the end are different for every search, so caching paths between searches would give wrong results
+		m_Pather = new MicroPather(this, 500, 8, false);
+		m_ClusterLayer = nullptr;
+		m_StartPortal = { nullptr, 0, 0, -1, -1, 0 };
+		m_EndPortal = { nullptr, 0, 0, -1, -1, 0 };
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int PathClusterSearch::Solve(const PathClusterLayer &clusterLayer, PathNode *startNode, PathNode *endNode, std::vector<void *> &statePath, float &totalCost) {
+		m_ClusterLayer = &clusterLayer;
+		m_StartPortal = { startNode, clusterLayer.GetNodeCluster(startNode), clusterLayer.GetLocalNode(startNode), -1, -1, 0 };
+		m_EndPortal = { endNode, clusterLayer.GetNodeCluster(endNode), clusterLayer.GetLocalNode(endNode), -1, -1, 0 };
+		clusterLayer.SolveWithinCluster(startNode, m_StartCosts, m_StartParents);
+
+		// Everything the pather knows about the portals may be from a different layer or search
+		m_Pather->Reset();
+		std::vector<void *> portalPath;
+		int result = m_Pather->Solve(static_cast<void *>(&m_StartPortal), static_cast<void *>(&m_EndPortal), &portalPath, &totalCost);
+
+		statePath.clear();
+		if (result == MicroPather::SOLVED) {
+			statePath.push_back(static_cast<void *>(startNode));
+			const std::vector<PathPortal> &portals = clusterLayer.GetPortals();
+			for (size_t i = 1; i < portalPath.size(); ++i) {
+				const PathPortal *fromPortal = static_cast<PathPortal *>(portalPath[i - 1]);
+				const PathPortal *toPortal = static_cast<PathPortal *>(portalPath[i]);
+				if (fromPortal->Partner >= 0 && toPortal == &portals[fromPortal->Partner]) {
+					statePath.push_back(static_cast<void *>(toPortal->Node));
+				} else {
+					AddClusterPath(fromPortal, toPortal, statePath);
+				}
+			}
+		}
+		m_ClusterLayer = nullptr;
+		return result;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathClusterSearch::LeastCostEstimate(void *startState, void *endState) {
+		return g_SceneMan.ShortestDistance((static_cast<PathPortal *>(startState))->Node->Pos, (static_cast<PathPortal *>(endState))->Node->Pos).GetMagnitude();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterSearch::AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList) {
+		const PathPortal *portal = static_cast<PathPortal *>(state);
+		const std::vector<PathPortal> &portals = m_ClusterLayer->GetPortals();
+		micropather::StateCost adjCost;
+
+		/// <summary>
+		/// Internal lambda function to add a portal to the adjacent list, unless it can't be reached at all.
+		/// </summary>
+		auto addAdjacentPortal = [&adjCost, &adjacentList](const PathPortal *adjacentPortal, float cost) {
+			if (cost < FLT_MAX) {
+				adjCost.cost = cost;
+				adjCost.state = static_cast<void *>(const_cast<PathPortal *>(adjacentPortal));
+				adjacentList->push_back(adjCost);
+			}
+		};
+
+		if (portal == &m_StartPortal) {
+			for (int clusterPortal : m_ClusterLayer->GetClusterPortals(portal->Cluster)) {
+				addAdjacentPortal(&portals[clusterPortal], m_StartCosts[portals[clusterPortal].LocalNode]);
+			}
+			return;
+		}
+		addAdjacentPortal(&portals[portal->Partner], portal->CrossingCost);
+
+		const float *clusterCosts = &m_ClusterLayer->GetClusterPaths(portal->Cluster).Costs[portal->ClusterPortal * PathClusterLayer::c_ClusterNodeCount];
+		for (int clusterPortal : m_ClusterLayer->GetClusterPortals(portal->Cluster)) {
+			if (&portals[clusterPortal] != portal) { addAdjacentPortal(&portals[clusterPortal], clusterCosts[portals[clusterPortal].LocalNode]); }
+		}
+		if (portal->Cluster == m_EndPortal.Cluster) { addAdjacentPortal(&m_EndPortal, clusterCosts[m_EndPortal.LocalNode]); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathClusterSearch::AddClusterPath(const PathPortal *fromPortal, const PathPortal *toPortal, std::vector<void *> &statePath) const {
+		const unsigned char *parents = (fromPortal == &m_StartPortal) ? m_StartParents : &m_ClusterLayer->GetClusterPaths(fromPortal->Cluster).Parents[fromPortal->ClusterPortal * PathClusterLayer::c_ClusterNodeCount];
+
+		// Follow the parents back from where the path ends, then turn the added nodes around
+		size_t firstAddedNode = statePath.size();
+		for (int localNode = toPortal->LocalNode; localNode != fromPortal->LocalNode && localNode != PathClusterLayer::c_NoParent; localNode = parents[localNode]) {
+			statePath.push_back(static_cast<void *>(m_ClusterLayer->GetClusterNode(toPortal->Cluster, localNode)));
+		}
+		std::reverse(statePath.begin() + firstAddedNode, statePath.end());
+	}
+}
@@ -0,0 +1,279 @@
+#ifndef _RTEPATHCLUSTERLAYER_
+#define _RTEPATHCLUSTERLAYER_
+
+#include "PathFinder.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// One end of an entrance between two adjacent clusters of a PathClusterLayer. Each entrance has a portal on either side of the border, which are each other's partners.
+	/// </summary>
+	struct PathPortal {
+
+		PathNode *Node; //!< The node on this side of the border that the portal sits on. Not owned.
+		int Cluster; //!< The index of the cluster the node is in.
+		int LocalNode; //!< The index of the node within its cluster.
+		int ClusterPortal; //!< The index of this portal among the portals of its cluster.
+		int Partner; //!< The index of the portal on the other side of the border, in the layer's list of portals.
+		float CrossingCost; //!< The cost of going from this portal's node to the partner's node.
+	};
+
+	/// <summary>
+	/// The least costly paths from each portal of a cluster to every node of the same cluster, found without leaving the cluster.
+	/// </summary>
+	struct PathClusterPaths {
+
+		std::vector<float> Costs; //!< The cost from each portal to each node of the cluster, indexed by portal times the cluster node count plus local node.
+		std::vector<unsigned char> Parents; //!< The local node each node is reached from on the least costly path from each portal, indexed like Costs. c_NoParent for the portal's own node and unreachable nodes.
+	};
+
+	/// <summary>
+	/// An abstract graph over the node grid of a PathFinder, for paths of a specific team and dig strength.
+	/// The node grid is split into square clusters, the borders between them get portals wherever they can be crossed, and the paths between the portals of each cluster are found up front.
+	/// Long paths can then be searched for over the portals alone, and turned back into nodes by following the paths within each cluster.
+	/// Once made, a layer is never changed. Newer layers are made from older ones, reusing the paths of all clusters that haven't changed.
+	/// </summary>
+	class PathClusterLayer {
+
+	public:
+
+		static constexpr int c_ClusterNodeSize = PathFinder::c_ClusterNodeSize; //!< The width and height of each cluster, in nodes.
+		static constexpr int c_ClusterNodeCount = c_ClusterNodeSize * c_ClusterNodeSize; //!< The number of nodes in each full cluster.
+		static constexpr unsigned char c_NoParent = 0xFF; //!< The parent of nodes that aren't reached from any other node in the cluster.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a PathClusterLayer object. Create() should be called before using the object.
+		/// </summary>
+		/// <param name="pathFinder">The PathFinder whose node grid this goes over. Ownership is NOT transferred!</param>
+		/// <param name="team">The team whose door cost overlay the costs are taken from, or NOTEAM for none.</param>
+		/// <param name="digStrength">What material strength the paths are capable of digging through.</param>
+		PathClusterLayer(const PathFinder *pathFinder, int team, float digStrength);
+
+		/// <summary>
+		/// Finds all the portals and the paths between them with the costs of a snapshot.
+		/// </summary>
+		/// <param name="costSnapshot">The costs to find the portals and paths with.</param>
+		/// <param name="previousLayer">An older layer for the same team and dig strength whose paths can be reused for clusters that haven't changed since, or nullptr if there is none.</param>
+		/// <param name="clusterChangeStamps">The change stamp of the last time any node costs in each cluster changed.</param>
+		/// <param name="changeStamp">The current change stamp, which this layer is up to date with.</param>
+		void Create(const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const PathClusterLayer *previousLayer, const std::vector<unsigned int> &clusterChangeStamps, unsigned int changeStamp);
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets the team this layer is for.
+		/// </summary>
+		/// <returns>The team whose door cost overlay the costs are taken from, or NOTEAM.</returns>
+		int GetTeam() const { return m_Team; }
+
+		/// <summary>
+		/// Gets the dig strength this layer is for.
+		/// </summary>
+		/// <returns>What material strength the paths are capable of digging through.</returns>
+		float GetDigStrength() const { return m_DigStrength; }
+
+		/// <summary>
+		/// Gets the snapshot of costs this layer was made with.
+		/// </summary>
+		/// <returns>The snapshot this layer was made with.</returns>
+		const std::shared_ptr<const PathCostSnapshot> & GetCostSnapshot() const { return m_CostSnapshot; }
+
+		/// <summary>
+		/// Gets the change stamp this layer is up to date with.
+		/// </summary>
+		/// <returns>The change stamp this layer is up to date with.</returns>
+		unsigned int GetChangeStamp() const { return m_ChangeStamp; }
+
+		/// <summary>
+		/// Gets the index of the cluster a node is in.
+		/// </summary>
+		/// <param name="node">The node to get the cluster of.</param>
+		/// <returns>The index of the cluster.</returns>
+		int GetNodeCluster(const PathNode *node) const { return m_PathFinder->GetNodeCluster(node); }
+
+		/// <summary>
+		/// Gets the index of a node within its cluster.
+		/// </summary>
+		/// <param name="node">The node to get the local index of.</param>
+		/// <returns>The index of the node within its cluster.</returns>
+		int GetLocalNode(const PathNode *node) const { return (static_cast<int>(node->Index / m_NodeYCount) % c_ClusterNodeSize) * c_ClusterNodeSize + static_cast<int>(node->Index % m_NodeYCount) % c_ClusterNodeSize; }
+
+		/// <summary>
+		/// Gets the node at a local index within a cluster.
+		/// </summary>
+		/// <param name="cluster">The index of the cluster.</param>
+		/// <param name="localNode">The index of the node within the cluster.</param>
+		/// <returns>The node, or nullptr if the cluster is cut short by the edge of the node grid there. Ownership is NOT transferred!</returns>
+		PathNode * GetClusterNode(int cluster, int localNode) const;
+
+		/// <summary>
+		/// Gets all the portals of this layer.
+		/// </summary>
+		/// <returns>All the portals of this layer.</returns>
+		const std::vector<PathPortal> & GetPortals() const { return m_Portals; }
+
+		/// <summary>
+		/// Gets the portals of a cluster.
+		/// </summary>
+		/// <param name="cluster">The index of the cluster.</param>
+		/// <returns>The indices of the portals of the cluster, in the layer's list of portals.</returns>
+		const std::vector<int> & GetClusterPortals(int cluster) const { return m_ClusterPortals[cluster]; }
+
+		/// <summary>
+		/// Gets the paths from the portals of a cluster to all its nodes.
+		/// </summary>
+		/// <param name="cluster">The index of the cluster.</param>
+		/// <returns>The paths from the portals of the cluster.</returns>
+		const PathClusterPaths & GetClusterPaths(int cluster) const { return *m_ClusterPaths[cluster]; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Finds the least costly paths from a node to every other node of its cluster, without leaving the cluster.
+		/// </summary>
+		/// <param name="sourceNode">The node to find the paths from.</param>
+		/// <param name="costs">Filled out with the cost to each node of the cluster, by local index. Must have room for c_ClusterNodeCount entries.</param>
+		/// <param name="parents">Filled out with the local node each node is reached from, by local index. Must have room for c_ClusterNodeCount entries.</param>
+		void SolveWithinCluster(const PathNode *sourceNode, float *costs, unsigned char *parents) const;
+#pragma endregion
+
+	protected:
+
+		const PathFinder *m_PathFinder; //!< The PathFinder whose node grid this goes over. Not owned.
+		int m_Team; //!< The team whose door cost overlay the costs are taken from, or NOTEAM.
+		float m_DigStrength; //!< What material strength the paths are capable of digging through.
+
+		std::shared_ptr<const PathCostSnapshot> m_CostSnapshot; //!< The costs this layer was made with.
+		unsigned int m_ChangeStamp; //!< The change stamp this layer is up to date with.
+
+		int m_NodeXCount; //!< The number of node columns in the node grid.
+		int m_NodeYCount; //!< The number of node rows in the node grid.
+		int m_ClusterXCount; //!< The number of cluster columns.
+		int m_ClusterYCount; //!< The number of cluster rows.
+
+		std::vector<PathPortal> m_Portals; //!< All the portals of this layer.
+		std::vector<std::vector<int>> m_ClusterPortals; //!< The indices of the portals of each cluster, counting down each cluster column in turn.
+		std::vector<std::shared_ptr<const PathClusterPaths>> m_ClusterPaths; //!< The paths from the portals of each cluster. Shared with older and newer layers as long as the cluster doesn't change.
+
+	private:
+
+		/// <summary>
+		/// Adds the entrances along the border between two adjacent clusters, given every pair of nodes across it.
+		/// Each stretch of border that can be crossed without digging gets an entrance at its middle, or at both ends if it's long. If there is none, the cheapest crossing gets one so the clusters stay connected.
+		/// </summary>
+		/// <param name="crossings">The node on the first side of each pair of nodes across the border, in order along it.</param>
+		/// <param name="edge">The index of the edge that goes across the border from the nodes on the first side.</param>
+		void AddBorderEntrances(const std::vector<PathNode *> &crossings, int edge);
+
+		/// <summary>
+		/// Adds an entrance between two adjacent nodes in different clusters, as a pair of portals.
+		/// </summary>
+		/// <param name="node">The node on the first side of the border.</param>
+		/// <param name="edge">The index of the edge that goes from the node across the border.</param>
+		void AddEntrance(PathNode *node, int edge);
+
+		/// <summary>
+		/// Gets the material strength along an edge going out from a node, with the costs of this layer.
+		/// </summary>
+		/// <param name="node">The node the edge goes out from.</param>
+		/// <param name="edge">The index of the edge, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		/// <returns>The material strength along the edge.</returns>
+		float GetEdgeStrength(const PathNode *node, int edge) const { return m_CostSnapshot->GetEdgeCost(node, edge, m_Team); }
+
+		/// <summary>
+		/// Gets the cost of going along an edge going out from a node, with the costs and dig strength of this layer.
+		/// </summary>
+		/// <param name="node">The node the edge goes out from.</param>
+		/// <param name="edge">The index of the edge, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		/// <returns>The cost of going along the edge.</returns>
+		float GetEdgeCost(const PathNode *node, int edge) const;
+
+		// Disallow the use of some implicit methods.
+		PathClusterLayer(const PathClusterLayer &reference) {}
+		PathClusterLayer & operator=(const PathClusterLayer &rhs) {}
+	};
+
+	/// <summary>
+	/// Searches for paths over the portals of a PathClusterLayer and turns them back into paths over the nodes. Each PathSolver has its own, since the MicroPather it uses can't be shared between threads.
+	/// </summary>
+	class PathClusterSearch : public Graph {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a PathClusterSearch object.
+		/// </summary>
+		PathClusterSearch();
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a PathClusterSearch object before deletion.
+		/// </summary>
+		virtual ~PathClusterSearch() { delete m_Pather; }
+#pragma endregion
+
+#pragma region PathFinding
+		/// <summary>
+		/// Calculates the path between two nodes that are far apart, over the portals of a layer.
+		/// </summary>
+		/// <param name="clusterLayer">The layer to search over.</param>
+		/// <param name="startNode">The node to find the path from.</param>
+		/// <param name="endNode">The node to find the path to.</param>
+		/// <param name="statePath">Filled out with every node along the path, including the start and end nodes.</param>
+		/// <param name="totalCost">Set to the total cost of the path.</param>
+		/// <returns>Success or failure, expressed as SOLVED or NO_SOLUTION.</returns>
+		int Solve(const PathClusterLayer &clusterLayer, PathNode *startNode, PathNode *endNode, std::vector<void *> &statePath, float &totalCost);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph.
+		/// Gets the least possible cost to get from portal A to B, if it all was air.
+		/// </summary>
+		/// <param name="startState">Pointer to the portal to start from. OINT.</param>
+		/// <param name="endState">Portal to end up at. OINT.</param>
+		/// <returns>The cost of the absolutely fastest possible way between the two portals, as if traveled through air all the way.</returns>
+		virtual float LeastCostEstimate(void *startState, void *endState);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph.
+		/// Gets the cost to go to the partner of the portal passed in, and to every other portal of its cluster.
+		/// </summary>
+		/// <param name="state">Pointer to the portal to get to cost of all adjacents for. OINT.</param>
+		/// <param name="adjacentList">An empty vector which will be filled out with all the portals adjacent to the one passed in.</param>
+		virtual void AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph. This function is only used in DEBUG mode - it dumps output to stdout.
+		/// </summary>
+		/// <param name="state">The state to print out info about.</param>
+		virtual void PrintStateInfo(void *state) { ; }
+#pragma endregion
+
+	protected:
+
+		MicroPather *m_Pather; //!< The pathing object that does the searching over the portals. Owned.
+
+		const PathClusterLayer *m_ClusterLayer; //!< The layer being searched right now. Not owned.
+		PathPortal m_StartPortal; //!< Stands in for the start node of the path being searched for, which is connected to all the portals of its cluster.
+		PathPortal m_EndPortal; //!< Stands in for the end node of the path being searched for, which all the portals of its cluster are connected to.
+		float m_StartCosts[PathClusterLayer::c_ClusterNodeCount]; //!< The costs from the start node to each node of its cluster.
+		unsigned char m_StartParents[PathClusterLayer::c_ClusterNodeCount]; //!< The local node each node of the start cluster is reached from on the least costly path from the start node.
+
+	private:
+
+		/// <summary>
+		/// Adds the nodes along the path within a cluster from one portal to another, not including the first.
+		/// </summary>
+		/// <param name="fromPortal">The portal the path within the cluster starts at.</param>
+		/// <param name="toPortal">The portal the path within the cluster ends at.</param>
+		/// <param name="statePath">The list of nodes to add the nodes to.</param>
+		void AddClusterPath(const PathPortal *fromPortal, const PathPortal *toPortal, std::vector<void *> &statePath) const;
+
+		// Disallow the use of some implicit methods.
+		PathClusterSearch(const PathClusterSearch &reference) {}
+		PathClusterSearch & operator=(const PathClusterSearch &rhs) {}
+	};
+}
+#endif
@@ -1,14 +1,126 @@
 #include "PathFinder.h"
+#include "PathClusterLayer.h"
+#include "MovableMan.h"
+#include "ThreadMan.h"
+#include "TimerMan.h"
+#include "PerformanceMan.h"
+
+#include <random>
 
 namespace RTE {
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathSolver::PathSolver(const PathFinder *pathFinder, unsigned int allocate) {
+		m_PathFinder = pathFinder;
+		m_Pather = new MicroPather(this, allocate);
+		m_ClusterSearch = new PathClusterSearch();
+		m_ActiveCostOverlay = nullptr;
+		m_DigStrength = 1;
+		m_Team = Activity::NOTEAM;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathSolver::~PathSolver() {
+		delete m_Pather;
+		delete m_ClusterSearch;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathSolver::SolvePathRequest(PathRequest &pathRequest, const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const std::shared_ptr<const PathClusterLayer> &clusterLayer) {
+		if (clusterLayer) {
+			Vector start = pathRequest.StartPos;
+			Vector end = pathRequest.TargetPos;
+			g_SceneMan.ForceBounds(start);
+			g_SceneMan.ForceBounds(end);
+
+			std::vector<void *> statePath;
+			int result = m_ClusterSearch->Solve(*clusterLayer, m_PathFinder->GetNodeAtPos(start), m_PathFinder->GetNodeAtPos(end), statePath, pathRequest.TotalCost);
+			if (result == MicroPather::SOLVED) {
+				PathFinder::FillPathResult(statePath, start, end, pathRequest.PathResult);
+				pathRequest.Status = result;
+				return;
+			}
+			// Fall back to searching the node grid directly, which will come up with the same straight path if there really is no solution
+		}
+		// The pather caches the costs it has seen, so it has to start over whenever they may be different
+		if (m_CostSnapshot != costSnapshot || m_Team != pathRequest.Team || m_DigStrength != pathRequest.DigStrength) {
+			m_CostSnapshot = costSnapshot;
+			m_Team = pathRequest.Team;
+			m_DigStrength = pathRequest.DigStrength;
+			m_Pather->Reset();
+		}
+		bool teamHasDoorOverlay = m_Team > Activity::NOTEAM && m_Team < Activity::MAXTEAMCOUNT && !m_CostSnapshot->TeamDoorCostOverlays[m_Team].empty();
+		m_ActiveCostOverlay = teamHasDoorOverlay ? &m_CostSnapshot->TeamDoorCostOverlays[m_Team] : nullptr;
+
+		pathRequest.Status = m_PathFinder->SolvePath(m_Pather, pathRequest.StartPos, pathRequest.TargetPos, pathRequest.PathResult, pathRequest.TotalCost);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathSolver::LeastCostEstimate(void *startState, void *endState) {
+		return g_SceneMan.ShortestDistance((static_cast<PathNode *>(startState))->Pos, (static_cast<PathNode *>(endState))->Pos).GetMagnitude();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathSolver::AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList) {
+		const PathNode *node = static_cast<PathNode *>(state);
+
+		if (m_ActiveCostOverlay) {
+			std::unordered_map<const PathNode *, std::array<float, PathNode::c_EdgeCount>>::const_iterator overlayEntry = m_ActiveCostOverlay->find(node);
+			if (overlayEntry != m_ActiveCostOverlay->end()) {
+				PathFinder::AddAdjacentCosts(node, overlayEntry->second, m_DigStrength, adjacentList);
+				return;
+			}
+		}
+		PathFinder::AddAdjacentCosts(node, m_CostSnapshot->GetNodeCosts(node, Activity::NOTEAM), m_DigStrength, adjacentList);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::Clear() {
 		m_NodeGrid.clear();
+		m_NodeXCount = 0;
+		m_NodeYCount = 0;
+		for (std::vector<float> &edgeCosts : m_NodeCosts) {
+			edgeCosts.clear();
+		}
 		m_NodeDimension = 20;
+		m_PatherAllocationSize = 2000;
 		m_DigStrength = 1;
 		m_Pather = 0;
+		m_PatherTeam = Activity::NOTEAM;
+		m_PatherDigStrength = 1;
+		m_TeamPathers.fill(nullptr);
+		m_TeamPatherDigStrengths.fill(1);
+		for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team) {
+			m_TeamDoorFootprints[team].clear();
+			m_TeamDoorCostOverlays[team].clear();
+		}
+		m_ActiveCostOverlay = nullptr;
+		// Whoever queued the requests may still be waiting on them, so they're completed without a path instead of being dropped unanswered
+		for (const std::shared_ptr<PathRequest> &pathRequest : m_PathRequestQueue) {
+			pathRequest->PathResult.clear();
+			pathRequest->TotalCost = 0;
+			pathRequest->Status = MicroPather::NO_SOLUTION;
+			pathRequest->CompleteTime = pathRequest->RequestTime;
+			pathRequest->Complete = true;
+		}
+		m_PathRequestQueue.clear();
+		m_PathRequestFutures.clear();
+		m_CostSnapshot.reset();
+		m_CostSnapshotOutdated = true;
+		m_PathSolvers.clear();
+		m_IdlePathSolvers.clear();
+		m_ClusterXCount = 0;
+		m_ClusterYCount = 0;
+		m_ClusterChangeStamps.clear();
+		m_ClusterChangeStamp = 1;
+		m_CostSnapshotChangeStamp = 0;
+		m_ClusterLayers.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +129,7 @@ namespace RTE {
 		RTEAssert(scene, "Scene doesn't exist or isn't loaded when creating PathFinder!");
 
 		m_NodeDimension = nodeDimension;
+		m_PatherAllocationSize = allocate;
 		int sceneWidth = g_SceneMan.GetSceneWidth();
 		int sceneHeight = g_SceneMan.GetSceneHeight();
 
@@ -24,39 +137,41 @@ namespace RTE {
 		int nodeXCount = std::ceilf(static_cast<float>(sceneWidth) / static_cast<float>(m_NodeDimension));
 		int nodeYCount = std::ceilf(static_cast<float>(sceneHeight) / static_cast<float>(m_NodeDimension));
 
-		// Create and assign scene coordinate positions for all nodes
-		PathNode *node = 0;
+		m_NodeXCount = nodeXCount;
+		m_NodeYCount = nodeYCount;
+
+		// Create and assign scene coordinate positions for all nodes, all in one block so they can be streamed through
+		m_NodeGrid.reserve(nodeXCount * nodeYCount);
 		Vector nodePos = Vector(static_cast<float>(nodeDimension) / 2.0F, static_cast<float>(nodeDimension) / 2.0F);
 		for (int x = 0; x < nodeXCount; ++x) {
 			// Make sure no cell centers are off the scene (since they can overlap the far edge of the scene)
 			if (nodePos.m_X >= sceneWidth) { nodePos.m_X = sceneWidth - 1; }
 			// Start the column height over at middle of the top node each new column
 			nodePos.m_Y = static_cast<float>(nodeDimension) / 2.0F;
-			// Create the new column and fill it out
-			std::vector<PathNode *> newColumn;
 			for (int y = 0; y < nodeYCount; ++y) {
 				// Make sure no cell centers are off the scene (since they can overlap the far edge of the scene)
 				if (nodePos.m_Y >= sceneHeight) { nodePos.m_Y = sceneHeight - 1; }
 				// Create the new node with its in-scene position in the center of it
-				node = new PathNode(nodePos);
+				m_NodeGrid.emplace_back(nodePos, m_NodeGrid.size());
 				// Move current position down for the next node in the column
 				nodePos.m_Y += nodeDimension;
-				// Add the newly created node to the column, transferring ownership to it
-				newColumn.push_back(node);
 			}
 			// Move current position one to the right for the next column
 			nodePos.m_X += nodeDimension;
-			// Add the entire new column to the right end of the grid
-			m_NodeGrid.push_back(newColumn);
+		}
+		// Costs are infinite unless recalculated as otherwise
+		for (std::vector<float> &edgeCosts : m_NodeCosts) {
+			edgeCosts.assign(m_NodeGrid.size(), FLT_MAX);
 		}
 		// Assign all the adjacent nodes on each node, taking into account scene wrapping etc.
 		int wrappedUp;
 		int wrappedRight;
 		int wrappedDown;
 		int wrappedLeft;
+		PathNode *node = 0;
 		for (int x = 0; x < nodeXCount; ++x) {
 			for (int y = 0; y < nodeYCount; ++y) {
-				node = m_NodeGrid[x][y];
+				node = GetNode(x, y);
 
 				wrappedLeft = x - 1;
 				if (wrappedLeft < 0 && scene->WrapsX()) { wrappedLeft = nodeXCount - 1; }
@@ -68,29 +183,26 @@ namespace RTE {
 				if (wrappedDown >= nodeYCount && scene->WrapsY()) { wrappedDown = 0; }
 
 				// Leave nulls if any are out of bounds, even after wrapping (ie there was no wrapping in effect in that direction)
-				if (wrappedUp >= 0) { node->Up = m_NodeGrid[x][wrappedUp]; }
-				if (wrappedRight < nodeXCount) { node->Right = m_NodeGrid[wrappedRight][y]; }
-				if (wrappedDown < nodeYCount) { node->Down = m_NodeGrid[x][wrappedDown]; }
-				if (wrappedLeft >= 0) { node->Left = m_NodeGrid[wrappedLeft][y]; }
+				if (wrappedUp >= 0) { node->Up = GetNode(x, wrappedUp); }
+				if (wrappedRight < nodeXCount) { node->Right = GetNode(wrappedRight, y); }
+				if (wrappedDown < nodeYCount) { node->Down = GetNode(x, wrappedDown); }
+				if (wrappedLeft >= 0) { node->Left = GetNode(wrappedLeft, y); }
 
 				// Diagonals
-				if (wrappedUp >= 0 && wrappedRight < nodeXCount) { node->UpRight = m_NodeGrid[wrappedRight][wrappedUp]; }
-				if (wrappedRight < nodeXCount && wrappedDown < nodeYCount) { node->RightDown = m_NodeGrid[wrappedRight][wrappedDown]; }
-				if (wrappedDown < nodeYCount && wrappedLeft >= 0) { node->DownLeft = m_NodeGrid[wrappedLeft][wrappedDown]; }
-				if (wrappedLeft >= 0 && wrappedUp >= 0) { node->LeftUp = m_NodeGrid[wrappedLeft][wrappedUp]; }
+				if (wrappedUp >= 0 && wrappedRight < nodeXCount) { node->UpRight = GetNode(wrappedRight, wrappedUp); }
+				if (wrappedRight < nodeXCount && wrappedDown < nodeYCount) { node->RightDown = GetNode(wrappedRight, wrappedDown); }
+				if (wrappedDown < nodeYCount && wrappedLeft >= 0) { node->DownLeft = GetNode(wrappedLeft, wrappedDown); }
+				if (wrappedLeft >= 0 && wrappedUp >= 0) { node->LeftUp = GetNode(wrappedLeft, wrappedUp); }
 			}
 		}
 		// Create and allocate the pather class which will do the work
 		m_Pather = new MicroPather(this, allocate);
 
-		// If the scene wraps we must find the cost over the seam before doing RecalculateAllCosts() the first time
-		// since the cost is equal to max(node->LeftCost, node->m_Left->RightCost)
-		if (scene->WrapsX()) {
-			for (int y = 0; y < nodeYCount; ++y) {
-				node = m_NodeGrid[0][y];
-				if (node->Left) { node->Left->RightCost = CostAlongLine(node->Pos, node->Left->Pos); }
-			}
-		}
+		// Split the grid into clusters for the cluster layers, where the last ones may be cut short by the edges of the grid
+		m_ClusterXCount = (nodeXCount + c_ClusterNodeSize - 1) / c_ClusterNodeSize;
+		m_ClusterYCount = (nodeYCount + c_ClusterNodeSize - 1) / c_ClusterNodeSize;
+		m_ClusterChangeStamps.assign(m_ClusterXCount * m_ClusterYCount, m_ClusterChangeStamp);
+
 		// Set up all the costs between all nodes
 		RecalculateAllCosts();
 
@@ -100,46 +212,75 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::Destroy() {
-		for (unsigned int x = 0; x < m_NodeGrid.size(); ++x) {
-			for (unsigned int y = 0; y < m_NodeGrid[x].size(); ++y) {
-				delete m_NodeGrid[x][y];
-				m_NodeGrid[x][y] = 0;
-			}
-		}
+		// The worker threads may still be solving paths over the nodes
+		WaitForPathRequests();
+		m_PathSolvers.clear();
+		m_ClusterLayers.clear();
+
 		delete m_Pather;
+		for (MicroPather *teamPather : m_TeamPathers) {
+			delete teamPather;
+		}
 		Clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	int PathFinder::CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength) {
+	int PathFinder::CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength, int team) {
+		PerformanceMan::ProfileZone profileZone("PathFinder::CalculatePath");
 		RTEAssert(m_Pather, "No pather exists, can't calculate the path!");
 
+		// Actors capable of digging can use m_DigStrength to modify the node adjacency cost
+		m_DigStrength = digStrength;
+
+		// Teams see through their own doors, so use the team's door cost overlay if it has one
+		bool teamHasDoorOverlay = team > Activity::NOTEAM && team < Activity::MAXTEAMCOUNT && !m_TeamDoorCostOverlays[team].empty();
+		m_ActiveCostOverlay = teamHasDoorOverlay ? &m_TeamDoorCostOverlays[team] : nullptr;
+		MicroPather *pather = teamHasDoorOverlay ? GetTeamPather(team) : m_Pather;
+
+		// The pather caches the costs it has seen, so it has to start over whenever they may be different, same as the PathSolvers
+		if (teamHasDoorOverlay) {
+			if (m_TeamPatherDigStrengths[team] != digStrength) {
+				m_TeamPatherDigStrengths[team] = digStrength;
+				pather->Reset();
+			}
+		} else if (m_PatherTeam != team || m_PatherDigStrength != digStrength) {
+			m_PatherTeam = team;
+			m_PatherDigStrength = digStrength;
+			pather->Reset();
+		}
+
+		int result = SolvePath(pather, start, end, pathResult, totalCostResult);
+		m_ActiveCostOverlay = nullptr;
+		return result;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int PathFinder::SolvePath(MicroPather *pather, Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult) const {
 		// Make sure start and end are within scene bounds
 		g_SceneMan.ForceBounds(start);
 		g_SceneMan.ForceBounds(end);
 
-		// Convert from absolute scene pixel coordinates to path node indices
-		int startNodeX = std::floorf(start.m_X / static_cast<float>(m_NodeDimension));
-		int startNodeY = std::floorf(start.m_Y / static_cast<float>(m_NodeDimension));
-		int endNodeX = std::floorf(end.m_X / static_cast<float>(m_NodeDimension));
-		int endNodeY = std::floorf(end.m_Y / static_cast<float>(m_NodeDimension));
+		// Do the actual pathfinding, fetch out the list of states that comprise the best path
+		std::vector<void *> statePath;
+		int result = pather->Solve(static_cast<void *>(GetNodeAtPos(start)), static_cast<void *>(GetNodeAtPos(end)), &statePath, &totalCostResult);
 
-		// Clear out the results if it happens to contain anything
-		pathResult.clear();
+		FillPathResult(statePath, start, end, pathResult);
+		return result;
+	}
 
-		// Actors capable of digging can use m_DigStrength to modify the node adjacency cost
-		m_DigStrength = digStrength;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-		// Do the actual pathfinding, fetch out the list of states that comprise the best path
-		std::vector<void *> statePath;
-		int result = m_Pather->Solve(static_cast<void *>(m_NodeGrid[startNodeX][startNodeY]), static_cast<void *>(m_NodeGrid[endNodeX][endNodeY]), &statePath, &totalCostResult);
+	void PathFinder::FillPathResult(const std::vector<void *> &statePath, const Vector &start, const Vector &end, std::list<Vector> &pathResult) {
+		// Clear out the results if it happens to contain anything
+		pathResult.clear();
 
 		// We got something back
 		if (!statePath.empty()) {
 			// Replace the approximate first point from the pathfound path with the exact starting point
 			pathResult.push_back(start);
-			std::vector<void *>::iterator itr = statePath.begin();
+			std::vector<void *>::const_iterator itr = statePath.begin();
 			itr++;
 
 			// Convert from a list of state void pointers to a list of scene position vectors
@@ -158,7 +299,85 @@ namespace RTE {
 			pathResult.push_back(end);
 		}
 		// TODO: Clean up the path, remove series of nodes in the same direction etc?
-		return result;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::QueuePathRequest(const std::shared_ptr<PathRequest> &pathRequest) {
+		pathRequest->RequestTime = g_TimerMan.GetAbsoulteTime();
+		m_PathRequestQueue.push_back(pathRequest);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::ProcessPathRequests() {
+		if (!m_PathRequestQueue.empty()) {
+			UpdateCostSnapshot();
+		}
+		while (!m_PathRequestQueue.empty()) {
+			std::shared_ptr<PathRequest> pathRequest = m_PathRequestQueue.front();
+			m_PathRequestQueue.pop_front();
+
+			// If this queue is the only one holding on to the request, nobody is waiting for it anymore
+			if (pathRequest.use_count() == 1) {
+				pathRequest->Complete = true;
+				continue;
+			}
+			std::shared_ptr<const PathCostSnapshot> costSnapshot = m_CostSnapshot;
+			// Long paths are searched for over the clusters first, which keeps the search small no matter how big the scene is
+			std::shared_ptr<const PathClusterLayer> clusterLayer = IsLongDistancePath(pathRequest->StartPos, pathRequest->TargetPos) ? GetClusterLayer(pathRequest->Team, pathRequest->DigStrength) : nullptr;
+			m_PathRequestFutures.push_back(g_ThreadMan.QueueTask([this, pathRequest, costSnapshot, clusterLayer]() { SolvePathRequest(pathRequest, costSnapshot, clusterLayer); }));
+		}
+
+		// Let go of the futures of all requests that have been solved already
+		m_PathRequestFutures.erase(std::remove_if(m_PathRequestFutures.begin(), m_PathRequestFutures.end(), [](const std::future<void> &pathRequestFuture) {
+			return pathRequestFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}), m_PathRequestFutures.end());
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::WaitForPathRequests() {
+		for (std::future<void> &pathRequestFuture : m_PathRequestFutures) {
+			pathRequestFuture.wait();
+		}
+		m_PathRequestFutures.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::BenchmarkPathRequests(int requestCount, float &medianLatency, float &highLatency) {
+		medianLatency = highLatency = 0;
+		if (requestCount <= 0) {
+			return;
+		}
+		float sceneWidth = static_cast<float>(g_SceneMan.GetSceneWidth());
+		float sceneHeight = static_cast<float>(g_SceneMan.GetSceneHeight());
+
+		// A generator of its own keeps the benchmark from moving the sim's random number sequence along, and makes every run request the same paths
+		std::mt19937 benchmarkRandom(0);
+		std::uniform_real_distribution<float> randomX(0, sceneWidth);
+		std::uniform_real_distribution<float> randomY(0, sceneHeight);
+
+		std::vector<std::shared_ptr<PathRequest>> benchmarkRequests;
+		benchmarkRequests.reserve(requestCount);
+		for (int i = 0; i < requestCount; ++i) {
+			Vector startPos(randomX(benchmarkRandom), randomY(benchmarkRandom));
+			Vector targetPos(randomX(benchmarkRandom), randomY(benchmarkRandom));
+			benchmarkRequests.push_back(std::make_shared<PathRequest>(startPos, targetPos, 1.0F, Activity::NOTEAM));
+			QueuePathRequest(benchmarkRequests.back());
+		}
+		ProcessPathRequests();
+		WaitForPathRequests();
+
+		std::vector<int64_t> latencies;
+		latencies.reserve(requestCount);
+		for (const std::shared_ptr<PathRequest> &benchmarkRequest : benchmarkRequests) {
+			latencies.push_back(benchmarkRequest->CompleteTime - benchmarkRequest->RequestTime);
+		}
+		std::sort(latencies.begin(), latencies.end());
+		medianLatency = static_cast<float>(latencies[latencies.size() / 2]) / 1000.0F;
+		highLatency = static_cast<float>(latencies[std::min(latencies.size() - 1, (latencies.size() * 99) / 100)]) / 1000.0F;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -166,21 +385,33 @@ namespace RTE {
 	void PathFinder::RecalculateAllCosts() {
 		RTEAssert(g_SceneMan.GetScene(), "Scene doesn't exist or isn't loaded when recalculating PathFinder!");
 
-		// Update all the costs going out from each node
-		for (const std::vector<PathNode *> &nodeEntry : m_NodeGrid) {
-			for (PathNode *pathNode : nodeEntry) {
-				UpdateNodeCosts(pathNode);
-				// Should reset the changed flag since we're about to reset the pather
-				pathNode->IsChanged = false;
+		// Trace the lines of all the edges first. They only depend on the terrain, so the columns can all be traced at the same time
+		g_ThreadMan.ParallelFor(m_NodeXCount, [this](size_t nodeX) {
+			for (int nodeY = 0; nodeY < m_NodeYCount; ++nodeY) {
+				CalculateNodeLineCosts(GetNode(nodeX, nodeY));
 			}
+		});
+		// Then the edges that take the opposing edge of the adjacent node into account can be finished, now that those are all up to date
+		for (PathNode &pathNode : m_NodeGrid) {
+			CombineOpposingCosts(&pathNode);
+			MarkNodeClusterChanged(&pathNode);
+			// Should reset the changed flag since we're about to reset the pather
+			pathNode.IsChanged = false;
 		}
-		// Reset the pather when costs change, as per the docs
-		m_Pather->Reset();
+		UpdateTeamDoorCostOverlays(true);
+		m_CostSnapshotOutdated = true;
+
+		// Reset the pathers when costs change, as per the docs
+		ResetPathers();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::RecalculateAreaCosts(const std::list<Box> &boxList) {
+		// Nothing has changed, so there's no need to throw away what the pathers have cached
+		if (boxList.empty()) {
+			return;
+		}
 		Box box;
 		// Go through all the boxes and see if any of the node centers are inside each
 		for (const Box &boxListEntry : boxList) {
@@ -216,14 +447,15 @@ namespace RTE {
 			}
 		}
 
-		// Reset the pather when costs change, as per the docs
-		m_Pather->Reset();
+		UpdateTeamDoorCostOverlays(false);
+		m_CostSnapshotOutdated = true;
+
+		// Reset the pathers when costs change, as per the docs
+		ResetPathers();
 
 		// Reset the changed flag on all nodes
-		for (const std::vector<PathNode *> &nodeEntry : m_NodeGrid) {
-			for (PathNode *pathNode : nodeEntry) {
-				pathNode->IsChanged = false;
-			}
+		for (PathNode &pathNode : m_NodeGrid) {
+			pathNode.IsChanged = false;
 		}
 	}
 
@@ -237,59 +469,48 @@ namespace RTE {
 
 	void PathFinder::AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList) {
 		const PathNode *node = static_cast<PathNode *>(state);
-		micropather::StateCost adjCost;
-		float strength = 0.0F;
 
-		// Add cost for digging upwards
-		if (node->Up) {
-			strength = node->UpCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 2000.0F : strength * 4.0F); // Four times more expensive when digging
-			adjCost.state = static_cast<void *>(node->Up);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Right) {
-			strength = node->RightCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Right);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Down) {
-			strength = node->DownCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Down);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Left) {
-			strength = node->LeftCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Left);
-			adjacentList->push_back(adjCost);
+		// Use the costs of the active door cost overlay instead, if it has any for this node
+		if (m_ActiveCostOverlay) {
+			std::unordered_map<const PathNode *, std::array<float, c_NodeEdgeCount>>::const_iterator overlayEntry = m_ActiveCostOverlay->find(node);
+			if (overlayEntry != m_ActiveCostOverlay->end()) {
+				AddAdjacentCosts(node, overlayEntry->second, m_DigStrength, adjacentList);
+				return;
+			}
 		}
+		AddAdjacentCosts(node, GetNodeCosts(node), m_DigStrength, adjacentList);
+	}
 
-		// Add cost for digging at 45 degrees and for digging upwards
-		if (node->UpRight) {
-			strength = node->UpRightCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 2828.0F : strength * 4.2F);  // Three times more expensive when digging
-			adjCost.state = static_cast<void *>(node->UpRight);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->RightDown) {
-			strength = node->RightDownCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 1414.0F : strength * 1.4F);
-			adjCost.state = static_cast<void *>(node->RightDown);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->DownLeft) {
-			strength = node->DownLeftCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 1414.0F : strength * 1.4F);
-			adjCost.state = static_cast<void *>(node->DownLeft);
-			adjacentList->push_back(adjCost);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::AddAdjacentCosts(const PathNode *node, const std::array<float, c_NodeEdgeCount> &nodeCosts, float digStrength, std::vector<micropather::StateCost> *adjacentList) {
+		micropather::StateCost adjCost;
+		for (int edge = 0; edge < c_NodeEdgeCount; ++edge) {
+			if (PathNode *adjacentNode = node->GetAdjacentNode(edge)) {
+				adjCost.cost = GetAdjacentCost(edge, nodeCosts[edge], digStrength);
+				adjCost.state = static_cast<void *>(adjacentNode);
+				adjacentList->push_back(adjCost);
+			}
 		}
-		if (node->LeftUp) {
-			strength = node->LeftUpCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 2828.0F : strength * 4.2F);  // Three times more expensive when digging
-			adjCost.state = static_cast<void *>(node->LeftUp);
-			adjacentList->push_back(adjCost);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathFinder::GetAdjacentCost(int edge, float strength, float digStrength) {
+		switch (edge) {
+			// Add cost for digging upwards
+			case 0:
+				return 1.0F + ((strength > digStrength) ? strength * 2000.0F : strength * 4.0F); // Four times more expensive when digging
+			case 1:
+			case 2:
+			case 3:
+				return 1.0F + ((strength > digStrength) ? strength * 1000.0F : strength);
+			// Add cost for digging at 45 degrees and for digging upwards
+			case 4:
+			case 7:
+				return 1.4F + ((strength > digStrength) ? strength * 2828.0F : strength * 4.2F); // Three times more expensive when digging
+			default:
+				return 1.4F + ((strength > digStrength) ? strength * 1414.0F : strength * 1.4F);
 		}
 	}
 
@@ -299,19 +520,41 @@ namespace RTE {
 		if (!node) {
 			return;
 		}
-		// Look at each existing adjacent node and calculate the cost for each, offset start and end to cover more terrain
-		if (node->Up) { node->UpCost = std::max(node->Up->DownCost, CostAlongLine(node->Pos + Vector(3, 0), node->Up->Pos + Vector(3, 0))); }
-		if (node->Right) { node->RightCost = CostAlongLine(node->Pos + Vector(0, 3), node->Right->Pos + Vector(0, 3)); }
-		if (node->Down) { node->DownCost = CostAlongLine(node->Pos + Vector(-3, 0), node->Down->Pos + Vector(-3, 0)); }
-		if (node->Left) { node->LeftCost = std::max(node->Left->RightCost, CostAlongLine(node->Pos + Vector(0, -3), node->Left->Pos + Vector(0, -3))); }
-
-		if (node->UpRight) { node->UpRightCost = std::max(node->UpRight->DownLeftCost, CostAlongLine(node->Pos + Vector(2, 2), node->UpRight->Pos + Vector(2, 2))); }
-		if (node->RightDown) { node->RightDownCost = CostAlongLine(node->Pos + Vector(2, -2), node->RightDown->Pos + Vector(2, -2)); }
-		if (node->DownLeft) { node->DownLeftCost = CostAlongLine(node->Pos + Vector(-2, -2), node->DownLeft->Pos + Vector(-2, -2)); }
-		if (node->LeftUp) { node->LeftUpCost = std::max(node->LeftUp->RightDownCost, CostAlongLine(node->Pos + Vector(-2, 2), node->LeftUp->Pos + Vector(-2, 2))); }
+		CalculateNodeLineCosts(node);
+		CombineOpposingCosts(node);
 
 		// Mark this as already changed so the above expensive calculation isn't done redundantly
 		node->IsChanged = true;
+		MarkNodeClusterChanged(node);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::CalculateNodeLineCosts(const PathNode *node) {
+		unsigned int index = node->Index;
+
+		// Look at each existing adjacent node and calculate the cost for each, offset start and end to cover more terrain
+		if (node->Up) { m_NodeCosts[0][index] = CostAlongLine(node->Pos + Vector(3, 0), node->Up->Pos + Vector(3, 0)); }
+		if (node->Right) { m_NodeCosts[1][index] = CostAlongLine(node->Pos + Vector(0, 3), node->Right->Pos + Vector(0, 3)); }
+		if (node->Down) { m_NodeCosts[2][index] = CostAlongLine(node->Pos + Vector(-3, 0), node->Down->Pos + Vector(-3, 0)); }
+		if (node->Left) { m_NodeCosts[3][index] = CostAlongLine(node->Pos + Vector(0, -3), node->Left->Pos + Vector(0, -3)); }
+
+		if (node->UpRight) { m_NodeCosts[4][index] = CostAlongLine(node->Pos + Vector(2, 2), node->UpRight->Pos + Vector(2, 2)); }
+		if (node->RightDown) { m_NodeCosts[5][index] = CostAlongLine(node->Pos + Vector(2, -2), node->RightDown->Pos + Vector(2, -2)); }
+		if (node->DownLeft) { m_NodeCosts[6][index] = CostAlongLine(node->Pos + Vector(-2, -2), node->DownLeft->Pos + Vector(-2, -2)); }
+		if (node->LeftUp) { m_NodeCosts[7][index] = CostAlongLine(node->Pos + Vector(-2, 2), node->LeftUp->Pos + Vector(-2, 2)); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::CombineOpposingCosts(const PathNode *node) {
+		unsigned int index = node->Index;
+
+		// The edges going up and left are as costly as the worse of their own line and the line of the edge coming the other way
+		if (node->Up) { m_NodeCosts[0][index] = std::max(m_NodeCosts[2][node->Up->Index], m_NodeCosts[0][index]); }
+		if (node->Left) { m_NodeCosts[3][index] = std::max(m_NodeCosts[1][node->Left->Index], m_NodeCosts[3][index]); }
+		if (node->UpRight) { m_NodeCosts[4][index] = std::max(m_NodeCosts[6][node->UpRight->Index], m_NodeCosts[4][index]); }
+		if (node->LeftUp) { m_NodeCosts[7][index] = std::max(m_NodeCosts[5][node->LeftUp->Index], m_NodeCosts[7][index]); }
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -319,26 +562,240 @@ namespace RTE {
 	void PathFinder::UpdateNodeCostsInBox(Box &box) {
 		box.Unflip();
 
+		int firstX;
+		int lastX;
+		int firstY;
+		int lastY;
+		GetNodeRangeInBox(box, firstX, lastX, firstY, lastY);
+
+		// Only iterate through the grid where the box overlaps any edges
+		PathNode *node = 0;
+		for (int nodeX = firstX; nodeX <= lastX; ++nodeX) {
+			for (int nodeY = firstY; nodeY <= lastY; ++nodeY) {
+				node = GetNode(nodeX, nodeY);
+				// Update all the costs going out from each node which is found to be affected by the box
+				if (!node->IsChanged) { UpdateNodeCosts(node); }
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::GetNodeRangeInBox(const Box &box, int &firstX, int &lastX, int &firstY, int &lastY) const {
 		// Get the extents of the box' potential influence on nodes and their connecting edges
-		int firstX = std::floorf((box.m_Corner.m_X / static_cast<float>(m_NodeDimension)) + 0.5F) - 1;
-		int lastX = std::floorf(((box.m_Corner.m_X + box.m_Width) / static_cast<float>(m_NodeDimension)) + 0.5F) + 1;
-		int firstY = std::floorf((box.m_Corner.m_Y / static_cast<float>(m_NodeDimension)) + 0.5F) - 1;
-		int lastY = std::floorf(((box.m_Corner.m_Y + box.m_Height) / static_cast<float>(m_NodeDimension)) + 0.5F) + 1;
+		firstX = std::floorf((box.m_Corner.m_X / static_cast<float>(m_NodeDimension)) + 0.5F) - 1;
+		lastX = std::floorf(((box.m_Corner.m_X + box.m_Width) / static_cast<float>(m_NodeDimension)) + 0.5F) + 1;
+		firstY = std::floorf((box.m_Corner.m_Y / static_cast<float>(m_NodeDimension)) + 0.5F) - 1;
+		lastY = std::floorf(((box.m_Corner.m_Y + box.m_Height) / static_cast<float>(m_NodeDimension)) + 0.5F) + 1;
 
 		// Truncate the influence
 		if (firstX < 0) { firstX = 0; }
-		if (lastX >= m_NodeGrid.size()) { lastX = m_NodeGrid.size() - 1; }
+		if (lastX >= m_NodeXCount) { lastX = m_NodeXCount - 1; }
 		if (firstY < 0) { firstY = 0; }
-		if (lastY >= m_NodeGrid[0].size()) { lastY = m_NodeGrid[0].size() - 1; }
+		if (lastY >= m_NodeYCount) { lastY = m_NodeYCount - 1; }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	MicroPather * PathFinder::GetTeamPather(int team) {
+		if (!m_TeamPathers[team]) { m_TeamPathers[team] = new MicroPather(this, m_PatherAllocationSize); }
+		return m_TeamPathers[team];
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::ResetPathers() {
+		m_Pather->Reset();
+		for (MicroPather *teamPather : m_TeamPathers) {
+			if (teamPather) { teamPather->Reset(); }
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::UpdateTeamDoorCostOverlays(bool allCostsChanged) {
+		std::vector<std::pair<Box, unsigned char>> doorFootprints;
+		for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team) {
+			doorFootprints.clear();
+			g_MovableMan.GetDoorMaterialFootprints(team, doorFootprints);
+
+			// The overlay is outdated if the doors themselves changed, or if the terrain around any of them did
+			bool overlayOutdated = allCostsChanged || doorFootprints != m_TeamDoorFootprints[team];
+			for (const std::pair<Box, unsigned char> &doorFootprint : doorFootprints) {
+				if (overlayOutdated) {
+					break;
+				}
+				overlayOutdated = AnyNodeChangedNearArea(doorFootprint.first);
+			}
+			if (overlayOutdated) {
+				m_TeamDoorFootprints[team] = doorFootprints;
+				RecalculateTeamDoorCostOverlay(team);
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::AnyNodeChangedNearArea(const Box &area) const {
+		Box unflippedArea = area;
+		unflippedArea.Unflip();
+
+		int firstX;
+		int lastX;
+		int firstY;
+		int lastY;
+		GetNodeRangeInBox(unflippedArea, firstX, lastX, firstY, lastY);
+
+		// The overlay covers every node in this range, and the costs it calculates for them run along the lines to their adjacent nodes, so those are checked as well
+		firstX = std::max(firstX - 1, 0);
+		lastX = std::min(lastX + 1, m_NodeXCount - 1);
+		firstY = std::max(firstY - 1, 0);
+		lastY = std::min(lastY + 1, m_NodeYCount - 1);
 
-		// Only iterate through the grid where the box overlaps any edges
-		PathNode *node = 0;
 		for (int nodeX = firstX; nodeX <= lastX; ++nodeX) {
 			for (int nodeY = firstY; nodeY <= lastY; ++nodeY) {
-				node = m_NodeGrid[nodeX][nodeY];
-				// Update all the costs going out from each node which is found to be affected by the box
-				if (!node->IsChanged) { UpdateNodeCosts(node); }
+				if (GetNode(nodeX, nodeY)->IsChanged) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::RecalculateTeamDoorCostOverlay(int team) {
+		std::unordered_map<const PathNode *, std::array<float, c_NodeEdgeCount>> &costOverlay = m_TeamDoorCostOverlays[team];
+		// The clusters of the nodes the overlay no longer covers change as well
+		for (const auto &overlayEntry : costOverlay) {
+			MarkNodeClusterChanged(overlayEntry.first);
+		}
+		costOverlay.clear();
+
+		std::array<float, c_NodeEdgeCount> nodeCosts;
+		for (const std::pair<Box, unsigned char> &doorFootprint : m_TeamDoorFootprints[team]) {
+			Box footprintArea = doorFootprint.first;
+			footprintArea.Unflip();
+
+			int firstX;
+			int lastX;
+			int firstY;
+			int lastY;
+			GetNodeRangeInBox(footprintArea, firstX, lastX, firstY, lastY);
+
+			for (int nodeX = firstX; nodeX <= lastX; ++nodeX) {
+				for (int nodeY = firstY; nodeY <= lastY; ++nodeY) {
+					const PathNode *node = GetNode(nodeX, nodeY);
+					if (costOverlay.find(node) != costOverlay.end()) {
+						continue;
+					}
+					CalculateNodeCostsIgnoring(node, m_TeamDoorFootprints[team], nodeCosts);
+
+					// Only keep the nodes where seeing through the doors actually makes a difference, so the overlay stays small
+					if (nodeCosts != GetNodeCosts(node)) {
+						costOverlay.insert({ node, nodeCosts });
+						MarkNodeClusterChanged(node);
+					}
+				}
 			}
 		}
 	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::CalculateNodeCostsIgnoring(const PathNode *node, const std::vector<std::pair<Box, unsigned char>> &ignoredMaterialAreas, std::array<float, c_NodeEdgeCount> &nodeCosts) {
+		nodeCosts.fill(FLT_MAX);
+
+		// Mirror UpdateNodeCosts, including taking the highest of the lines going each way for the edges where it uses the adjacent node's opposing cost
+		if (node->Up) { nodeCosts[0] = std::max(CostAlongLine(node->Up->Pos + Vector(-3, 0), node->Pos + Vector(-3, 0), ignoredMaterialAreas), CostAlongLine(node->Pos + Vector(3, 0), node->Up->Pos + Vector(3, 0), ignoredMaterialAreas)); }
+		if (node->Right) { nodeCosts[1] = CostAlongLine(node->Pos + Vector(0, 3), node->Right->Pos + Vector(0, 3), ignoredMaterialAreas); }
+		if (node->Down) { nodeCosts[2] = CostAlongLine(node->Pos + Vector(-3, 0), node->Down->Pos + Vector(-3, 0), ignoredMaterialAreas); }
+		if (node->Left) { nodeCosts[3] = std::max(CostAlongLine(node->Left->Pos + Vector(0, 3), node->Pos + Vector(0, 3), ignoredMaterialAreas), CostAlongLine(node->Pos + Vector(0, -3), node->Left->Pos + Vector(0, -3), ignoredMaterialAreas)); }
+
+		if (node->UpRight) { nodeCosts[4] = std::max(CostAlongLine(node->UpRight->Pos + Vector(-2, -2), node->Pos + Vector(-2, -2), ignoredMaterialAreas), CostAlongLine(node->Pos + Vector(2, 2), node->UpRight->Pos + Vector(2, 2), ignoredMaterialAreas)); }
+		if (node->RightDown) { nodeCosts[5] = CostAlongLine(node->Pos + Vector(2, -2), node->RightDown->Pos + Vector(2, -2), ignoredMaterialAreas); }
+		if (node->DownLeft) { nodeCosts[6] = CostAlongLine(node->Pos + Vector(-2, -2), node->DownLeft->Pos + Vector(-2, -2), ignoredMaterialAreas); }
+		if (node->LeftUp) { nodeCosts[7] = std::max(CostAlongLine(node->LeftUp->Pos + Vector(2, -2), node->Pos + Vector(2, -2), ignoredMaterialAreas), CostAlongLine(node->Pos + Vector(-2, 2), node->LeftUp->Pos + Vector(-2, 2), ignoredMaterialAreas)); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::UpdateCostSnapshot() {
+		if (m_CostSnapshot && !m_CostSnapshotOutdated) {
+			return;
+		}
+		std::shared_ptr<PathCostSnapshot> costSnapshot = std::make_shared<PathCostSnapshot>();
+		costSnapshot->NodeCosts = m_NodeCosts;
+		costSnapshot->TeamDoorCostOverlays = m_TeamDoorCostOverlays;
+
+		// Requests that are still being solved hold on to the previous snapshot, so it's only freed once they're all done
+		m_CostSnapshot = costSnapshot;
+		m_CostSnapshotOutdated = false;
+
+		// Any changes from here on didn't make it into this snapshot
+		m_CostSnapshotChangeStamp = m_ClusterChangeStamp;
+		m_ClusterChangeStamp++;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::SolvePathRequest(const std::shared_ptr<PathRequest> &pathRequest, const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const std::shared_ptr<const PathClusterLayer> &clusterLayer) {
+		PathSolver *pathSolver = nullptr;
+		{
+			std::lock_guard<std::mutex> solversLock(m_PathSolversMutex);
+			if (m_IdlePathSolvers.empty()) {
+				m_PathSolvers.push_back(std::make_unique<PathSolver>(this, m_PatherAllocationSize));
+				pathSolver = m_PathSolvers.back().get();
+			} else {
+				pathSolver = m_IdlePathSolvers.back();
+				m_IdlePathSolvers.pop_back();
+			}
+		}
+		pathSolver->SolvePathRequest(*pathRequest, costSnapshot, clusterLayer);
+		pathRequest->CompleteTime = g_TimerMan.GetAbsoulteTime();
+		pathRequest->Complete = true;
+
+		std::lock_guard<std::mutex> solversLock(m_PathSolversMutex);
+		m_IdlePathSolvers.push_back(pathSolver);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::IsLongDistancePath(Vector start, Vector end) const {
+		g_SceneMan.ForceBounds(start);
+		g_SceneMan.ForceBounds(end);
+		const PathNode *startNode = GetNodeAtPos(start);
+		const PathNode *endNode = GetNodeAtPos(end);
+
+		int clusterDistanceX = std::abs(static_cast<int>(startNode->Index) / m_NodeYCount / c_ClusterNodeSize - static_cast<int>(endNode->Index) / m_NodeYCount / c_ClusterNodeSize);
+		int clusterDistanceY = std::abs((static_cast<int>(startNode->Index) % m_NodeYCount) / c_ClusterNodeSize - (static_cast<int>(endNode->Index) % m_NodeYCount) / c_ClusterNodeSize);
+		if (g_SceneMan.SceneWrapsX()) { clusterDistanceX = std::min(clusterDistanceX, m_ClusterXCount - clusterDistanceX); }
+		if (g_SceneMan.SceneWrapsY()) { clusterDistanceY = std::min(clusterDistanceY, m_ClusterYCount - clusterDistanceY); }
+		return std::max(clusterDistanceX, clusterDistanceY) > 1;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::shared_ptr<const PathClusterLayer> PathFinder::GetClusterLayer(int team, float digStrength) {
+		int layerTeam = (team > Activity::NOTEAM && team < Activity::MAXTEAMCOUNT && !m_TeamDoorCostOverlays[team].empty()) ? team : Activity::NOTEAM;
+
+		std::list<std::shared_ptr<const PathClusterLayer>>::iterator layerItr = std::find_if(m_ClusterLayers.begin(), m_ClusterLayers.end(), [layerTeam, digStrength](const std::shared_ptr<const PathClusterLayer> &clusterLayer) {
+			return clusterLayer->GetTeam() == layerTeam && clusterLayer->GetDigStrength() == digStrength;
+		});
+		std::shared_ptr<const PathClusterLayer> previousLayer;
+		if (layerItr != m_ClusterLayers.end()) {
+			previousLayer = *layerItr;
+			m_ClusterLayers.erase(layerItr);
+		}
+		if (previousLayer && previousLayer->GetCostSnapshot() == m_CostSnapshot) {
+			m_ClusterLayers.push_front(previousLayer);
+			return previousLayer;
+		}
+		// Layers are never changed once made, since paths may still be being solved over the previous one
+		std::shared_ptr<PathClusterLayer> clusterLayer = std::make_shared<PathClusterLayer>(this, layerTeam, digStrength);
+		clusterLayer->Create(m_CostSnapshot, previousLayer.get(), m_ClusterChangeStamps, m_CostSnapshotChangeStamp);
+		m_ClusterLayers.push_front(clusterLayer);
+		if (m_ClusterLayers.size() > c_MaxClusterLayers) { m_ClusterLayers.pop_back(); }
+		return clusterLayer;
+	}
 }
\ No newline at end of file
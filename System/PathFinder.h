@@ -3,6 +3,9 @@
 
 #include "Box.h"
 #include "Scene.h"
+
+#include <future>
+#include <atomic>
 #include "System/MicroPather/micropather.h"
 
 using namespace micropather;
@@ -10,15 +13,19 @@ using namespace micropather;
 namespace RTE {
 
 	/// <summary>
-	/// Contains everything related to a node on the path grid used by PathFinder.
+	/// Contains everything related to a node on the path grid used by PathFinder. The costs to get to each of the adjacent nodes are kept by the PathFinder, in one array per edge.
 	/// </summary>
 	struct PathNode {
 
+		static constexpr int c_EdgeCount = 8; //!< The number of edges going out from each node, one to each adjacent node.
+
 		Vector Pos; //!< Absolute position of the center of this node in the scene.    
+		unsigned int Index; //!< The index of this node in the grid, counting down each column in turn.
 		bool IsChanged; //!< Whether this has been updated since last call to Reset the pather.
 
 		/// <summary>
 		/// Pointers to all adjacent nodes. These are not owned, and may be 0 if adjacent to non-wrapping scene border.
+		/// The edges going out from a node are numbered in this same order, starting at Up.
 		/// </summary>
 		PathNode *Up;
 		PathNode *Right;
@@ -29,26 +36,189 @@ namespace RTE {
 		PathNode *DownLeft;
 		PathNode *LeftUp;
 
+		PathNode(Vector pos, unsigned int index) {
+			Pos = pos;
+			Index = index;
+			IsChanged = false;
+			Up = Right = Down = Left = UpRight = RightDown = DownLeft = LeftUp = 0;
+		}
+
 		/// <summary>
-		/// Costs to get to each of the adjacent nodes.
+		/// Gets the adjacent node an edge leads to.
 		/// </summary>
-		float UpCost;
-		float RightCost;
-		float DownCost;
-		float LeftCost;
-		float UpRightCost;
-		float RightDownCost;
-		float DownLeftCost;
-		float LeftUpCost;
+		/// <param name="edge">The index of the edge, in the same order as the adjacent node members, starting at Up.</param>
+		/// <returns>The adjacent node, or 0 if there is none that way.</returns>
+		PathNode * GetAdjacentNode(int edge) const {
+			switch (edge) {
+				case 0: return Up;
+				case 1: return Right;
+				case 2: return Down;
+				case 3: return Left;
+				case 4: return UpRight;
+				case 5: return RightDown;
+				case 6: return DownLeft;
+				case 7: return LeftUp;
+				default: return 0;
+			}
+		}
+	};
 
-		PathNode(Vector pos) {
-			Pos = pos;
-			Up = Right = Down = Left = UpRight = RightDown = DownLeft = LeftUp = 0;
-			// Costs are infinite unless recalculated as otherwise
-			UpCost = RightCost = DownCost = LeftCost = UpRightCost = RightDownCost = DownLeftCost = LeftUpCost = FLT_MAX;
+	/// <summary>
+	/// A request for a path that is calculated later on a worker thread, together with all other requests made during the same sim update.
+	/// Shared between whoever made the request and the queue and worker it goes through, so a request whose maker has gone away is simply skipped and the maker can poll it for completion.
+	/// </summary>
+	struct PathRequest {
+
+		Vector StartPos; //!< The position to find the path from.
+		Vector TargetPos; //!< The position to find the path to.
+		float DigStrength; //!< What material strength the search is capable of digging through.
+		int Team; //!< The team the path is for, which decides what doors can be passed through.
+
+		std::list<Vector> PathResult; //!< The waypoints of the calculated path. Only valid once the request is complete.
+		float TotalCost; //!< The total cost of the calculated path. Only valid once the request is complete.
+		int Status; //!< The result of the path calculation, expressed as SOLVED, NO_SOLUTION, or START_END_SAME. Only valid once the request is complete.
+		std::atomic<bool> Complete; //!< Whether the path has been calculated yet. Set last by the worker thread, so the results can be read once this is true.
+
+		int64_t RequestTime; //!< The absolute time the request was queued at, in microseconds.
+		int64_t CompleteTime; //!< The absolute time the request was completed at, in microseconds. Only valid once the request is complete.
+
+		PathRequest(const Vector &startPos, const Vector &targetPos, float digStrength, int team) {
+			StartPos = startPos;
+			TargetPos = targetPos;
+			DigStrength = digStrength;
+			Team = team;
+			TotalCost = 0;
+			Status = MicroPather::NO_SOLUTION;
+			Complete = false;
+			RequestTime = 0;
+			CompleteTime = 0;
+		}
+	};
+
+	/// <summary>
+	/// An immutable copy of all the costs between the nodes of a PathFinder, so paths can be solved on worker threads while the PathFinder itself keeps getting updated.
+	/// </summary>
+	struct PathCostSnapshot {
+
+		std::array<std::vector<float>, PathNode::c_EdgeCount> NodeCosts; //!< The costs of each edge of every node, one array per edge in the same order as the PathNode adjacent node members, each indexed by node index.
+		std::array<std::unordered_map<const PathNode *, std::array<float, PathNode::c_EdgeCount>>, Activity::MAXTEAMCOUNT> TeamDoorCostOverlays; //!< The door cost overlays of each team.
+
+		/// <summary>
+		/// Gets the costs of a node as seen by a team, which are the ones in the team's door cost overlay if it has any for the node.
+		/// </summary>
+		/// <param name="node">The node to get the costs of.</param>
+		/// <param name="team">The team to get the costs for, or NOTEAM for the plain costs.</param>
+		/// <returns>The costs of the node, in the same order as the PathNode adjacent node members, starting at Up.</returns>
+		std::array<float, PathNode::c_EdgeCount> GetNodeCosts(const PathNode *node, int team) const {
+			if (team > Activity::NOTEAM && team < Activity::MAXTEAMCOUNT) {
+				std::unordered_map<const PathNode *, std::array<float, PathNode::c_EdgeCount>>::const_iterator overlayEntry = TeamDoorCostOverlays[team].find(node);
+				if (overlayEntry != TeamDoorCostOverlays[team].end()) {
+					return overlayEntry->second;
+				}
+			}
+			std::array<float, PathNode::c_EdgeCount> nodeCosts;
+			for (int edge = 0; edge < PathNode::c_EdgeCount; ++edge) {
+				nodeCosts[edge] = NodeCosts[edge][node->Index];
+			}
+			return nodeCosts;
+		}
+
+		/// <summary>
+		/// Gets the cost of a single edge of a node as seen by a team, which is the one in the team's door cost overlay if it has any for the node.
+		/// </summary>
+		/// <param name="node">The node the edge goes out from.</param>
+		/// <param name="edge">The index of the edge, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		/// <param name="team">The team to get the cost for, or NOTEAM for the plain cost.</param>
+		/// <returns>The cost of the edge.</returns>
+		float GetEdgeCost(const PathNode *node, int edge, int team) const {
+			if (team > Activity::NOTEAM && team < Activity::MAXTEAMCOUNT) {
+				std::unordered_map<const PathNode *, std::array<float, PathNode::c_EdgeCount>>::const_iterator overlayEntry = TeamDoorCostOverlays[team].find(node);
+				if (overlayEntry != TeamDoorCostOverlays[team].end()) {
+					return overlayEntry->second[edge];
+				}
+			}
+			return NodeCosts[edge][node->Index];
 		}
 	};
 
+	class PathFinder;
+	class PathClusterLayer;
+	class PathClusterSearch;
+
+	/// <summary>
+	/// Solves paths on a worker thread, over the node grid of a PathFinder but with the costs of a PathCostSnapshot. Each PathSolver has its own MicroPather, since those can't be shared between threads.
+	/// </summary>
+	class PathSolver : public Graph {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a PathSolver object.
+		/// </summary>
+		/// <param name="pathFinder">The PathFinder whose node grid to solve paths over. Ownership is NOT transferred!</param>
+		/// <param name="allocate">The block size that the node cache is allocated from.</param>
+		PathSolver(const PathFinder *pathFinder, unsigned int allocate);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a PathSolver object before deletion.
+		/// </summary>
+		virtual ~PathSolver();
+#pragma endregion
+
+#pragma region PathFinding
+		/// <summary>
+		/// Calculates the path of a request and fills out its results. Does not mark the request complete.
+		/// </summary>
+		/// <param name="pathRequest">The request to calculate the path of.</param>
+		/// <param name="costSnapshot">The costs to calculate the path with.</param>
+		/// <param name="clusterLayer">The cluster layer to search over first, made with the same costs and for the request's team and dig strength, or nullptr to search the node grid directly.</param>
+		void SolvePathRequest(PathRequest &pathRequest, const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const std::shared_ptr<const PathClusterLayer> &clusterLayer);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph.
+		/// Gets the least possible cost to get from node A to B, if it all was air.
+		/// </summary>
+		/// <param name="startState">Pointer to node to start from. OINT.</param>
+		/// <param name="endState">Node to end up at. OINT.</param>
+		/// <returns>The cost of the absolutely fastest possible way between the two points, as if traveled through air all the way.</returns>
+		virtual float LeastCostEstimate(void *startState, void *endState);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph.
+		/// Gets the cost to go to any adjacent node of the one passed in, from the current cost snapshot.
+		/// </summary>
+		/// <param name="state">Pointer to node to get to cost of all adjacents for. OINT.</param>
+		/// <param name="adjacentList">An empty vector which will be filled out with all the valid nodes adjacent to the one passed in.</param>
+		virtual void AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList);
+
+		/// <summary>
+		/// Implementation of the abstract interface of Graph. This function is only used in DEBUG mode - it dumps output to stdout.
+		/// </summary>
+		/// <param name="state">The state to print out info about.</param>
+		virtual void PrintStateInfo(void *state) { ; }
+#pragma endregion
+
+	protected:
+
+		const PathFinder *m_PathFinder; //!< The PathFinder whose node grid paths are solved over. Not owned.
+		MicroPather *m_Pather; //!< The pathing object that does the pathfinding work. Owned.
+		PathClusterSearch *m_ClusterSearch; //!< The object that searches over cluster layers. Owned.
+
+		std::shared_ptr<const PathCostSnapshot> m_CostSnapshot; //!< The costs the pather has last been solving with.
+		const std::unordered_map<const PathNode *, std::array<float, PathNode::c_EdgeCount>> *m_ActiveCostOverlay; //!< The door cost overlay of the snapshot used by the path being calculated right now, if any. Not owned.
+		float m_DigStrength; //!< What material strength the search is capable of digging through.
+		int m_Team; //!< The team the pather has last been solving for.
+
+	private:
+
+		// Disallow the use of some implicit methods.
+		PathSolver(const PathSolver &reference) {}
+		PathSolver & operator=(const PathSolver &rhs) {}
+	};
+
 	/// <summary>
 	/// A class encapsulating and implementing the MicroPather A* pathfinding library.
 	/// </summary>
@@ -101,16 +271,49 @@ namespace RTE {
 		/// <param name="pathResult">A list which will be filled out with waypoints between the start and end.</param>
 		/// <param name="totalCostResult">The total minimum difficulty cost calculated between the two points on the scene.</param>
 		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <param name="team">The team the path is for. The team's own doors are treated as passable. NOTEAM means all doors are treated as the terrain they're drawn into.</param>
 		/// <returns>Success or failure, expressed as SOLVED, NO_SOLUTION, or START_END_SAME.</returns>
-		int CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength = 1);
+		int CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength = 1, int team = Activity::NOTEAM);
+
+		/// <summary>
+		/// Adds a path request to the queue of requests that are handed out to the worker threads all at once by the next call to ProcessPathRequests.
+		/// </summary>
+		/// <param name="pathRequest">The request to queue. Its PathResult and Complete members are filled out once it has been solved.</param>
+		void QueuePathRequest(const std::shared_ptr<PathRequest> &pathRequest);
+
+		/// <summary>
+		/// Gets whether there are any queued path requests waiting to be calculated.
+		/// </summary>
+		/// <returns>Whether there are any queued path requests.</returns>
+		bool HasQueuedPathRequests() const { return !m_PathRequestQueue.empty(); }
+
+		/// <summary>
+		/// Hands out all queued path requests to be solved on the worker threads, against a snapshot of the current costs. Each request is marked complete once it has been solved.
+		/// Requests that nobody is waiting on anymore are dropped without being calculated. Requests between far apart clusters are searched for over the cluster layer of their team and dig strength first.
+		/// </summary>
+		void ProcessPathRequests();
+
+		/// <summary>
+		/// Blocks until all path requests handed out to the worker threads have been solved.
+		/// </summary>
+		void WaitForPathRequests();
+
+		/// <summary>
+		/// Fires a number of path requests between random points on the scene all at once, and measures how long it takes for them to be solved.
+		/// </summary>
+		/// <param name="requestCount">How many path requests to fire.</param>
+		/// <param name="medianLatency">Set to the median time from queuing a request to it being solved, in milliseconds.</param>
+		/// <param name="highLatency">Set to the 99th percentile time from queuing a request to it being solved, in milliseconds.</param>
+		void BenchmarkPathRequests(int requestCount, float &medianLatency, float &highLatency);
 
 		/// <summary>
-		/// Recalculates all the costs between all the nodes by tracing lines in the material layer and summing all the material strengths for each encountered pixel. Also resets the pather itself.
+		/// Recalculates all the costs between all the nodes by tracing lines in the material layer and summing all the material strengths for each encountered pixel, as well as all the team door cost overlays. Also resets the pathers.
 		/// </summary>
 		void RecalculateAllCosts();
 
 		/// <summary>
-		/// Recalculates the costs between all the nodes touching a list of specific rectangular areas (which will be wrapped). Also resets the pather itself.
+		/// Recalculates the costs between all the nodes touching a list of specific rectangular areas (which will be wrapped), and the door cost overlays of any teams whose doors were affected. Also resets the pathers.
+		/// Does nothing if the list is empty.
 		/// </summary>
 		/// <param name="boxList">The list of Boxes representing the updated areas.</param>
 		void RecalculateAreaCosts(const std::list<Box> &boxList);
@@ -147,12 +350,49 @@ namespace RTE {
 
 	protected:
 
+		friend class PathSolver;
+		friend class PathClusterLayer;
+
+		static constexpr int c_NodeEdgeCount = PathNode::c_EdgeCount; //!< The number of edges going out from each node.
+		static constexpr int c_ClusterNodeSize = 10; //!< The width and height of each cluster of the cluster layers, in nodes.
+		static constexpr int c_MaxClusterLayers = 8; //!< The most cluster layers that are kept around at once, for the most recently used teams and dig strengths.
+
 		MicroPather *m_Pather; //!< The actual pathing object that does the pathfinding work. Owned.
-		std::vector<std::vector<PathNode *>> m_NodeGrid;  //!< The array of PathNodes representing the grid on the scene. The nodes are owned by this.
+		std::vector<PathNode> m_NodeGrid; //!< All the PathNodes of the grid on the scene in one block, counting down each column in turn. Never resized once created, so the nodes can point to each other.
+		int m_NodeXCount; //!< The number of node columns in the grid.
+		int m_NodeYCount; //!< The number of node rows in the grid.
+		std::array<std::vector<float>, c_NodeEdgeCount> m_NodeCosts; //!< The costs of each edge of every node, one array per edge in the same order as the PathNode adjacent node members, each indexed by node index.
 		unsigned int m_NodeDimension; //!< The width and height of each node, in pixels on the scene.
+		unsigned int m_PatherAllocationSize; //!< The block size that the node caches of the pathers are allocated from.
 
 		float m_DigStrength; //!< What material strength the search is capable of digging through.
 
+		int m_PatherTeam; //!< The team the main pather last calculated a path for, since it has to be reset when that changes.
+		float m_PatherDigStrength; //!< The dig strength the main pather last calculated a path with, since it has to be reset when that changes.
+
+		std::array<MicroPather *, Activity::MAXTEAMCOUNT> m_TeamPathers; //!< Separate pathing objects for each team that has a door cost overlay, since the pathers cache the costs they see. Created when first needed. Owned.
+		std::array<float, Activity::MAXTEAMCOUNT> m_TeamPatherDigStrengths; //!< The dig strength each team pather last calculated a path with, since it has to be reset when that changes.
+		std::array<std::vector<std::pair<Box, unsigned char>>, Activity::MAXTEAMCOUNT> m_TeamDoorFootprints; //!< The areas and materials of each team's doors that its door cost overlay was calculated with.
+		std::array<std::unordered_map<const PathNode *, std::array<float, c_NodeEdgeCount>>, Activity::MAXTEAMCOUNT> m_TeamDoorCostOverlays; //!< For each team, the costs of all nodes whose costs differ when the team's own doors are seen through. Costs are in the same order as the PathNode adjacent node members, starting at Up.
+		const std::unordered_map<const PathNode *, std::array<float, c_NodeEdgeCount>> *m_ActiveCostOverlay; //!< The door cost overlay used by the path being calculated right now, if any. Not owned.
+
+		std::deque<std::shared_ptr<PathRequest>> m_PathRequestQueue; //!< The path requests waiting to be handed out by the next ProcessPathRequests.
+		std::vector<std::future<void>> m_PathRequestFutures; //!< The futures of the path requests handed out to the worker threads that may not be solved yet.
+
+		std::shared_ptr<const PathCostSnapshot> m_CostSnapshot; //!< The latest snapshot of the costs, that newly handed out path requests are solved with.
+		bool m_CostSnapshotOutdated; //!< Whether any costs have changed since the latest snapshot was taken.
+
+		int m_ClusterXCount; //!< The number of cluster columns the node grid is split into.
+		int m_ClusterYCount; //!< The number of cluster rows the node grid is split into.
+		std::vector<unsigned int> m_ClusterChangeStamps; //!< The change stamp of the last time any node costs in each cluster changed, counting down each cluster column in turn.
+		unsigned int m_ClusterChangeStamp; //!< The change stamp that cost changes are marked with right now. Moves on every time a cost snapshot is taken.
+		unsigned int m_CostSnapshotChangeStamp; //!< The change stamp of all the changes that made it into the latest snapshot.
+		std::list<std::shared_ptr<const PathClusterLayer>> m_ClusterLayers; //!< The most recently used cluster layers, most recent first.
+
+		std::vector<std::unique_ptr<PathSolver>> m_PathSolvers; //!< All the PathSolvers made so far, one for each path request that has been solved at the same time. Owned.
+		std::vector<PathSolver *> m_IdlePathSolvers; //!< The PathSolvers that aren't solving anything right now. Not owned.
+		std::mutex m_PathSolversMutex; //!< Mutex guarding the PathSolvers between the worker threads.
+
 	private:
 
 #pragma region Path Cost Updates
@@ -166,6 +406,15 @@ namespace RTE {
 		/// <returns>The cost value.</returns>
 		float CostAlongLine(const Vector &start, const Vector &end) { return g_SceneMan.CastMaxStrengthRay(start, end, 0); }
 
+		/// <summary>
+		/// Helper function for calculating the cost of going in a straight line between any two points on the scene, ignoring pixels of specific materials within specific areas.
+		/// </summary>
+		/// <param name="start">Origin point.</param>
+		/// <param name="end">Destination point.</param>
+		/// <param name="ignoredMaterialAreas">The areas within which pixels of the paired material ID are ignored.</param>
+		/// <returns>The cost value.</returns>
+		float CostAlongLine(const Vector &start, const Vector &end, const std::vector<std::pair<Box, unsigned char>> &ignoredMaterialAreas) { return g_SceneMan.CastMaxStrengthRay(start, end, 0, ignoredMaterialAreas); }
+
 		/// <summary>
 		/// Helper function for updating all the values of cost edges going out from a specific node.
 		/// This does NOT update the pather, which is required before solving more paths after calling this.
@@ -173,12 +422,184 @@ namespace RTE {
 		/// <param name="node">The node to update all costs of. OINT. It's safe to pass 0 here.</param>
 		void UpdateNodeCosts(PathNode *node);
 
+		/// <summary>
+		/// Helper function for tracing the lines of all edges going out from a specific node and setting their costs to those alone. Only writes to the node's own costs, so it's safe to do for many nodes at the same time.
+		/// </summary>
+		/// <param name="node">The node to trace all edge lines of.</param>
+		void CalculateNodeLineCosts(const PathNode *node);
+
+		/// <summary>
+		/// Helper function for raising the costs of the edges going up and left from a specific node to the costs of the opposing edges of the adjacent nodes, if those are higher.
+		/// </summary>
+		/// <param name="node">The node to combine the costs of.</param>
+		void CombineOpposingCosts(const PathNode *node);
+
 		/// <summary>
 		/// Helper function for updating all the values of cost edges crossed by a specific box.
 		/// This does NOT update the pather, which is required before solving more paths after calling this. Also it does NOT wrap the box coming in here, only truncates it!
 		/// </summary>
 		/// <param name="box">The Box of which all edges it touches should be recalculated.</param>
 		void UpdateNodeCostsInBox(Box &box);
+
+		/// <summary>
+		/// Helper function for getting the range of node indices whose edges may be crossed by a box, truncated to the node grid.
+		/// </summary>
+		/// <param name="box">The unflipped Box to get the node range of.</param>
+		/// <param name="firstX">Set to the first node column in the range.</param>
+		/// <param name="lastX">Set to the last node column in the range.</param>
+		/// <param name="firstY">Set to the first node row in the range.</param>
+		/// <param name="lastY">Set to the last node row in the range.</param>
+		void GetNodeRangeInBox(const Box &box, int &firstX, int &lastX, int &firstY, int &lastY) const;
+#pragma endregion
+
+#pragma region Path Solving
+		/// <summary>
+		/// Solves the path between two points with a specific pather, and fills out the result the way CalculatePath describes.
+		/// </summary>
+		/// <param name="pather">The pather to solve with, whose Graph is expected to be set up to give out the wanted costs.</param>
+		/// <param name="start">Start position on the scene to find the path from.</param>
+		/// <param name="end">End position on the scene to find the path to.</param>
+		/// <param name="pathResult">A list which will be filled out with waypoints between the start and end.</param>
+		/// <param name="totalCostResult">The total minimum difficulty cost calculated between the two points on the scene.</param>
+		/// <returns>Success or failure, expressed as SOLVED, NO_SOLUTION, or START_END_SAME.</returns>
+		int SolvePath(MicroPather *pather, Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult) const;
+
+		/// <summary>
+		/// Gets the node a position on the scene is in.
+		/// </summary>
+		/// <param name="pos">The position, which must be within the scene bounds.</param>
+		/// <returns>The node the position is in. Ownership is NOT transferred!</returns>
+		PathNode * GetNodeAtPos(const Vector &pos) const { return GetNode(static_cast<int>(std::floorf(pos.m_X / static_cast<float>(m_NodeDimension))), static_cast<int>(std::floorf(pos.m_Y / static_cast<float>(m_NodeDimension)))); }
+
+		/// <summary>
+		/// Gets the node at a specific column and row of the grid.
+		/// </summary>
+		/// <param name="nodeX">The column of the node.</param>
+		/// <param name="nodeY">The row of the node.</param>
+		/// <returns>The node. Ownership is NOT transferred!</returns>
+		PathNode * GetNode(int nodeX, int nodeY) const { return const_cast<PathNode *>(&m_NodeGrid[nodeX * m_NodeYCount + nodeY]); }
+
+		/// <summary>
+		/// Gathers the costs of all edges going out from a node.
+		/// </summary>
+		/// <param name="node">The node to get the costs of.</param>
+		/// <returns>The costs of the node, in the same order as the PathNode adjacent node members, starting at Up.</returns>
+		std::array<float, c_NodeEdgeCount> GetNodeCosts(const PathNode *node) const {
+			return { m_NodeCosts[0][node->Index], m_NodeCosts[1][node->Index], m_NodeCosts[2][node->Index], m_NodeCosts[3][node->Index], m_NodeCosts[4][node->Index], m_NodeCosts[5][node->Index], m_NodeCosts[6][node->Index], m_NodeCosts[7][node->Index] };
+		}
+
+		/// <summary>
+		/// Fills out a list of waypoints from the nodes along a path, with the first and last waypoints replaced by the exact start and end positions.
+		/// </summary>
+		/// <param name="statePath">The nodes along the path, including the ones the start and end positions are in. If empty, the list will only hold the start and end positions.</param>
+		/// <param name="start">The exact start position of the path.</param>
+		/// <param name="end">The exact end position of the path.</param>
+		/// <param name="pathResult">The list to fill out with the waypoints. Is cleared first.</param>
+		static void FillPathResult(const std::vector<void *> &statePath, const Vector &start, const Vector &end, std::list<Vector> &pathResult);
+
+		/// <summary>
+		/// Gets the cost of going along an edge given the material strength along it. Going up costs more than going down or sideways, and digging costs more still.
+		/// </summary>
+		/// <param name="edge">The index of the edge, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		/// <param name="strength">The material strength along the edge.</param>
+		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <returns>The cost of going along the edge.</returns>
+		static float GetAdjacentCost(int edge, float strength, float digStrength);
+
+		/// <summary>
+		/// Adds the costs of going from a node to each of its adjacent nodes to a list, given the material strengths along each of its edges.
+		/// </summary>
+		/// <param name="node">The node to add the adjacent costs of.</param>
+		/// <param name="nodeCosts">The material strengths along each edge of the node, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <param name="adjacentList">The list to add the adjacent nodes and their costs to.</param>
+		static void AddAdjacentCosts(const PathNode *node, const std::array<float, c_NodeEdgeCount> &nodeCosts, float digStrength, std::vector<micropather::StateCost> *adjacentList);
+
+		/// <summary>
+		/// Takes a new snapshot of all costs if any have changed since the last one.
+		/// </summary>
+		void UpdateCostSnapshot();
+
+		/// <summary>
+		/// Solves a path request with an idle PathSolver, or a new one if there are none, and marks it complete. Safe to call from worker threads.
+		/// </summary>
+		/// <param name="pathRequest">The request to solve.</param>
+		/// <param name="costSnapshot">The costs to solve the path with.</param>
+		/// <param name="clusterLayer">The cluster layer to search over first, or nullptr to search the node grid directly.</param>
+		void SolvePathRequest(const std::shared_ptr<PathRequest> &pathRequest, const std::shared_ptr<const PathCostSnapshot> &costSnapshot, const std::shared_ptr<const PathClusterLayer> &clusterLayer);
+#pragma endregion
+
+#pragma region Cluster Layers
+		/// <summary>
+		/// Gets the index of the cluster a node is in.
+		/// </summary>
+		/// <param name="node">The node to get the cluster of.</param>
+		/// <returns>The index of the cluster, counting down each cluster column in turn.</returns>
+		int GetNodeCluster(const PathNode *node) const { return (static_cast<int>(node->Index) / m_NodeYCount / c_ClusterNodeSize) * m_ClusterYCount + (static_cast<int>(node->Index) % m_NodeYCount) / c_ClusterNodeSize; }
+
+		/// <summary>
+		/// Marks the cluster a node is in as changed, so cluster layers made after this recalculate it.
+		/// </summary>
+		/// <param name="node">The node whose costs have changed.</param>
+		void MarkNodeClusterChanged(const PathNode *node) { m_ClusterChangeStamps[GetNodeCluster(node)] = m_ClusterChangeStamp; }
+
+		/// <summary>
+		/// Gets whether the clusters of two positions are far enough apart for a path between them to be worth searching for over a cluster layer first.
+		/// </summary>
+		/// <param name="start">The position the path starts at.</param>
+		/// <param name="end">The position the path ends at.</param>
+		/// <returns>Whether the positions are neither in the same nor in adjacent clusters.</returns>
+		bool IsLongDistancePath(Vector start, Vector end) const;
+
+		/// <summary>
+		/// Gets the cluster layer for a team and dig strength that is up to date with the latest cost snapshot, making or updating it if needed.
+		/// Teams without any door cost overlay share the layers of NOTEAM.
+		/// </summary>
+		/// <param name="team">The team to get the layer for.</param>
+		/// <param name="digStrength">The dig strength to get the layer for.</param>
+		/// <returns>The cluster layer.</returns>
+		std::shared_ptr<const PathClusterLayer> GetClusterLayer(int team, float digStrength);
+#pragma endregion
+
+#pragma region Door Cost Overlays
+		/// <summary>
+		/// Gets the pathing object that should be used for a team, creating it if needed. Teams without any door cost overlay share the main pather.
+		/// </summary>
+		/// <param name="team">The team to get the pather of.</param>
+		/// <returns>The pather to use for the team.</returns>
+		MicroPather * GetTeamPather(int team);
+
+		/// <summary>
+		/// Resets the main pather and all team pathers, which is required whenever any costs have changed.
+		/// </summary>
+		void ResetPathers();
+
+		/// <summary>
+		/// Checks whether any team's doors have changed since its door cost overlay was calculated, and recalculates the overlays of the teams that have.
+		/// </summary>
+		/// <param name="allCostsChanged">Whether the costs of all nodes have changed. Otherwise only the nodes flagged as changed are, which outdate the overlays of any doors they're near.</param>
+		void UpdateTeamDoorCostOverlays(bool allCostsChanged);
+
+		/// <summary>
+		/// Checks whether any node whose costs depend on the terrain in an area has been flagged as changed.
+		/// </summary>
+		/// <param name="area">The area to check the nodes around.</param>
+		/// <returns>Whether any of the nodes around the area have changed.</returns>
+		bool AnyNodeChangedNearArea(const Box &area) const;
+
+		/// <summary>
+		/// Recalculates the door cost overlay of a team from its current door footprints.
+		/// </summary>
+		/// <param name="team">The team to recalculate the door cost overlay of.</param>
+		void RecalculateTeamDoorCostOverlay(int team);
+
+		/// <summary>
+		/// Helper function for calculating the costs of all edges going out from a node the same way UpdateNodeCosts does, but ignoring pixels of specific materials within specific areas.
+		/// </summary>
+		/// <param name="node">The node to calculate all costs of.</param>
+		/// <param name="ignoredMaterialAreas">The areas within which pixels of the paired material ID are ignored.</param>
+		/// <param name="nodeCosts">Filled out with the costs, in the same order as the PathNode adjacent node members, starting at Up.</param>
+		void CalculateNodeCostsIgnoring(const PathNode *node, const std::vector<std::pair<Box, unsigned char>> &ignoredMaterialAreas, std::array<float, c_NodeEdgeCount> &nodeCosts);
 #pragma endregion
 
 		/// <summary>
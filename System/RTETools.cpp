@@ -7,6 +7,10 @@ namespace RTE {
 
 	void SeedRand() { srand(time(0)); }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SeedRand(unsigned int seed) { srand(seed); }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	double PosRand() { return (rand() / (RAND_MAX / 1000 + 1)) / 1000.0; }
@@ -16,6 +16,12 @@ namespace RTE {
 	/// </summary>
 	void SeedRand();
 
+	/// <summary>
+	/// Seeds the rand with a fixed seed, so the same sequence of random numbers comes out every time.
+	/// </summary>
+	/// <param name="seed">The seed to use.</param>
+	void SeedRand(unsigned int seed);
+
 	/// <summary>
 	/// A good rand function that return a float between 0.0 and 0.999.
 	/// </summary>
@@ -0,0 +1,96 @@
+#ifndef _RTESPSCQUEUE_
+#define _RTESPSCQUEUE_
+
+#include <atomic>
+#include <vector>
+
+namespace RTE {
+
+	/// <summary>
+	/// A fixed capacity ring buffer for handing items from exactly one producer thread to exactly one consumer thread without locking.
+	/// Neither side ever waits on the other. Pushing into a full queue fails instead, and it's up to the producer to deal with that.
+	/// </summary>
+	template <typename Type>
+	class SPSCQueue {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a SPSCQueue object in system memory. Create() should be called before using the object.
+		/// </summary>
+		SPSCQueue() : m_IndexMask(0), m_Head(0), m_Tail(0) {}
+
+		/// <summary>
+		/// Makes the SPSCQueue object ready for use. Removes any items in it, so it must not be called while either thread is using the queue.
+		/// </summary>
+		/// <param name="capacity">The number of items the queue can hold. Rounded up to the next power of two.</param>
+		void Create(size_t capacity) {
+			size_t roundedCapacity = 1;
+			while (roundedCapacity < capacity) { roundedCapacity <<= 1; }
+			m_Items.assign(roundedCapacity, Type());
+			m_IndexMask = roundedCapacity - 1;
+			m_Head.store(0);
+			m_Tail.store(0);
+		}
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets whether the queue has no items in it. Only exact when called from either of the two threads, and even then the other thread may change it right after.
+		/// </summary>
+		/// <returns>Whether the queue is empty.</returns>
+		bool IsEmpty() const { return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire); }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Adds an item to the back of the queue. May only be called from the producer thread.
+		/// </summary>
+		/// <param name="item">The item to add.</param>
+		/// <returns>Whether the item was added. False if the queue is full.</returns>
+		bool Push(const Type &item) {
+			size_t tail = m_Tail.load(std::memory_order_relaxed);
+			if (tail - m_Head.load(std::memory_order_acquire) >= m_Items.size()) {
+				return false;
+			}
+			m_Items[tail & m_IndexMask] = item;
+			// Releasing the new tail makes the item written above visible to the consumer before it can see there is an item.
+			m_Tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// Takes the item at the front of the queue. May only be called from the consumer thread.
+		/// </summary>
+		/// <param name="item">Set to the taken item, if there was one.</param>
+		/// <returns>Whether an item was taken. False if the queue is empty.</returns>
+		bool Pop(Type &item) {
+			size_t head = m_Head.load(std::memory_order_relaxed);
+			if (head == m_Tail.load(std::memory_order_acquire)) {
+				return false;
+			}
+			item = m_Items[head & m_IndexMask];
+			// Releasing the new head lets the producer reuse the slot only after the item has been read out of it.
+			m_Head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+#pragma endregion
+
+	protected:
+
+		std::vector<Type> m_Items; //!< The ring of item slots. Its size is always a power of two.
+		size_t m_IndexMask; //!< Masks the ever increasing head and tail counts down to slot indices.
+
+		std::atomic<size_t> m_Head; //!< The number of items taken so far. Only written by the consumer thread.
+		char m_HeadPadding[64]; //!< Keeps the head and tail on separate cache lines, so the two threads don't keep taking the line from each other.
+		std::atomic<size_t> m_Tail; //!< The number of items added so far. Only written by the producer thread.
+
+	private:
+
+		// Disallow the use of some implicit methods.
+		SPSCQueue(const SPSCQueue &reference) {}
+		SPSCQueue & operator=(const SPSCQueue &rhs) {}
+	};
+}
+#endif
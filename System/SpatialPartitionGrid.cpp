@@ -0,0 +1,203 @@
+#include "SpatialPartitionGrid.h"
+#include "MovableObject.h"
+#include "SceneMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpatialPartitionGrid::Clear() {
+		m_Width = 0;
+		m_Height = 0;
+		m_WrapsX = false;
+		m_WrapsY = false;
+		m_CellWidth = 1;
+		m_CellHeight = 1;
+		m_CellCountX = 0;
+		m_CellCountY = 0;
+		m_Cells.clear();
+		m_OccupiedCells.clear();
+		m_CellVisitStamps.clear();
+		m_CurrentVisitStamp = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SpatialPartitionGrid::Create(int width, int height, bool wrapsX, bool wrapsY, int cellSize) {
+		if (width <= 0 || height <= 0 || cellSize <= 0) {
+			return -1;
+		}
+		Clear();
+		m_Width = width;
+		m_Height = height;
+		m_WrapsX = wrapsX;
+		m_WrapsY = wrapsY;
+		m_CellCountX = (width + cellSize - 1) / cellSize;
+		m_CellCountY = (height + cellSize - 1) / cellSize;
+		// Spread the area evenly over the cells instead of leaving the last ones narrower, otherwise wrapping a cell index wouldn't land on the same pixels as wrapping a position does
+		m_CellWidth = static_cast<double>(width) / static_cast<double>(m_CellCountX);
+		m_CellHeight = static_cast<double>(height) / static_cast<double>(m_CellCountY);
+		m_Cells.resize(m_CellCountX * m_CellCountY);
+		m_CellVisitStamps.resize(m_CellCountX * m_CellCountY, 0);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpatialPartitionGrid::Reset() {
+		for (int cellIndex : m_OccupiedCells) {
+			m_Cells[cellIndex].clear();
+		}
+		m_OccupiedCells.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SpatialPartitionGrid::WrapCellX(int cellX) const {
+		if (cellX >= 0 && cellX < m_CellCountX) {
+			return cellX;
+		}
+		return m_WrapsX ? ((cellX % m_CellCountX) + m_CellCountX) % m_CellCountX : -1;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SpatialPartitionGrid::WrapCellY(int cellY) const {
+		if (cellY >= 0 && cellY < m_CellCountY) {
+			return cellY;
+		}
+		return m_WrapsY ? ((cellY % m_CellCountY) + m_CellCountY) % m_CellCountY : -1;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpatialPartitionGrid::StartNewSearch() const {
+		m_CurrentVisitStamp++;
+		// Once in a blue moon the stamp wraps around, at which point old stamps could be mistaken for the current search.
+		if (m_CurrentVisitStamp == 0) {
+			std::fill(m_CellVisitStamps.begin(), m_CellVisitStamps.end(), 0);
+			m_CurrentVisitStamp = 1;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpatialPartitionGrid::Add(MovableObject *objectToAdd) {
+		if (!objectToAdd || m_Cells.empty()) {
+			return;
+		}
+		// Positions outside a non-wrapping Scene are clamped into the edge cells. Clamping never makes two positions further apart, so the ring search distance bounds still hold.
+		int cellX = GetCellX(objectToAdd->GetPos().m_X);
+		int cellY = GetCellY(objectToAdd->GetPos().m_Y);
+		cellX = m_WrapsX ? WrapCellX(cellX) : static_cast<int>(Limit(cellX, m_CellCountX - 1, 0));
+		cellY = m_WrapsY ? WrapCellY(cellY) : static_cast<int>(Limit(cellY, m_CellCountY - 1, 0));
+
+		int cellIndex = cellY * m_CellCountX + cellX;
+		if (m_Cells[cellIndex].empty()) { m_OccupiedCells.push_back(cellIndex); }
+		m_Cells[cellIndex].push_back(objectToAdd);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpatialPartitionGrid::GetObjectsInRadius(const Vector &center, float radius, std::vector<MovableObject *> &objectsInRadius) const {
+		if (m_Cells.empty() || m_OccupiedCells.empty() || radius < 0) {
+			return;
+		}
+		int firstCellX = GetCellX(center.m_X - radius);
+		int lastCellX = GetCellX(center.m_X + radius);
+		int firstCellY = GetCellY(center.m_Y - radius);
+		int lastCellY = GetCellY(center.m_Y + radius);
+
+		// Ranges that cover the whole grid are limited to it so wrapping doesn't visit any cell twice. Non-wrapping ranges are limited to the grid, where the edge cells also hold everything beyond them.
+		// Other wrapping ranges are left as they are and each cell is wrapped when looked at.
+		if (!m_WrapsX || lastCellX - firstCellX + 1 >= m_CellCountX) {
+			firstCellX = m_WrapsX ? 0 : static_cast<int>(Limit(firstCellX, m_CellCountX - 1, 0));
+			lastCellX = m_WrapsX ? m_CellCountX - 1 : static_cast<int>(Limit(lastCellX, m_CellCountX - 1, 0));
+		}
+		if (!m_WrapsY || lastCellY - firstCellY + 1 >= m_CellCountY) {
+			firstCellY = m_WrapsY ? 0 : static_cast<int>(Limit(firstCellY, m_CellCountY - 1, 0));
+			lastCellY = m_WrapsY ? m_CellCountY - 1 : static_cast<int>(Limit(lastCellY, m_CellCountY - 1, 0));
+		}
+
+		for (int cellY = firstCellY; cellY <= lastCellY; ++cellY) {
+			int wrappedCellY = WrapCellY(cellY);
+			for (int cellX = firstCellX; cellX <= lastCellX; ++cellX) {
+				for (MovableObject *objectInCell : m_Cells[wrappedCellY * m_CellCountX + WrapCellX(cellX)]) {
+					if (g_SceneMan.ShortestDistance(objectInCell->GetPos(), center).GetMagnitude() <= radius) { objectsInRadius.push_back(objectInCell); }
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	MovableObject * SpatialPartitionGrid::GetClosestObject(const Vector &center, float maxDistance, const std::function<bool(const MovableObject *)> &filter, Vector &closestDistance) const {
+		if (m_Cells.empty() || m_OccupiedCells.empty()) {
+			return nullptr;
+		}
+		StartNewSearch();
+
+		int centerCellX = GetCellX(center.m_X);
+		int centerCellY = GetCellY(center.m_Y);
+		centerCellX = m_WrapsX ? WrapCellX(centerCellX) : static_cast<int>(Limit(centerCellX, m_CellCountX - 1, 0));
+		centerCellY = m_WrapsY ? WrapCellY(centerCellY) : static_cast<int>(Limit(centerCellY, m_CellCountY - 1, 0));
+
+		// Past this ring every cell of the grid has been looked at.
+		int lastRingX = m_WrapsX ? m_CellCountX / 2 : std::max(centerCellX, m_CellCountX - 1 - centerCellX);
+		int lastRingY = m_WrapsY ? m_CellCountY / 2 : std::max(centerCellY, m_CellCountY - 1 - centerCellY);
+		int lastRing = std::max(lastRingX, lastRingY);
+
+		// Every cell the same size means anything a ring away in either direction is at least this many cells' worth of the smaller cell side away
+		double ringDistance = std::min(m_CellWidth, m_CellHeight);
+
+		MovableObject *closestObject = nullptr;
+		float shortestDistance = maxDistance;
+
+		/// <summary>
+		/// Internal lambda function to check all objects in a cell against the closest found so far, if the cell is in the grid and hasn't been looked at yet.
+		/// </summary>
+		auto checkCell = [&](int cellX, int cellY) {
+			cellX = WrapCellX(cellX);
+			cellY = WrapCellY(cellY);
+			if (cellX < 0 || cellY < 0) {
+				return;
+			}
+			int cellIndex = cellY * m_CellCountX + cellX;
+			if (m_CellVisitStamps[cellIndex] == m_CurrentVisitStamp) {
+				return;
+			}
+			m_CellVisitStamps[cellIndex] = m_CurrentVisitStamp;
+
+			for (MovableObject *objectInCell : m_Cells[cellIndex]) {
+				if (!filter(objectInCell)) {
+					continue;
+				}
+				Vector distanceVec = g_SceneMan.ShortestDistance(objectInCell->GetPos(), center);
+				float distance = distanceVec.GetMagnitude();
+				if (distance < shortestDistance) {
+					shortestDistance = distance;
+					closestObject = objectInCell;
+					closestDistance = distanceVec;
+				}
+			}
+		};
+
+		for (int ring = 0; ring <= lastRing; ++ring) {
+			// Anything in this ring or further out is at least this far away, so if that's not closer than what we have there's no point going on.
+			if (ring > 0 && static_cast<double>(ring - 1) * ringDistance >= static_cast<double>(shortestDistance)) {
+				break;
+			}
+			for (int offsetY = -ring; offsetY <= ring; ++offsetY) {
+				if (offsetY == -ring || offsetY == ring) {
+					for (int offsetX = -ring; offsetX <= ring; ++offsetX) {
+						checkCell(centerCellX + offsetX, centerCellY + offsetY);
+					}
+				} else {
+					checkCell(centerCellX - ring, centerCellY + offsetY);
+					checkCell(centerCellX + ring, centerCellY + offsetY);
+				}
+			}
+		}
+		return closestObject;
+	}
+}
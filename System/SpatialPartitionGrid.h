@@ -0,0 +1,140 @@
+#ifndef _RTESPATIALPARTITIONGRID_
+#define _RTESPATIALPARTITIONGRID_
+
+#include "Vector.h"
+
+namespace RTE {
+
+	class MovableObject;
+
+	/// <summary>
+	/// A uniform grid of buckets over the Scene that MovableObjects are sorted into by position, so proximity queries only need to look at the buckets near the point of interest.
+	/// Is aware of Scene wrapping, so objects across a wrapping seam are found as well.
+	/// </summary>
+	class SpatialPartitionGrid {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a SpatialPartitionGrid object in system memory. Create() should be called before using the object.
+		/// </summary>
+		SpatialPartitionGrid() { Clear(); }
+
+		/// <summary>
+		/// Makes the SpatialPartitionGrid object ready for use, covering an area of the specified size. Removes any objects in it.
+		/// </summary>
+		/// <param name="width">The width of the covered area, in pixels.</param>
+		/// <param name="height">The height of the covered area, in pixels.</param>
+		/// <param name="wrapsX">Whether the covered area wraps horizontally.</param>
+		/// <param name="wrapsY">Whether the covered area wraps vertically.</param>
+		/// <param name="cellSize">The largest width and height of each grid cell, in pixels. Cells are made a bit smaller where needed so they divide the covered area evenly.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int Create(int width, int height, bool wrapsX, bool wrapsY, int cellSize);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Removes all objects from the grid, keeping its dimensions.
+		/// </summary>
+		void Reset();
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets whether this grid was made for an area with the specified properties, so it can be reused instead of created anew.
+		/// </summary>
+		/// <param name="width">The width of the area, in pixels.</param>
+		/// <param name="height">The height of the area, in pixels.</param>
+		/// <param name="wrapsX">Whether the area wraps horizontally.</param>
+		/// <param name="wrapsY">Whether the area wraps vertically.</param>
+		/// <returns>Whether this grid covers an area like that.</returns>
+		bool Covers(int width, int height, bool wrapsX, bool wrapsY) const { return m_Width == width && m_Height == height && m_WrapsX == wrapsX && m_WrapsY == wrapsY; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Adds a MovableObject to the grid cell its current position falls in. The grid does not follow the object afterwards, so it has to be reset and filled again once objects have moved.
+		/// </summary>
+		/// <param name="objectToAdd">The MovableObject to add. Ownership is NOT transferred!</param>
+		void Add(MovableObject *objectToAdd);
+
+		/// <summary>
+		/// Gets all MovableObjects in the grid that are within a radius of a point, using the shortest wrapped distance.
+		/// </summary>
+		/// <param name="center">The center of the search.</param>
+		/// <param name="radius">The radius of the search, in pixels.</param>
+		/// <param name="objectsInRadius">The vector to add all found objects to. Ownership is NOT transferred!</param>
+		void GetObjectsInRadius(const Vector &center, float radius, std::vector<MovableObject *> &objectsInRadius) const;
+
+		/// <summary>
+		/// Gets the MovableObject in the grid that is closest to a point, using the shortest wrapped distance. Only objects that pass the filter and are closer than maxDistance are considered.
+		/// Cells are searched in growing rings around the point, and the search stops as soon as no remaining ring can hold anything closer than the best found so far.
+		/// </summary>
+		/// <param name="center">The point to find the closest object to.</param>
+		/// <param name="maxDistance">Only objects strictly closer than this are considered.</param>
+		/// <param name="filter">Returns whether an object should be considered.</param>
+		/// <param name="closestDistance">Set to the shortest distance vector from the point to the found object, if one was found.</param>
+		/// <returns>The closest object, or nullptr if there was none. Ownership is NOT transferred!</returns>
+		MovableObject * GetClosestObject(const Vector &center, float maxDistance, const std::function<bool(const MovableObject *)> &filter, Vector &closestDistance) const;
+#pragma endregion
+
+	protected:
+
+		int m_Width; //!< The width of the covered area, in pixels.
+		int m_Height; //!< The height of the covered area, in pixels.
+		bool m_WrapsX; //!< Whether the covered area wraps horizontally.
+		bool m_WrapsY; //!< Whether the covered area wraps vertically.
+		double m_CellWidth; //!< The width of each grid cell, in pixels. Every cell is the same width, so the columns line up the same way across a wrapping seam as the pixels do.
+		double m_CellHeight; //!< The height of each grid cell, in pixels. Every cell is the same height, so the rows line up the same way across a wrapping seam as the pixels do.
+		int m_CellCountX; //!< The number of grid cells horizontally.
+		int m_CellCountY; //!< The number of grid cells vertically.
+
+		std::vector<std::vector<MovableObject *>> m_Cells; //!< The objects in each grid cell, row by row.
+		std::vector<int> m_OccupiedCells; //!< The indices of the cells that have any objects in them, so Reset doesn't need to go through all of them.
+
+		mutable std::vector<unsigned int> m_CellVisitStamps; //!< The search each cell was last looked at in, so cells reached twice through wrapping are only looked at once per search.
+		mutable unsigned int m_CurrentVisitStamp; //!< The stamp of the current search.
+
+	private:
+
+		/// <summary>
+		/// Gets the unwrapped cell column a horizontal position falls in.
+		/// </summary>
+		/// <param name="posX">The horizontal position, in pixels. Doesn't have to be wrapped.</param>
+		/// <returns>The unwrapped cell column.</returns>
+		int GetCellX(float posX) const { return static_cast<int>(std::floor(static_cast<double>(posX) / m_CellWidth)); }
+
+		/// <summary>
+		/// Gets the unwrapped cell row a vertical position falls in.
+		/// </summary>
+		/// <param name="posY">The vertical position, in pixels. Doesn't have to be wrapped.</param>
+		/// <returns>The unwrapped cell row.</returns>
+		int GetCellY(float posY) const { return static_cast<int>(std::floor(static_cast<double>(posY) / m_CellHeight)); }
+
+		/// <summary>
+		/// Wraps an unwrapped cell column into the grid, if the grid wraps horizontally.
+		/// </summary>
+		/// <param name="cellX">The unwrapped cell column.</param>
+		/// <returns>The cell column, or -1 if it's outside a non-wrapping grid.</returns>
+		int WrapCellX(int cellX) const;
+
+		/// <summary>
+		/// Wraps an unwrapped cell row into the grid, if the grid wraps vertically.
+		/// </summary>
+		/// <param name="cellY">The unwrapped cell row.</param>
+		/// <returns>The cell row, or -1 if it's outside a non-wrapping grid.</returns>
+		int WrapCellY(int cellY) const;
+
+		/// <summary>
+		/// Starts a new search, so all cells count as not yet looked at.
+		/// </summary>
+		void StartNewSearch() const;
+
+		/// <summary>
+		/// Clears all the member variables of this SpatialPartitionGrid, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
@@ -11,6 +11,7 @@
 #include <cctype>
 #include <string>
 #include <cstring>
+#include <array>
 #include <vector>
 #include <list>
 #include <set>